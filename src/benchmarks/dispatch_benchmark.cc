@@ -0,0 +1,194 @@
+#include "allocation_counter.h"
+#include "command_factory.h"
+#include "transaction.h"
+#include "unordered_map.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*
+ * What getting from a parsed command to the engine costs. Commands used
+ * to be heap objects called through a virtual ICommand::Execute; now they
+ * are alternatives of a std::variant that ttl::Command visits statically.
+ * Both cases build the same EXISTS in an out-of-line factory, as
+ * CommandFactory does, and run it on the same storage with the replies
+ * discarded, so the difference is the allocation and the indirect call;
+ * allocs_per_op shows the one the variant saves.
+ *
+ * The Lines and Transaction cases run the same parsed SET/GET/DEL lines
+ * one by one, or as the queue of a MULTI run by EXEC, and time only that.
+ * Replies go to /dev/null through a file buffer, so every flush is a
+ * write(2) as on a console.
+ */
+
+namespace {
+    using storage_type = ttl::unordered_map<std::string, ttl::Student>;
+    using exists_command = ttl::ExistsCommand<storage_type>;
+
+    constexpr std::size_t kKeys = 1024;
+
+    // the former dispatch: an interface, and a heap object per command
+    class IVirtualCommand {
+    public:
+        virtual ~IVirtualCommand() = default;
+        virtual void Execute(storage_type &storage) = 0;
+    };
+
+    template <typename Alternative>
+    class VirtualCommand final : public IVirtualCommand {
+    public:
+        explicit VirtualCommand(Alternative &&command) : command_(std::move(command)) {}
+
+        void Execute(storage_type &storage) override { command_.Execute(storage); }
+
+    private:
+        Alternative command_;
+    };
+
+    [[gnu::noinline]] std::unique_ptr<IVirtualCommand> makeVirtual(std::string key) {
+        return std::make_unique<VirtualCommand<exists_command>>(exists_command(std::move(key)));
+    }
+
+    [[gnu::noinline]] std::optional<ttl::Command<storage_type>> makeVariant(std::string key) {
+        return ttl::Command<storage_type>(exists_command(std::move(key)));
+    }
+
+    class discard_buffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+    };
+
+    // every other key is stored, so EXISTS replies both ways
+    struct DispatchData {
+        storage_type storage;
+        std::vector<std::string> keys;
+    };
+
+    DispatchData &getData() {
+        static DispatchData data = [] {
+            DispatchData built;
+            for (std::size_t i = 0; i != kKeys; ++i) {
+                built.keys.push_back("key:" + std::to_string(i));
+                if (i % 2 == 0)
+                    built.storage[built.keys.back()] = ttl::Student{};
+            }
+            return built;
+        }();
+        return data;
+    }
+
+    // SET, GET and DEL of every key, so each batch leaves the storage as it found it
+    const std::vector<std::string> &getBatch() {
+        static const std::vector<std::string> lines = [] {
+            std::vector<std::string> built;
+            for (int i = 0; i != 8; ++i) {
+                const std::string key = "batch:" + std::to_string(i);
+                built.push_back("SET " + key + " Ivanov Ivan 2000 Moscow 55");
+                built.push_back("GET " + key);
+                built.push_back("DEL " + key);
+            }
+            return built;
+        }();
+        return lines;
+    }
+
+    void BM_DispatchVirtual(benchmark::State &state) {
+        DispatchData &data = getData();
+        discard_buffer discard;
+        std::streambuf *console = std::cout.rdbuf(&discard);
+
+        const ttl::allocation_scope allocations;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            auto command = makeVirtual(data.keys[i++ % kKeys]);
+            command->Execute(data.storage);
+        }
+
+        std::cout.rdbuf(console);
+        state.SetItemsProcessed(state.iterations());
+        state.counters["allocs_per_op"] = static_cast<double>(allocations.allocations()) /
+                                          static_cast<double>(state.iterations());
+    }
+
+    void BM_DispatchVariant(benchmark::State &state) {
+        DispatchData &data = getData();
+        discard_buffer discard;
+        std::streambuf *console = std::cout.rdbuf(&discard);
+
+        const ttl::allocation_scope allocations;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            auto command = makeVariant(data.keys[i++ % kKeys]);
+            command->Run(data.storage);
+        }
+
+        std::cout.rdbuf(console);
+        state.SetItemsProcessed(state.iterations());
+        state.counters["allocs_per_op"] = static_cast<double>(allocations.allocations()) /
+                                          static_cast<double>(state.iterations());
+    }
+
+    // the lines parsed, then run one by one; only the running is timed
+    void BM_Lines(benchmark::State &state) {
+        DispatchData &data = getData();
+        ttl::CommandContext<storage_type> context;
+        std::filebuf null;
+        null.open("/dev/null", std::ios::out);
+        std::streambuf *console = std::cout.rdbuf(&null);
+
+        const auto &lines = getBatch();
+        std::vector<ttl::Command<storage_type>> commands;
+        for (auto _ : state) {
+            commands.clear();
+            for (const auto &line : lines)
+                commands.push_back(*ttl::CommandFactory::getCommand(line, data.storage, &context));
+
+            auto begin = std::chrono::steady_clock::now();
+            for (auto &command : commands)
+                command.Run(data.storage);
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+        }
+
+        std::cout.rdbuf(console);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+    }
+
+    // the lines queued after MULTI, then run by EXEC; only EXEC is timed
+    void BM_Transaction(benchmark::State &state) {
+        DispatchData &data = getData();
+        ttl::CommandContext<storage_type> context;
+        ttl::Transaction<storage_type> transaction(context);
+        std::filebuf null;
+        null.open("/dev/null", std::ios::out);
+        std::streambuf *console = std::cout.rdbuf(&null);
+
+        const auto &lines = getBatch();
+        for (auto _ : state) {
+            transaction.Accept("MULTI", data.storage);
+            for (const auto &line : lines)
+                transaction.Accept(line, data.storage);
+
+            auto begin = std::chrono::steady_clock::now();
+            transaction.Accept("EXEC", data.storage);
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+        }
+
+        std::cout.rdbuf(console);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+    }
+}
+
+BENCHMARK(BM_DispatchVirtual);
+BENCHMARK(BM_DispatchVariant);
+BENCHMARK(BM_Lines)->UseManualTime();
+BENCHMARK(BM_Transaction)->UseManualTime();
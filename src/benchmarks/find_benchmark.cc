@@ -0,0 +1,104 @@
+#include "student.h"
+#include "student_columns.h"
+#include "student_predicate.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+    struct FindDataset {
+        std::vector<ttl::Student> rows;
+        ttl::student_columns<std::size_t> columns;
+    };
+
+    // Built once per size and shared by every FIND benchmark of that size.
+    const FindDataset &getDataset(std::size_t size) {
+        static std::map<std::size_t, FindDataset> datasets;
+
+        auto [it, inserted] = datasets.try_emplace(size);
+        if (!inserted)
+            return it->second;
+
+        static const std::array<const char *, 8> surnames = {"Ivanov", "Petrov", "Sidorov", "Smirnov",
+                                                             "Kuznetsov", "Popov", "Vasiliev", "Sokolov"};
+        static const std::array<const char *, 8> names = {"Ivan", "Petr", "Anna", "Olga",
+                                                          "Nikita", "Maria", "Artem", "Elena"};
+        static const std::array<const char *, 8> cities = {"Kazan", "Moscow", "Omsk", "Perm",
+                                                           "Tver", "Ufa", "Samara", "Sochi"};
+
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<std::size_t> word(0, 7);
+        std::uniform_int_distribution<int> year(1990, 2009);
+        std::uniform_int_distribution<int> coins(0, 999);
+
+        FindDataset &dataset = it->second;
+        dataset.rows.resize(size);
+        dataset.columns.reserve(size);
+        for (std::size_t i = 0; i != size; ++i) {
+            ttl::Student &student = dataset.rows[i];
+            student.surname = surnames[word(generator)];
+            student.name = names[word(generator)];
+            student.city = cities[word(generator)];
+            student.year = year(generator);
+            student.coins = coins(generator);
+            dataset.columns.assign(i, student);
+        }
+
+        return dataset;
+    }
+
+    // FIND - - 2002 Kazan -
+    ttl::Student getPattern() {
+        ttl::Student pattern;
+        pattern.surname = "-";
+        pattern.name = "-";
+        pattern.city = "Kazan";
+        pattern.year = 2002;
+        return pattern;
+    }
+}
+
+static void BM_FindOperatorEquals(benchmark::State &state) {
+    const auto &rows = getDataset(state.range(0)).rows;
+    const ttl::Student pattern = getPattern();
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (const auto &row : rows)
+            count += row == pattern;
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FindCompiledPredicate(benchmark::State &state) {
+    const auto &rows = getDataset(state.range(0)).rows;
+
+    for (auto _ : state) {
+        const ttl::student_predicate matches(getPattern());
+        std::size_t count = 0;
+        for (const auto &row : rows)
+            count += matches(row);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FindColumnarKernel(benchmark::State &state) {
+    const auto &columns = getDataset(state.range(0)).columns;
+    const ttl::Student pattern = getPattern();
+
+    for (auto _ : state) {
+        auto selection = columns.find(pattern);
+        benchmark::DoNotOptimize(columns.count(selection));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_FindOperatorEquals)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FindCompiledPredicate)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FindColumnarKernel)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
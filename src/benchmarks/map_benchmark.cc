@@ -0,0 +1,99 @@
+#include "map.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    ttl::map<std::string, int> getStorage(std::size_t size) {
+        ttl::map<std::string, int> storage;
+        for (std::size_t i = 0; i != size; ++i)
+            storage.insert({"user:" + std::to_string(i), static_cast<int>(i)});
+        return storage;
+    }
+
+    // narrow lexicographic slice: "user:4242", "user:42420".."user:42429", ..., "user:4243"
+    const std::string kFrom = "user:4242";
+    const std::string kTo = "user:4243";
+}
+
+static void BM_MapRangeBounds(benchmark::State &state) {
+    auto storage = getStorage(state.range(0));
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (auto it = storage.lower_bound(kFrom), last = storage.upper_bound(kTo); it != last; ++it)
+            ++count;
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void BM_MapRangeFullIteration(benchmark::State &state) {
+    auto storage = getStorage(state.range(0));
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (const auto &[key, value] : storage)
+            count += !(key < kFrom) and !(kTo < key);
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void BM_MapPrefixBounds(benchmark::State &state) {
+    auto storage = getStorage(state.range(0));
+    const std::string prefix = "user:4242";
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (auto it = storage.lower_bound(prefix), last = storage.end();
+             it != last and it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            ++count;
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(BM_MapRangeBounds)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MapRangeFullIteration)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MapPrefixBounds)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+namespace {
+    template <typename Map>
+    Map getShuffledStorage(std::size_t size) {
+        std::vector<int> keys(size);
+        for (std::size_t i = 0; i != size; ++i)
+            keys[i] = static_cast<int>(i);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+        Map storage;
+        for (int key : keys)
+            storage.insert({key, key});
+        return storage;
+    }
+
+    template <typename Map>
+    void iterateStorage(benchmark::State &state) {
+        auto storage = getShuffledStorage<Map>(state.range(0));
+
+        for (auto _ : state) {
+            long sum = 0;
+            for (const auto &[key, value] : storage)
+                sum += value;
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_MapIterateParentLinks(benchmark::State &state) {
+    iterateStorage<ttl::map<int, int>>(state);
+}
+
+static void BM_MapIterateThreaded(benchmark::State &state) {
+    iterateStorage<ttl::map<int, int, std::less<int>, ttl::map_options::kThreaded>>(state);
+}
+
+BENCHMARK(BM_MapIterateParentLinks)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapIterateThreaded)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Regression gate for `make perf`: compares two Google Benchmark JSON
+ * files, a baseline recorded on this machine and a fresh run, case by case.
+ *
+ *   Transactions_CPP_PERF_COMPARE baseline.json current.json [--threshold=10] [--alpha=0.05] [--control=std::]
+ *
+ * Every repetition of a case is one throughput sample (items_per_second).
+ * A case regresses when its median throughput drops by more than
+ * `threshold` percent and a two-sided Mann-Whitney U test says the two
+ * sample sets differ with p < alpha, so one noisy repetition can't fail
+ * the gate and neither can a real but negligible slowdown. A case missing
+ * from the current run fails too; a case missing from the baseline is
+ * reported as new. Exit status is 1 on any failure.
+ *
+ * With --control=std::, cases of engines whose name starts with std::
+ * are controls: code this repo doesn't change, timed in the same run.
+ * The median of their current/baseline ratios is taken as machine drift
+ * (frequency, noisy neighbours) and the tracked samples are divided by
+ * it before testing. Controls are reported but never fail the gate.
+ */
+
+namespace {
+    /*
+     * Just enough JSON for benchmark output: objects, arrays, strings,
+     * numbers, true/false/null. Throws std::runtime_error on malformed input.
+     */
+    struct json_value {
+        enum class type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+        type kind = type::kNull;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<json_value> array;
+        std::map<std::string, json_value> object;
+
+        [[nodiscard]] const json_value *get(const std::string &key) const {
+            auto it = object.find(key);
+            return it == object.end() ? nullptr : &it->second;
+        }
+    };
+
+    class json_parser {
+    public:
+        explicit json_parser(const std::string &text) : text_(text) {}
+
+        json_value parse() {
+            json_value value = parseValue();
+            skipSpaces();
+            if (position_ != text_.size())
+                fail("trailing characters");
+            return value;
+        }
+
+    private:
+        const std::string &text_;
+        std::size_t position_ = 0;
+
+        [[noreturn]] void fail(const std::string &what) const {
+            throw std::runtime_error("json: " + what + " at offset " + std::to_string(position_));
+        }
+
+        void skipSpaces() {
+            while (position_ != text_.size() and std::isspace(static_cast<unsigned char>(text_[position_])))
+                ++position_;
+        }
+
+        bool consume(char expected) {
+            skipSpaces();
+            if (position_ == text_.size() or text_[position_] != expected)
+                return false;
+            ++position_;
+            return true;
+        }
+
+        void expect(char expected) {
+            if (!consume(expected))
+                fail(std::string("expected '") + expected + "'");
+        }
+
+        bool consumeWord(const char *word) {
+            const std::size_t length = std::strlen(word);
+            if (text_.compare(position_, length, word) != 0)
+                return false;
+            position_ += length;
+            return true;
+        }
+
+        json_value parseValue() {
+            skipSpaces();
+            if (position_ == text_.size())
+                fail("unexpected end");
+
+            json_value value;
+            const char c = text_[position_];
+            if (c == '{') {
+                value.kind = json_value::type::kObject;
+                ++position_;
+                if (consume('}'))
+                    return value;
+                do {
+                    skipSpaces();
+                    std::string key = parseString();
+                    expect(':');
+                    value.object[std::move(key)] = parseValue();
+                } while (consume(','));
+                expect('}');
+            } else if (c == '[') {
+                value.kind = json_value::type::kArray;
+                ++position_;
+                if (consume(']'))
+                    return value;
+                do {
+                    value.array.push_back(parseValue());
+                } while (consume(','));
+                expect(']');
+            } else if (c == '"') {
+                value.kind = json_value::type::kString;
+                value.string = parseString();
+            } else if (consumeWord("true") or consumeWord("false")) {
+                value.kind = json_value::type::kBool;
+                value.boolean = c == 't';
+            } else if (consumeWord("null")) {
+                value.kind = json_value::type::kNull;
+            } else {
+                value.kind = json_value::type::kNumber;
+                value.number = parseNumber();
+            }
+            return value;
+        }
+
+        std::string parseString() {
+            if (position_ == text_.size() or text_[position_] != '"')
+                fail("expected string");
+            ++position_;
+
+            std::string result;
+            while (position_ != text_.size() and text_[position_] != '"') {
+                char c = text_[position_++];
+                if (c == '\\') {
+                    if (position_ == text_.size())
+                        fail("unterminated escape");
+                    c = text_[position_++];
+                    switch (c) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case 'b': c = '\b'; break;
+                        case 'f': c = '\f'; break;
+                        case 'u':
+                            // names and context fields are ASCII; keep the escape as is
+                            result += "\\u";
+                            continue;
+                        default: break;
+                    }
+                }
+                result += c;
+            }
+            if (position_ == text_.size())
+                fail("unterminated string");
+            ++position_;
+            return result;
+        }
+
+        // strtod also takes the NaN Google Benchmark writes for an undefined counter
+        double parseNumber() {
+            const char *begin = text_.c_str() + position_;
+            char *end = nullptr;
+            const double number = std::strtod(begin, &end);
+            if (end == begin)
+                fail("unexpected character");
+            position_ += static_cast<std::size_t>(end - begin);
+            return number;
+        }
+    };
+
+    struct run {
+        std::string host;
+        std::string libraryBuild;
+        bool cpuScaling = false;
+        // case name without the /iterations:N suffix -> items_per_second of each repetition
+        std::map<std::string, std::vector<double>> samples;
+    };
+
+    std::string caseName(std::string name) {
+        const auto suffix = name.find("/iterations:");
+        if (suffix != std::string::npos)
+            name.erase(suffix);
+        return name;
+    }
+
+    run load(const std::string &path) {
+        std::ifstream in(path);
+        if (!in)
+            throw std::runtime_error("can't open " + path);
+        std::stringstream text;
+        text << in.rdbuf();
+        const json_value root = json_parser(text.str()).parse();
+
+        run result;
+        if (const json_value *context = root.get("context")) {
+            if (const json_value *host = context->get("host_name"))
+                result.host = host->string;
+            if (const json_value *build = context->get("library_build_type"))
+                result.libraryBuild = build->string;
+            if (const json_value *scaling = context->get("cpu_scaling_enabled"))
+                result.cpuScaling = scaling->boolean;
+        }
+
+        const json_value *benchmarks = root.get("benchmarks");
+        if (benchmarks == nullptr or benchmarks->kind != json_value::type::kArray)
+            throw std::runtime_error(path + ": no benchmarks array");
+
+        for (const json_value &benchmark : benchmarks->array) {
+            const json_value *type = benchmark.get("run_type");
+            const json_value *name = benchmark.get("run_name");
+            const json_value *throughput = benchmark.get("items_per_second");
+            // aggregates (mean, median, ...) are recomputed here from the repetitions
+            if (type == nullptr or type->string != "iteration" or name == nullptr or throughput == nullptr)
+                continue;
+            result.samples[caseName(name->string)].push_back(throughput->number);
+        }
+        return result;
+    }
+
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        const std::size_t middle = values.size() / 2;
+        return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+
+    /*
+     * Two-sided p-value of the Mann-Whitney U test, normal approximation
+     * with tie and continuity corrections. Adequate from about 5 samples
+     * a side, which is what --benchmark_repetitions gives us.
+     */
+    double mannWhitneyP(const std::vector<double> &a, const std::vector<double> &b) {
+        const double n1 = static_cast<double>(a.size()), n2 = static_cast<double>(b.size());
+        if (a.empty() or b.empty())
+            return 1.0;
+
+        std::vector<std::pair<double, bool>> pooled;
+        for (double value : a)
+            pooled.emplace_back(value, true);
+        for (double value : b)
+            pooled.emplace_back(value, false);
+        std::sort(pooled.begin(), pooled.end());
+
+        // average ranks over ties, sum of t^3 - t for the variance correction
+        double rankSumA = 0.0, ties = 0.0;
+        for (std::size_t i = 0; i != pooled.size();) {
+            std::size_t j = i;
+            while (j != pooled.size() and pooled[j].first == pooled[i].first)
+                ++j;
+            const double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            for (std::size_t k = i; k != j; ++k)
+                if (pooled[k].second)
+                    rankSumA += rank;
+            const double t = static_cast<double>(j - i);
+            ties += t * t * t - t;
+            i = j;
+        }
+
+        const double n = n1 + n2;
+        const double u = rankSumA - n1 * (n1 + 1.0) / 2.0;
+        const double mean = n1 * n2 / 2.0;
+        const double variance = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+        if (variance <= 0.0)
+            return 1.0;
+
+        const double z = std::max(0.0, std::abs(u - mean) - 0.5) / std::sqrt(variance);
+        return std::erfc(z / std::sqrt(2.0));
+    }
+
+    // Find/std::map/uniform/size:65536 is a control case for --control=std::
+    bool isControl(const std::string &name, const std::string &control) {
+        const auto engine = name.find('/');
+        return !control.empty() and engine != std::string::npos and name.compare(engine + 1, control.size(), control) == 0;
+    }
+
+    // median current/baseline throughput ratio over the control cases, 1 if there are none
+    double machineDrift(const run &baseline, const run &current, const std::string &control) {
+        std::vector<double> ratios;
+        for (const auto &[name, before] : baseline.samples) {
+            auto it = current.samples.find(name);
+            if (isControl(name, control) and it != current.samples.end())
+                ratios.push_back(median(it->second) / median(before));
+        }
+        return ratios.empty() ? 1.0 : median(ratios);
+    }
+
+    bool parseDouble(const char *arg, const char *flag, double &value) {
+        const std::size_t length = std::strlen(flag);
+        if (std::strncmp(arg, flag, length) != 0)
+            return false;
+
+        char *end = nullptr;
+        value = std::strtod(arg + length, &end);
+        if (*end != '\0' or value < 0.0)
+            throw std::runtime_error(std::string(flag) + " takes a non-negative number");
+        return true;
+    }
+
+    constexpr double kDefaultThreshold = 10.0;
+    constexpr double kDefaultAlpha = 0.05;
+
+    int compare(int argc, char **argv) {
+        static constexpr const char kControlFlag[] = "--control=";
+
+        double threshold = kDefaultThreshold, alpha = kDefaultAlpha;
+        std::string control;
+        std::vector<std::string> paths;
+        for (int i = 1; i != argc; ++i) {
+            if (std::strncmp(argv[i], kControlFlag, sizeof(kControlFlag) - 1) == 0)
+                control = argv[i] + sizeof(kControlFlag) - 1;
+            else if (!parseDouble(argv[i], "--threshold=", threshold) and !parseDouble(argv[i], "--alpha=", alpha))
+                paths.emplace_back(argv[i]);
+        }
+        if (paths.size() != 2) {
+            std::cerr << "usage: " << argv[0]
+                      << " baseline.json current.json [--threshold=" << kDefaultThreshold << "] [--alpha="
+                      << kDefaultAlpha << "] [--control=std::]\n";
+            return 2;
+        }
+
+        const run baseline = load(paths[0]);
+        const run current = load(paths[1]);
+        if (baseline.host != current.host)
+            std::cerr << "warning: baseline was recorded on '" << baseline.host << "', this run on '" << current.host
+                      << "'; absolute numbers may not compare\n";
+        for (const auto &[which, recorded] : {std::pair{"baseline", &baseline}, std::pair{"this run", &current}})
+            if (recorded->libraryBuild == "debug")
+                std::cerr << "warning: " << which << " was timed by a debug build of Google Benchmark, "
+                          << "record both with a release build\n";
+        if (current.cpuScaling)
+            std::cerr << "warning: CPU frequency scaling is enabled, expect noisy results\n";
+
+        const double drift = machineDrift(baseline, current, control);
+        std::cout << std::fixed;
+        if (!control.empty())
+            std::cout << "machine drift from " << control << " controls: " << std::setprecision(1) << std::showpos
+                      << (drift - 1.0) * 100.0 << '%' << std::noshowpos << ", tracked cases are corrected for it\n";
+
+        std::cout << std::left << std::setw(48) << "case" << std::right << std::setw(14) << "baseline/s"
+                  << std::setw(14) << "current/s" << std::setw(10) << "change" << std::setw(10) << "p" << "  verdict\n";
+
+        std::size_t failures = 0;
+        for (const auto &[name, before] : baseline.samples) {
+            std::cout << std::left << std::setw(48) << name << std::right;
+
+            auto it = current.samples.find(name);
+            if (it == current.samples.end()) {
+                std::cout << std::setw(14) << std::setprecision(0) << median(before) << std::setw(14) << "-"
+                          << std::setw(10) << "-" << std::setw(10) << "-" << "  MISSING\n";
+                ++failures;
+                continue;
+            }
+
+            const bool controlCase = isControl(name, control);
+            std::vector<double> after = it->second;
+            if (!controlCase) {
+                for (double &sample : after)
+                    sample /= drift;
+            }
+
+            const double old = median(before), now = median(after);
+            const double change = (now / old - 1.0) * 100.0;
+            const double p = mannWhitneyP(before, after);
+            const bool significant = p < alpha;
+
+            const char *verdict = "same";
+            if (controlCase) {
+                verdict = "control";
+            } else if (significant and change < -threshold) {
+                verdict = "REGRESSION";
+                ++failures;
+            } else if (significant and change > threshold) {
+                verdict = "faster";
+            }
+
+            std::cout << std::setw(14) << std::setprecision(0) << old << std::setw(14) << now << std::setw(9)
+                      << std::setprecision(1) << std::showpos << change << '%' << std::noshowpos << std::setw(10)
+                      << std::setprecision(4) << p << "  " << verdict << '\n';
+        }
+
+        for (const auto &[name, samples] : current.samples) {
+            if (baseline.samples.count(name) == 0)
+                std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << "-"
+                          << std::setw(14) << std::setprecision(0) << median(samples) << "  new\n";
+        }
+
+        if (failures != 0) {
+            std::cout << failures << " tracked case(s) regressed more than " << std::setprecision(1) << threshold
+                      << "% (p < " << std::setprecision(3) << alpha << ")\n";
+            return 1;
+        }
+        std::cout << "no regressions beyond " << std::setprecision(1) << threshold << "%\n";
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        return compare(argc, argv);
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << '\n';
+        return 2;
+    }
+}
@@ -0,0 +1,321 @@
+#include "allocation_counter.h"
+#include "engine_list.h"
+#include "workload.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Head-to-head SET/GET/DEL/mixed/scan numbers for the engines the
+ * interactive comparison view used to time once with sequential keys.
+ *
+ *   --storage_max_size=N     largest storage to load, up to 100'000'000 (default 1 << 20)
+ *   --storage_iterations=N   run every case for exactly N passes over its storage instead of
+ *                            letting Google Benchmark pick the count; `make perf` uses it so
+ *                            runs from two commits do the same work
+ *
+ * Everything else is Google Benchmark: --benchmark_repetitions=5 gives
+ * mean/median/stddev/cv per case, --benchmark_filter='Find/.*zipfian'
+ * picks cases, --benchmark_out=results.json --benchmark_out_format=json
+ * (or csv) writes machine-readable results.
+ */
+
+using ttl::benchmarks::key_distribution;
+using ttl::benchmarks::workload;
+
+namespace {
+    // accesses replayed by GET and mixed cases; a power of two so the stream wraps with a mask
+    constexpr std::size_t kOperations = std::size_t{1} << 20;
+    constexpr std::size_t kMaxStorageSize = 100'000'000;
+
+    std::size_t max_storage_size = std::size_t{1} << 20;
+    std::size_t fixed_passes = 0;
+
+    template <typename Key> using std_unordered_map = std::unordered_map<Key, std::uint64_t>;
+    template <typename Key> using std_map = std::map<Key, std::uint64_t>;
+
+    /*
+     * Keeps the last thing built and nothing else. Loading 100M keys into
+     * one engine takes several GB, so the previous workload or storage is
+     * released before the next is built; benchmarks are registered so that
+     * consecutive cases share them.
+     */
+    class resident {
+    public:
+        template <typename T, typename Builder>
+        T &get(const std::string &tag, Builder builder) {
+            if (tag_ != tag) {
+                clear();
+                value_ = std::make_shared<T>(builder());
+                tag_ = tag;
+            }
+            return *static_cast<T *>(value_.get());
+        }
+
+        void clear() {
+            value_.reset();
+            tag_.clear();
+        }
+
+    private:
+        std::string tag_;
+        std::shared_ptr<void> value_;
+    };
+
+    resident workloads;
+    resident storages;
+
+    std::string tagOf(key_distribution distribution, std::size_t size) {
+        return std::string(ttl::benchmarks::key_distribution_name(distribution)) + "/" + std::to_string(size);
+    }
+
+    template <typename Key>
+    const workload<Key> &getWorkload(key_distribution distribution, std::size_t size) {
+        return workloads.get<workload<Key>>(tagOf(distribution, size), [&] {
+            return ttl::benchmarks::make_workload<Key>(distribution, size, kOperations);
+        });
+    }
+
+    template <typename Storage, typename Key>
+    void load(Storage &storage, const workload<Key> &keys) {
+        std::uint64_t value = 0;
+        for (const auto &key : keys.keys)
+            storage.insert({key, value++});
+    }
+
+    template <typename Storage, typename Key>
+    Storage &getStorage(const char *engine, key_distribution distribution, const workload<Key> &keys) {
+        return storages.get<Storage>(std::string(engine) + "/" + tagOf(distribution, keys.keys.size()), [&] {
+            Storage storage;
+            load(storage, keys);
+            return storage;
+        });
+    }
+
+    // operator new calls per processed item, from the counting allocator linked into this binary
+    void reportAllocations(benchmark::State &state, std::uint64_t allocations) {
+        const auto items = std::max<std::int64_t>(1, state.items_processed());
+        state.counters["allocs_per_op"] = static_cast<double>(allocations) / static_cast<double>(items);
+    }
+
+    // one untimed pass so the first repetition doesn't pay for cold caches and page faults
+    template <typename Storage, typename Key>
+    void warmUp(Storage &storage, const workload<Key> &keys) {
+        std::size_t found = 0;
+        for (std::size_t i = 0, last = std::min(kOperations, keys.keys.size()); i != last; ++i)
+            found += storage.find(keys.keys[keys.operations[i].index]) != storage.end();
+        benchmark::DoNotOptimize(found);
+    }
+
+    // SET: load every key into an empty engine, growth included
+    template <typename Storage, typename Key>
+    void BM_Insert(benchmark::State &state, key_distribution distribution) {
+        storages.clear();
+        const auto &keys = getWorkload<Key>(distribution, state.range(0));
+
+        std::uint64_t allocations = 0;
+        for (auto _ : state) {
+            const ttl::allocation_scope timed;
+            Storage storage;
+            load(storage, keys);
+            benchmark::ClobberMemory();
+            allocations += timed.allocations();
+
+            state.PauseTiming();
+            storage = Storage{};
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        reportAllocations(state, allocations);
+    }
+
+    // GET: hits only, in the distribution's access order
+    template <typename Storage, typename Key>
+    void BM_Find(benchmark::State &state, const char *engine, key_distribution distribution) {
+        const auto &keys = getWorkload<Key>(distribution, state.range(0));
+        auto &storage = getStorage<Storage>(engine, distribution, keys);
+        warmUp(storage, keys);
+
+        std::size_t i = 0, found = 0;
+        const ttl::allocation_scope timed;
+        for (auto _ : state) {
+            const auto &operation = keys.operations[i++ & (kOperations - 1)];
+            found += storage.find(keys.keys[operation.index]) != storage.end();
+        }
+        benchmark::DoNotOptimize(found);
+        state.SetItemsProcessed(state.iterations());
+        reportAllocations(state, timed.allocations());
+    }
+
+    // GET/SET mix: range(1) percent of accesses read, the rest overwrite the value
+    template <typename Storage, typename Key>
+    void BM_Mixed(benchmark::State &state, const char *engine, key_distribution distribution) {
+        const auto &keys = getWorkload<Key>(distribution, state.range(0));
+        auto &storage = getStorage<Storage>(engine, distribution, keys);
+        const auto reads = static_cast<std::uint8_t>(state.range(1));
+        warmUp(storage, keys);
+
+        std::size_t i = 0, found = 0;
+        const ttl::allocation_scope timed;
+        for (auto _ : state) {
+            const auto &operation = keys.operations[i & (kOperations - 1)];
+            if (operation.roll < reads)
+                found += storage.find(keys.keys[operation.index]) != storage.end();
+            else
+                storage[keys.keys[operation.index]] = i;
+            ++i;
+        }
+        benchmark::DoNotOptimize(found);
+        state.SetItemsProcessed(state.iterations());
+        reportAllocations(state, timed.allocations());
+    }
+
+    // DEL: erase every key in load order, then put them back untimed
+    template <typename Storage, typename Key>
+    void BM_Erase(benchmark::State &state, key_distribution distribution) {
+        storages.clear();
+        const auto &keys = getWorkload<Key>(distribution, state.range(0));
+        Storage storage;
+        load(storage, keys);
+
+        std::uint64_t allocations = 0;
+        for (auto _ : state) {
+            const ttl::allocation_scope timed;
+            for (const auto &key : keys.keys)
+                storage.erase(key);
+            benchmark::ClobberMemory();
+            allocations += timed.allocations();
+
+            state.PauseTiming();
+            load(storage, keys);
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        reportAllocations(state, allocations);
+    }
+
+    // SCAN: one in-order pass over every entry
+    template <typename Storage, typename Key>
+    void BM_Iterate(benchmark::State &state, const char *engine, key_distribution distribution) {
+        const auto &keys = getWorkload<Key>(distribution, state.range(0));
+        auto &storage = getStorage<Storage>(engine, distribution, keys);
+
+        std::uint64_t sum = 0;
+        const ttl::allocation_scope timed;
+        for (auto _ : state) {
+            for (const auto &[key, value] : storage)
+                sum += value;
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        reportAllocations(state, timed.allocations());
+    }
+
+    // with --storage_iterations every case processes passes x size items, whatever one iteration is
+    benchmark::internal::Benchmark *fixIterations(benchmark::internal::Benchmark *case_, std::size_t itemsPerIteration,
+                                                  std::size_t size) {
+        if (fixed_passes != 0)
+            case_->Iterations(static_cast<benchmark::IterationCount>(fixed_passes * size / itemsPerIteration));
+        return case_;
+    }
+
+    template <typename Storage, typename Key>
+    void registerEngine(const char *engine, key_distribution distribution, std::size_t size) {
+        const std::string suffix = std::string(engine) + "/" + ttl::benchmarks::key_distribution_name(distribution);
+        const auto arg = static_cast<std::int64_t>(size);
+
+        fixIterations(benchmark::RegisterBenchmark(("Find/" + suffix).c_str(), BM_Find<Storage, Key>, engine, distribution)
+            ->Arg(arg)->ArgName("size"), 1, size);
+        for (std::int64_t reads : {95, 50})
+            fixIterations(benchmark::RegisterBenchmark(("Mixed/" + suffix).c_str(), BM_Mixed<Storage, Key>, engine, distribution)
+                ->Args({arg, reads})->ArgNames({"size", "reads"}), 1, size);
+        fixIterations(benchmark::RegisterBenchmark(("Iterate/" + suffix).c_str(), BM_Iterate<Storage, Key>, engine, distribution)
+            ->Arg(arg)->ArgName("size")->Unit(benchmark::kMicrosecond), size, size);
+        fixIterations(benchmark::RegisterBenchmark(("Insert/" + suffix).c_str(), BM_Insert<Storage, Key>, distribution)
+            ->Arg(arg)->ArgName("size")->Unit(benchmark::kMillisecond), size, size);
+        fixIterations(benchmark::RegisterBenchmark(("Erase/" + suffix).c_str(), BM_Erase<Storage, Key>, distribution)
+            ->Arg(arg)->ArgName("size")->Unit(benchmark::kMillisecond), size, size);
+    }
+
+    template <typename Key>
+    void registerEngines(key_distribution distribution, std::size_t size) {
+        // every engine that takes Key gets the same cases, see engine_list.h
+        ttl::for_each_engine<Key, std::uint64_t>([&](auto engine) {
+            using storage_type = typename decltype(engine)::type;
+            registerEngine<storage_type, Key>(ttl::engine_name<storage_type>, distribution, size);
+        });
+        registerEngine<std_unordered_map<Key>, Key>("std::unordered_map", distribution, size);
+        registerEngine<std_map<Key>, Key>("std::map", distribution, size);
+    }
+
+    // 1K, 8K, 64K, ... up to and including the largest size
+    std::vector<std::size_t> storageSizes() {
+        std::vector<std::size_t> sizes;
+        for (std::size_t size = 1 << 10; size < max_storage_size; size *= 8)
+            sizes.push_back(size);
+        sizes.push_back(max_storage_size);
+        return sizes;
+    }
+
+    // value of `--flag=N` if argv[i] is that flag
+    bool parseSize(const char *arg, const char *flag, std::size_t min, std::size_t max, std::size_t &value, bool &error) {
+        const std::size_t length = std::strlen(flag);
+        if (std::strncmp(arg, flag, length) != 0)
+            return false;
+
+        char *end = nullptr;
+        const unsigned long long parsed = std::strtoull(arg + length, &end, 10);
+        if (*end != '\0' or parsed < min or parsed > max) {
+            std::cerr << flag << " must be in [" << min << ", " << max << "]\n";
+            error = true;
+        }
+        value = static_cast<std::size_t>(parsed);
+        return true;
+    }
+
+    // strips --storage_max_size=N and --storage_iterations=N before Google Benchmark sees the flags
+    bool parseFlags(int &argc, char **argv) {
+        bool error = false;
+        int kept = 1;
+        for (int i = 1; i != argc; ++i) {
+            if (!parseSize(argv[i], "--storage_max_size=", 2, kMaxStorageSize, max_storage_size, error) and
+                !parseSize(argv[i], "--storage_iterations=", 1, 1'000'000, fixed_passes, error))
+                argv[kept++] = argv[i];
+        }
+        if (error)
+            return false;
+        argc = kept;
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (!parseFlags(argc, argv))
+        return 1;
+
+    // distribution, then size, then engine: consecutive cases reuse the resident workload and storage
+    for (std::size_t size : storageSizes())
+        registerEngines<std::uint64_t>(key_distribution::kUniform, size);
+    for (std::size_t size : storageSizes())
+        registerEngines<std::uint64_t>(key_distribution::kZipfian, size);
+    for (std::size_t size : storageSizes())
+        registerEngines<std::string>(key_distribution::kRandomString, size);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,139 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_WORKLOAD_H
+#define TRANSACTIONS_LIBRARY_CPP_WORKLOAD_H
+
+#include "unordered_map_hash.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ttl::benchmarks {
+    enum class key_distribution {
+        kUniform,      // 64-bit keys, every key equally likely
+        kZipfian,      // 64-bit keys, a few hot keys take most accesses
+        kRandomString, // 16-character keys, every key equally likely
+    };
+
+    inline const char *key_distribution_name(key_distribution distribution) {
+        switch (distribution) {
+            case key_distribution::kUniform:      return "uniform";
+            case key_distribution::kZipfian:      return "zipfian";
+            case key_distribution::kRandomString: return "random_string";
+        }
+        return "unknown";
+    }
+
+    /*
+     * Zipfian ranks over [0, n) with skew theta, after Gray et al., "Quickly
+     * Generating Billion-Record Synthetic Databases" - the generator YCSB
+     * uses. Setup sums zeta(n) once in O(n); every draw is O(1). Rank 0 is
+     * the hottest; callers scramble ranks so hot keys aren't neighbours.
+     */
+    class zipfian_distribution {
+    public:
+        static constexpr double kDefaultTheta = 0.99;
+
+        explicit zipfian_distribution(std::uint64_t n, double theta = kDefaultTheta)
+            : n_(n), theta_(theta), zeta_n_(zeta(n, theta)), alpha_(1.0 / (1.0 - theta)) {
+            const double zeta_2 = zeta(2, theta);
+            eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta_2 / zeta_n_);
+        }
+
+        template <typename URBG>
+        std::uint64_t operator()(URBG &generator) const {
+            const double u = std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+            const double uz = u * zeta_n_;
+            if (uz < 1.0)
+                return 0;
+            if (uz < 1.0 + std::pow(0.5, theta_))
+                return n_ > 1 ? 1 : 0;
+
+            const auto rank = static_cast<std::uint64_t>(static_cast<double>(n_) *
+                                                         std::pow(eta_ * u - eta_ + 1.0, alpha_));
+            return rank < n_ ? rank : n_ - 1;
+        }
+
+    private:
+        std::uint64_t n_;
+        double theta_;
+        double zeta_n_;
+        double alpha_;
+        double eta_ = 0.0;
+
+        static double zeta(std::uint64_t n, double theta) {
+            double sum = 0.0;
+            for (std::uint64_t i = 1; i <= n; ++i)
+                sum += 1.0 / std::pow(static_cast<double>(i), theta);
+            return sum;
+        }
+    };
+
+    // distinct i give distinct keys (splitmix64 is a bijection) in no useful order
+    inline std::uint64_t integer_key(std::uint64_t i) {
+        std::uint64_t state = i;
+        return detail::splitmix64(state);
+    }
+
+    inline std::string random_string_key(std::mt19937_64 &generator, std::size_t length = 16) {
+        static constexpr char kAlphabet[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        std::uniform_int_distribution<std::size_t> letter(0, sizeof(kAlphabet) - 2);
+
+        std::string key(length, '\0');
+        for (char &c : key)
+            c = kAlphabet[letter(generator)];
+        return key;
+    }
+
+    // one access: which loaded key, and a roll in [0, 100) that picks read or write
+    struct operation {
+        std::uint64_t index;
+        std::uint8_t roll;
+    };
+
+    /*
+     * Keys in load order plus a fixed stream of accesses into them. Both
+     * are generated up front from a fixed seed, so every engine sees the
+     * same keys in the same order and no RNG runs inside a timed loop.
+     */
+    template <typename Key>
+    struct workload {
+        std::vector<Key> keys;
+        std::vector<operation> operations;
+    };
+
+    template <typename Key>
+    workload<Key> make_workload(key_distribution distribution, std::size_t size, std::size_t operations,
+                                std::uint64_t seed = 42) {
+        std::mt19937_64 generator(seed);
+        workload<Key> result;
+
+        result.keys.reserve(size);
+        for (std::size_t i = 0; i != size; ++i) {
+            if constexpr (std::is_same_v<Key, std::string>)
+                result.keys.push_back(random_string_key(generator));
+            else
+                result.keys.push_back(static_cast<Key>(integer_key(i)));
+        }
+
+        std::uniform_int_distribution<std::uint64_t> uniform(0, size - 1);
+        std::uniform_int_distribution<unsigned> roll(0, 99);
+        result.operations.reserve(operations);
+
+        if (distribution == key_distribution::kZipfian) {
+            const zipfian_distribution zipfian(size);
+            for (std::size_t i = 0; i != operations; ++i)
+                result.operations.push_back({integer_key(zipfian(generator)) % size,
+                                             static_cast<std::uint8_t>(roll(generator))});
+        } else {
+            for (std::size_t i = 0; i != operations; ++i)
+                result.operations.push_back({uniform(generator), static_cast<std::uint8_t>(roll(generator))});
+        }
+
+        return result;
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_WORKLOAD_H
@@ -0,0 +1,403 @@
+#include "art_map.h"
+#include "command_factory.h"
+#include "latency_histogram.h"
+#include "map.h"
+#include "robin_hood_map.h"
+#include "student.h"
+#include "student_generator.h"
+#include "unordered_map.h"
+#include "workload.h"
+
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*
+ * YCSB-style end-to-end driver: builds the command lines a client would
+ * type, then replays them through CommandFactory::getCommand and
+ * Command::Run against a storage, timing each operation from parse to
+ * reply. Command output goes to a discarding stream buffer, so it is
+ * formatted but not written anywhere.
+ *
+ *   --workload=ABCDEF   core workloads to run, in order (default A)
+ *   --engine=hash|robin|tree|art|all
+ *   --records=N         keys loaded before the run (default 100000)
+ *   --operations=N      operations per run (default 1000000)
+ *   --seed=N            operation stream seed (default 42)
+ *   --format=text|json
+ *   --out=path          write the report there instead of stdout
+ *
+ * With the same records, operations and seed every run replays the same
+ * command lines, so JSON reports from two commits compare directly.
+ */
+
+namespace {
+    using ttl::Student;
+    using ttl::latency_histogram;
+    using ttl::benchmarks::zipfian_distribution;
+
+    using hash_storage = ttl::unordered_map<std::string, Student>;
+    using robin_hood_storage = ttl::robin_hood_map<std::string, Student>;
+    using tree_storage = ttl::map<std::string, Student, std::less<std::string>,
+                                  ttl::map_options::kOrderStatistics | ttl::map_options::kThreaded>;
+    using radix_storage = ttl::art_map<std::string, Student>;
+
+    enum class operation_type { kRead, kUpdate, kInsert, kScan, kReadModifyWrite };
+    constexpr std::size_t kOperationTypes = 5;
+    constexpr std::array<const char *, kOperationTypes> kOperationNames = {"read", "update", "insert", "scan",
+                                                                           "read_modify_write"};
+
+    enum class request_distribution { kZipfian, kLatest };
+
+    // proportions in percent, as in YCSB's workloads/workload[a-f]
+    struct workload_spec {
+        char name;
+        std::array<unsigned, kOperationTypes> percent;
+        request_distribution distribution;
+    };
+
+    constexpr std::array<workload_spec, 6> kWorkloads = {{
+        {'A', {50, 50, 0, 0, 0}, request_distribution::kZipfian},  // update heavy
+        {'B', {95, 5, 0, 0, 0}, request_distribution::kZipfian},   // read mostly
+        {'C', {100, 0, 0, 0, 0}, request_distribution::kZipfian},  // read only
+        {'D', {95, 0, 5, 0, 0}, request_distribution::kLatest},    // read latest
+        {'E', {0, 0, 5, 95, 0}, request_distribution::kZipfian},   // short ranges
+        {'F', {50, 0, 0, 0, 50}, request_distribution::kZipfian},  // read-modify-write
+    }};
+
+    constexpr std::size_t kMaxScanLength = 100;
+
+    struct options {
+        std::string workloads = "A";
+        std::string engine = "all";
+        std::size_t records = 100'000;
+        std::size_t operations = 1'000'000;
+        std::uint64_t seed = 42;
+        std::string format = "text";
+        std::string out;
+    };
+
+    // one client request: RMW sends a GET and then an UPDATE, timed together
+    struct request {
+        operation_type type;
+        std::vector<std::string> lines;
+    };
+
+    std::string keyOf(std::uint64_t i) {
+        return "user" + std::to_string(ttl::benchmarks::integer_key(i));
+    }
+
+    class record_generator {
+    public:
+        explicit record_generator(std::uint64_t seed) : generator_(seed) {}
+
+        std::string record() {
+            std::string line;
+            ttl::student_generator::append_fields(line, records_.record(generator_));
+            return line;
+        }
+
+        int coins() { return std::uniform_int_distribution<int>(0, 9999)(generator_); }
+        std::size_t scanLength() { return std::uniform_int_distribution<std::size_t>(1, kMaxScanLength)(generator_); }
+        unsigned roll() { return std::uniform_int_distribution<unsigned>(0, 99)(generator_); }
+
+        std::mt19937_64 &generator() { return generator_; }
+
+    private:
+        std::mt19937_64 generator_;
+        ttl::student_generator records_ {ttl::student_generator_options{}};
+    };
+
+    template <typename Storage>
+    constexpr bool kOrdered = ttl::detail::has_bounds<Storage>::value;
+
+    /*
+     * The whole request stream for one run, generated before anything is
+     * timed. Keys chosen by the zipfian distribution are scrambled over
+     * the loaded records; "latest" favours the most recent inserts.
+     */
+    template <typename Storage>
+    std::vector<request> makeRequests(const workload_spec &spec, const options &options) {
+        record_generator generator(options.seed);
+        const zipfian_distribution zipfian(options.records);
+        std::uint64_t inserted = options.records;
+
+        auto chooseKey = [&] {
+            const std::uint64_t rank = zipfian(generator.generator());
+            if (spec.distribution == request_distribution::kLatest)
+                return keyOf(inserted - 1 - rank % inserted);
+            return keyOf(ttl::benchmarks::integer_key(rank) % options.records);
+        };
+
+        std::vector<request> requests;
+        requests.reserve(options.operations);
+        for (std::size_t i = 0; i != options.operations; ++i) {
+            unsigned roll = generator.roll(), type = 0;
+            while (roll >= spec.percent[type]) {
+                roll -= spec.percent[type];
+                ++type;
+            }
+
+            request next{static_cast<operation_type>(type), {}};
+            switch (next.type) {
+                case operation_type::kRead:
+                    next.lines.push_back("GET " + chooseKey());
+                    break;
+                case operation_type::kUpdate:
+                    next.lines.push_back("UPDATE " + chooseKey() + " - - - - " + std::to_string(generator.coins()));
+                    break;
+                case operation_type::kInsert:
+                    next.lines.push_back("SET " + keyOf(inserted++) + ' ' + generator.record());
+                    break;
+                case operation_type::kScan: {
+                    // the hash table has no key order: SCAN walks the same number of entries from its start
+                    const std::string from = chooseKey();
+                    const std::string length = std::to_string(generator.scanLength());
+                    if constexpr (kOrdered<Storage>)
+                        next.lines.push_back("RANGE " + from + " user~ LIMIT " + length);
+                    else
+                        next.lines.push_back("SCAN 0 COUNT " + length);
+                    break;
+                }
+                case operation_type::kReadModifyWrite: {
+                    const std::string key = chooseKey();
+                    next.lines.push_back("GET " + key);
+                    next.lines.push_back("UPDATE " + key + " - - - - " + std::to_string(generator.coins()));
+                    break;
+                }
+            }
+            requests.push_back(std::move(next));
+        }
+
+        return requests;
+    }
+
+    // swallows command replies; xsputn keeps it from being called once per character
+    class discard_buffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+    };
+
+    struct run_result {
+        char workload;
+        std::string engine;
+        std::size_t records = 0;
+        std::size_t operations = 0;
+        double load_seconds = 0.0;
+        double run_seconds = 0.0;
+        latency_histogram overall;
+        std::array<latency_histogram, kOperationTypes> latencies;
+    };
+
+    template <typename Storage>
+    std::uint64_t execute(Storage &storage, ttl::CommandContext<Storage> &context, const std::string &line) {
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        if (auto command = ttl::CommandFactory::getCommand(line, storage, &context))
+            command->Run(storage);
+        return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - begin).count());
+    }
+
+    template <typename Storage>
+    run_result run(const workload_spec &spec, const char *engine, const options &options) {
+        run_result result;
+        result.workload = spec.name;
+        result.engine = engine;
+        result.records = options.records;
+        result.operations = options.operations;
+
+        const std::vector<request> requests = makeRequests<Storage>(spec, options);
+        record_generator loader(options.seed ^ 0x6c6f6164ull);
+
+        Storage storage;
+        ttl::CommandContext<Storage> context;
+        discard_buffer discard;
+        std::streambuf *console = std::cout.rdbuf(&discard);
+
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        for (std::size_t i = 0; i != options.records; ++i)
+            execute(storage, context, "SET " + keyOf(i) + ' ' + loader.record());
+        result.load_seconds = duration<double>(steady_clock::now() - begin).count();
+
+        begin = steady_clock::now();
+        for (const request &next : requests) {
+            std::uint64_t nanoseconds = 0;
+            for (const std::string &line : next.lines)
+                nanoseconds += execute(storage, context, line);
+
+            result.overall.record(nanoseconds);
+            result.latencies[static_cast<std::size_t>(next.type)].record(nanoseconds);
+        }
+        result.run_seconds = duration<double>(steady_clock::now() - begin).count();
+
+        std::cout.rdbuf(console);
+        return result;
+    }
+
+    double throughput(std::size_t count, double seconds) {
+        return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+    }
+
+    void printText(std::ostream &out, const std::vector<run_result> &results) {
+        out << std::fixed << std::setprecision(1);
+        for (const run_result &result : results) {
+            out << "workload " << result.workload << " on " << result.engine << ": " << result.records
+                << " records, " << result.operations << " operations\n";
+            out << "  load: " << throughput(result.records, result.load_seconds) << " ops/sec\n";
+            out << "  run:  " << throughput(result.operations, result.run_seconds) << " ops/sec\n";
+
+            auto line = [&](const char *name, const latency_histogram &latency) {
+                out << "  " << std::left << std::setw(18) << name << std::right << std::setw(9) << latency.count()
+                    << "  mean " << latency.mean() / 1000.0
+                    << "  p50 " << latency.percentile(0.50) / 1000.0
+                    << "  p95 " << latency.percentile(0.95) / 1000.0
+                    << "  p99 " << latency.percentile(0.99) / 1000.0
+                    << "  p999 " << latency.percentile(0.999) / 1000.0
+                    << "  max " << latency.max() / 1000.0 << " us\n";
+            };
+
+            line("overall", result.overall);
+            for (std::size_t type = 0; type != kOperationTypes; ++type)
+                if (result.latencies[type].count())
+                    line(kOperationNames[type], result.latencies[type]);
+        }
+    }
+
+    void printJson(std::ostream &out, const std::vector<run_result> &results) {
+        auto histogram = [&](const latency_histogram &latency) {
+            out << "{\"count\": " << latency.count() << ", \"mean_ns\": " << latency.mean()
+                << ", \"p50_ns\": " << latency.percentile(0.50) << ", \"p95_ns\": " << latency.percentile(0.95)
+                << ", \"p99_ns\": " << latency.percentile(0.99) << ", \"p999_ns\": " << latency.percentile(0.999)
+                << ", \"max_ns\": " << latency.max() << "}";
+        };
+
+        out << "[\n";
+        for (std::size_t i = 0; i != results.size(); ++i) {
+            const run_result &result = results[i];
+            out << "  {\"workload\": \"" << result.workload << "\", \"engine\": \"" << result.engine
+                << "\", \"records\": " << result.records << ", \"operations\": " << result.operations
+                << ", \"load_ops_per_sec\": " << throughput(result.records, result.load_seconds)
+                << ", \"run_ops_per_sec\": " << throughput(result.operations, result.run_seconds)
+                << ",\n   \"overall\": ";
+            histogram(result.overall);
+            for (std::size_t type = 0; type != kOperationTypes; ++type) {
+                if (!result.latencies[type].count())
+                    continue;
+                out << ",\n   \"" << kOperationNames[type] << "\": ";
+                histogram(result.latencies[type]);
+            }
+            out << "}" << (i + 1 != results.size() ? "," : "") << '\n';
+        }
+        out << "]\n";
+    }
+
+    bool parseOptions(int argc, char **argv, options &options) {
+        for (int i = 1; i != argc; ++i) {
+            const std::string argument = argv[i];
+            const auto equals = argument.find('=');
+            const std::string name = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+
+            try {
+                if (name == "--workload")
+                    options.workloads = value;
+                else if (name == "--engine")
+                    options.engine = value;
+                else if (name == "--records")
+                    options.records = std::stoull(value);
+                else if (name == "--operations")
+                    options.operations = std::stoull(value);
+                else if (name == "--seed")
+                    options.seed = std::stoull(value);
+                else if (name == "--format")
+                    options.format = value;
+                else if (name == "--out")
+                    options.out = value;
+                else {
+                    std::cerr << "unknown option '" << argument << "'\n";
+                    return false;
+                }
+            } catch (std::exception &) {
+                std::cerr << "can't parse '" << argument << "'\n";
+                return false;
+            }
+        }
+
+        if (options.records < 2 or options.operations == 0) {
+            std::cerr << "records must be at least 2 and operations at least 1\n";
+            return false;
+        }
+        if (options.engine != "hash" and options.engine != "robin" and options.engine != "tree" and
+            options.engine != "art" and options.engine != "all") {
+            std::cerr << "engine must be hash, robin, tree, art or all\n";
+            return false;
+        }
+        if (options.format != "text" and options.format != "json") {
+            std::cerr << "format must be text or json\n";
+            return false;
+        }
+        return true;
+    }
+
+    const workload_spec *findWorkload(char name) {
+        for (const workload_spec &spec : kWorkloads)
+            if (spec.name == std::toupper(static_cast<unsigned char>(name)))
+                return &spec;
+        return nullptr;
+    }
+}
+
+int main(int argc, char **argv) {
+    options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    std::vector<const workload_spec *> specs;
+    for (char name : options.workloads) {
+        specs.push_back(findWorkload(name));
+        if (!specs.back()) {
+            std::cerr << "unknown workload '" << name << "', expected A-F\n";
+            return 1;
+        }
+    }
+
+    std::vector<run_result> results;
+    for (const workload_spec *spec : specs) {
+        if (options.engine == "hash" or options.engine == "all")
+            results.push_back(run<hash_storage>(*spec, "ttl::unordered_map", options));
+        if (options.engine == "robin" or options.engine == "all")
+            results.push_back(run<robin_hood_storage>(*spec, "ttl::robin_hood_map", options));
+        if (options.engine == "tree" or options.engine == "all")
+            results.push_back(run<tree_storage>(*spec, "ttl::map", options));
+        if (options.engine == "art" or options.engine == "all")
+            results.push_back(run<radix_storage>(*spec, "ttl::art_map", options));
+    }
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file.is_open()) {
+            std::cerr << "can't open '" << options.out << "'\n";
+            return 1;
+        }
+    }
+
+    std::ostream &out = options.out.empty() ? std::cout : file;
+    if (options.format == "json")
+        printJson(out, results);
+    else
+        printText(out, results);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "allocation_counter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Replacement global allocation functions that count every call on the
+ * calling thread (see allocation_counter.h). Link this file into a binary
+ * to turn the counters on; all forms of new and delete are replaced
+ * together so memory from one is never released by the other.
+ */
+
+namespace {
+    void *allocate(std::size_t size) noexcept {
+        ttl::allocation_counter::record(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void *allocate(std::size_t size, std::align_val_t alignment) noexcept {
+        ttl::allocation_counter::record(size);
+
+        void *pointer = nullptr;
+        const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+        if (posix_memalign(&pointer, align, size ? size : 1) != 0)
+            return nullptr;
+        return pointer;
+    }
+
+    template <typename... Alignment>
+    void *allocate_or_throw(std::size_t size, Alignment... alignment) {
+        if (void *pointer = allocate(size, alignment...))
+            return pointer;
+        throw std::bad_alloc();
+    }
+
+    [[maybe_unused]] const bool kInstalled = (ttl::allocation_counter::install(), true);
+}
+
+void *operator new(std::size_t size) { return allocate_or_throw(size); }
+void *operator new[](std::size_t size) { return allocate_or_throw(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, alignment); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
@@ -0,0 +1,66 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ALLOCATION_COUNTER_H
+#define TRANSACTIONS_LIBRARY_CPP_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ttl {
+    /*
+     * Per-thread count of global operator new calls. The counting is done
+     * by the replacement operators in allocation_counter.cc; a binary that
+     * doesn't link that file still compiles against this header, reads
+     * zeros and reports enabled() == false.
+     *
+     * Everything the storages allocate goes through std::allocator and so
+     * through operator new; direct malloc calls are not seen.
+     */
+    class allocation_counter {
+    public:
+        struct snapshot {
+            std::uint64_t allocations = 0;
+            std::uint64_t bytes = 0;
+        };
+
+        [[nodiscard]] static bool enabled() noexcept { return installed_; }
+
+        [[nodiscard]] static snapshot now() noexcept { return {allocations_, bytes_}; }
+
+        // allocations made by this thread since `before`
+        [[nodiscard]] static std::uint64_t since(const snapshot &before) noexcept {
+            return allocations_ - before.allocations;
+        }
+
+        static void record(std::size_t size) noexcept {
+            ++allocations_;
+            bytes_ += size;
+        }
+
+        static void install() noexcept { installed_ = true; }
+
+    private:
+        static inline thread_local std::uint64_t allocations_ = 0;
+        static inline thread_local std::uint64_t bytes_ = 0;
+        static inline bool installed_ = false;
+    };
+
+    /*
+     * Allocations made by this thread while the scope is alive, e.g.
+     *
+     *   allocation_scope scope;
+     *   storage.find(key);
+     *   ASSERT_EQ(scope.allocations(), 0);
+     */
+    class allocation_scope {
+    public:
+        [[nodiscard]] std::uint64_t allocations() const noexcept { return allocation_counter::since(begin_); }
+
+        [[nodiscard]] std::uint64_t bytes() const noexcept {
+            return allocation_counter::now().bytes - begin_.bytes;
+        }
+
+    private:
+        allocation_counter::snapshot begin_ = allocation_counter::now();
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ALLOCATION_COUNTER_H
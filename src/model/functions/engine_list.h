@@ -0,0 +1,64 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ENGINE_LIST_H
+#define TRANSACTIONS_LIBRARY_CPP_ENGINE_LIST_H
+
+#include <string>
+#include <type_traits>
+
+#include "art_map.h"
+#include "engine_traits.h"
+#include "map.h"
+#include "robin_hood_map.h"
+#include "unordered_map.h"
+
+namespace ttl {
+    template <typename... Engines>
+    struct engine_list {};
+
+    template <typename Engine>
+    struct engine_tag {
+        using type = Engine;
+    };
+
+    // the name an engine is reported under by the benchmarks
+    template <typename Engine>
+    inline constexpr const char *engine_name = nullptr;
+
+    template <typename Key, typename Value, typename Hash>
+    inline constexpr const char *engine_name<unordered_map<Key, Value, Hash>> = "ttl::unordered_map";
+
+    template <typename Key, typename Value, typename Hash>
+    inline constexpr const char *engine_name<robin_hood_map<Key, Value, Hash>> = "ttl::robin_hood_map";
+
+    template <typename Key, typename Value, typename Compare, unsigned Options>
+    inline constexpr const char *engine_name<map<Key, Value, Compare, Options>> = "ttl::map";
+
+    template <typename Key, typename Value>
+    inline constexpr const char *engine_name<art_map<Key, Value>> = "ttl::art_map";
+
+    /*
+     * Every engine of this library that takes Key, with its default
+     * options. The conformance tests (tests/engine_conformance_test.cc) and
+     * the storage benchmarks walk this list, so an engine added here gets
+     * both without further changes. art_map only takes string keys.
+     */
+    template <typename Key, typename Value>
+    using storage_engines = std::conditional_t<
+            std::is_same_v<Key, std::string>,
+            engine_list<unordered_map<Key, Value>, robin_hood_map<Key, Value>, map<Key, Value>, art_map<Key, Value>>,
+            engine_list<unordered_map<Key, Value>, robin_hood_map<Key, Value>, map<Key, Value>>>;
+
+    namespace detail {
+        template <typename... Engines, typename Functor>
+        void for_each_engine(engine_list<Engines...>, Functor &functor) {
+            (functor(engine_tag<Engines>{}), ...);
+        }
+    }
+
+    // calls functor(engine_tag<Engine>{}) for every engine of storage_engines<Key, Value>
+    template <typename Key, typename Value, typename Functor>
+    void for_each_engine(Functor functor) {
+        detail::for_each_engine(storage_engines<Key, Value>{}, functor);
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ENGINE_LIST_H
@@ -0,0 +1,54 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ENGINE_STATS_H
+#define TRANSACTIONS_LIBRARY_CPP_ENGINE_STATS_H
+
+#include <cstddef>
+
+namespace ttl {
+    /*
+     * Running counters kept by the storages on their hot paths. Plain
+     * increments on members the storage already touches, so they stay on.
+     * A probe is one entry (hash table) or node (tree) compared to the key.
+     */
+    struct engine_stats {
+        std::size_t lookups = 0;
+        std::size_t probes = 0;
+        std::size_t hits = 0;
+        std::size_t hit_probes = 0;
+        std::size_t inserts = 0;
+        std::size_t erases = 0;
+        std::size_t rotations = 0;
+        std::size_t rehashes = 0;
+
+        // starts a lookup, returns what hit() needs to attribute its probes
+        std::size_t lookup() noexcept {
+            ++lookups;
+            return probes;
+        }
+
+        void hit(std::size_t probes_before) noexcept {
+            ++hits;
+            hit_probes += probes - probes_before;
+        }
+
+        [[nodiscard]] double probes_per_hit() const noexcept {
+            return hits ? static_cast<double>(hit_probes) / static_cast<double>(hits) : 0.0;
+        }
+
+        [[nodiscard]] double probes_per_miss() const noexcept {
+            const std::size_t misses = lookups - hits;
+            return misses ? static_cast<double>(probes - hit_probes) / static_cast<double>(misses) : 0.0;
+        }
+
+        [[nodiscard]] double probes_per_lookup() const noexcept {
+            return lookups ? static_cast<double>(probes) / static_cast<double>(lookups) : 0.0;
+        }
+
+        // rebalancing work of the tree, inserts and erases both rotate
+        [[nodiscard]] double rotations_per_write() const noexcept {
+            const std::size_t writes = inserts + erases;
+            return writes ? static_cast<double>(rotations) / static_cast<double>(writes) : 0.0;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ENGINE_STATS_H
@@ -0,0 +1,160 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ENGINE_TRAITS_H
+#define TRANSACTIONS_LIBRARY_CPP_ENGINE_TRAITS_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ttl {
+    namespace detail {
+        template <typename Engine, typename = void>
+        struct is_storage_engine : std::false_type {};
+
+        template <typename Engine>
+        struct is_storage_engine<Engine, std::void_t<
+                typename Engine::key_type,
+                typename Engine::mapped_type,
+                typename Engine::value_type,
+                typename Engine::size_type,
+                typename Engine::iterator,
+                decltype(std::declval<Engine &>().begin() != std::declval<Engine &>().end()),
+                decltype(std::declval<Engine &>().find(std::declval<const typename Engine::key_type &>()) ==
+                         std::declval<Engine &>().end()),
+                decltype(std::declval<Engine &>().insert(std::declval<const typename Engine::value_type &>())),
+                decltype(std::declval<Engine &>()[std::declval<const typename Engine::key_type &>()]),
+                decltype(std::declval<Engine &>().erase(std::declval<typename Engine::iterator>())),
+                decltype(std::declval<const Engine &>().size()),
+                decltype(std::declval<const Engine &>().empty())>>
+            : std::bool_constant<std::is_same_v<decltype(std::declval<Engine &>()[std::declval<const typename Engine::key_type &>()]),
+                                                typename Engine::mapped_type &>> {};
+
+        template <typename Engine, typename = void>
+        struct has_scan : std::false_type {};
+
+        template <typename Engine>
+        struct has_scan<Engine, std::void_t<typename Engine::cursor_type>> : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_bounds : std::false_type {};
+
+        template <typename Engine>
+        struct has_bounds<Engine, std::void_t<decltype(std::declval<Engine &>().lower_bound(
+                std::declval<const typename Engine::key_type &>()))>> : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_order_statistics : std::false_type {};
+
+        template <typename Engine>
+        struct has_order_statistics<Engine, std::void_t<decltype(std::declval<Engine &>().rank(
+                std::declval<const typename Engine::key_type &>()))>> : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_reserve : std::false_type {};
+
+        template <typename Engine>
+        struct has_reserve<Engine, std::void_t<decltype(std::declval<Engine &>().reserve(std::size_t{}))>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_shrink_to_fit : std::false_type {};
+
+        template <typename Engine>
+        struct has_shrink_to_fit<Engine, std::void_t<decltype(std::declval<Engine &>().shrink_to_fit())>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_split : std::false_type {};
+
+        template <typename Engine>
+        struct has_split<Engine, std::void_t<decltype(std::declval<Engine &>().split(std::size_t{}))>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_chain_stats : std::false_type {};
+
+        template <typename Engine>
+        struct has_chain_stats<Engine, std::void_t<decltype(std::declval<const Engine &>().chain_stats())>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_probe_stats : std::false_type {};
+
+        template <typename Engine>
+        struct has_probe_stats<Engine, std::void_t<decltype(std::declval<const Engine &>().probe_stats())>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_memory : std::false_type {};
+
+        template <typename Engine>
+        struct has_memory<Engine, std::void_t<decltype(std::declval<const Engine &>().memory().total())>>
+            : std::true_type {};
+
+        template <typename Engine, typename = void>
+        struct has_stats : std::false_type {};
+
+        template <typename Engine>
+        struct has_stats<Engine, std::void_t<decltype(std::declval<const Engine &>().stats().inserts)>>
+            : std::true_type {};
+
+        // an engine that takes concurrent writers says so with `static constexpr bool kConcurrent = true`
+        template <typename Engine, typename = void>
+        struct declares_concurrent : std::false_type {};
+
+        template <typename Engine>
+        struct declares_concurrent<Engine, std::void_t<decltype(Engine::kConcurrent)>>
+            : std::bool_constant<Engine::kConcurrent> {};
+
+        // values carrying a lifetime in seconds (-1 for none) and its start, as Student does for SET ... EX
+        template <typename Mapped, typename = void>
+        struct has_lifetime : std::false_type {};
+
+        template <typename Mapped>
+        struct has_lifetime<Mapped, std::void_t<decltype(std::declval<Mapped &>().time),
+                                                decltype(std::declval<Mapped &>().life_begin)>> : std::true_type {};
+    }
+
+    /*
+     * The contract the commands, Functions and the benchmarks rely on: the
+     * std::map subset of key_type/mapped_type/value_type/size_type/iterator,
+     * begin/end, find, insert(value_type), operator[], erase(iterator),
+     * size and empty. std::map and std::unordered_map meet it too, which is
+     * what the comparison view and the benchmarks use as baselines.
+     */
+    template <typename Engine>
+    inline constexpr bool is_storage_engine_v = detail::is_storage_engine<Engine>::value;
+
+    /*
+     * What an engine offers beyond that contract, detected from its
+     * interface, so code asks for a capability instead of naming engines:
+     *
+     *   kOrdered          iterates in key order, lower_bound/upper_bound (RANGE, PREFIX)
+     *   kOrderStatistics  rank/select/count_range (RANK, SELECT, COUNT)
+     *   kReservable       reserve(n) makes room for n keys up front
+     *   kShrinkable       shrink_to_fit() gives memory back (COMPACT)
+     *   kScannable        scan(cursor, count, functor) with a cursor_type (SCAN)
+     *   kSplittable       split(parts) into iterator ranges (parallel KEYS and FIND)
+     *   kMemoryStats      memory() breaks its footprint down (INFO memory, maxmemory)
+     *   kEngineStats      stats() counts its operations (INFO stats)
+     *   kConcurrent       safe for concurrent writers, declared by the engine;
+     *                     none of ours is, commands run one at a time
+     *   kSupportsTtl      its values carry a lifetime (SET ... EX, TTL)
+     */
+    template <typename Engine>
+    struct engine_traits {
+        static_assert(is_storage_engine_v<Engine>, "not a storage engine, see is_storage_engine_v");
+
+        static constexpr bool kOrdered = detail::has_bounds<Engine>::value;
+        static constexpr bool kOrderStatistics = detail::has_order_statistics<Engine>::value;
+        static constexpr bool kReservable = detail::has_reserve<Engine>::value;
+        static constexpr bool kShrinkable = detail::has_shrink_to_fit<Engine>::value;
+        static constexpr bool kScannable = detail::has_scan<Engine>::value;
+        static constexpr bool kSplittable = detail::has_split<Engine>::value;
+        static constexpr bool kMemoryStats = detail::has_memory<Engine>::value;
+        static constexpr bool kEngineStats = detail::has_stats<Engine>::value;
+        static constexpr bool kConcurrent = detail::declares_concurrent<Engine>::value;
+        static constexpr bool kSupportsTtl = detail::has_lifetime<typename Engine::mapped_type>::value;
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ENGINE_TRAITS_H
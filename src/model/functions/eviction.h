@@ -0,0 +1,241 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_EVICTION_H
+#define TRANSACTIONS_LIBRARY_CPP_EVICTION_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ttl {
+    enum class eviction_policy {
+        kAllKeysLru,
+        kAllKeysLfu,
+        kVolatileTtl,
+        kAllKeysRandom,
+        kCount
+    };
+
+    namespace detail {
+        inline constexpr std::array<const char *, static_cast<std::size_t>(eviction_policy::kCount)> kEvictionPolicyNames = {
+                "allkeys-lru", "allkeys-lfu", "volatile-ttl", "allkeys-random"
+        };
+    }
+
+    inline std::optional<eviction_policy> parse_eviction_policy(const std::string &name) {
+        const auto &names = detail::kEvictionPolicyNames;
+        for (std::size_t i = 0; i != names.size(); ++i)
+            if (name == names[i])
+                return static_cast<eviction_policy>(i);
+        return std::nullopt;
+    }
+
+    inline const char *eviction_policy_name(eviction_policy policy) {
+        return detail::kEvictionPolicyNames[static_cast<std::size_t>(policy)];
+    }
+
+    /*
+     * Per-key bookkeeping for approximate eviction, in the spirit of Redis:
+     * instead of a global LRU list every entry carries a 24-bit access clock
+     * and an 8-bit logarithmic access counter, and victim() compares a few
+     * randomly sampled entries. Rows are kept dense (erase moves the last row
+     * into the hole), so sampling is a random index. The rows of keys with a
+     * TTL are listed apart, so volatile-ttl samples only among them and
+     * finds one however rare they are.
+     */
+    template <typename Key>
+    class eviction_tracker {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+        using clock_type = std::uint32_t;
+        using time_point = std::chrono::system_clock::time_point;
+
+        static constexpr clock_type kClockMask = (1u << 24) - 1;
+        static constexpr std::uint8_t kCounterInit = 5;
+        static constexpr std::uint8_t kCounterMax = 255;
+        static constexpr unsigned kCounterLogFactor = 10;
+        // LFU counters lose one point per this many clock ticks without an access
+        static constexpr clock_type kCounterDecayTicks = 1u << 12;
+        static constexpr size_type kDefaultSamples = 5;
+        static constexpr size_type kNotExpiring = static_cast<size_type>(-1);
+
+    public:
+        explicit eviction_tracker(size_type samples = kDefaultSamples, std::uint64_t seed = std::random_device{}())
+            : samples_(samples == 0 ? 1 : samples), random_(seed) {}
+
+        [[nodiscard]] size_type size() const noexcept { return entries_.size(); }
+        [[nodiscard]] size_type heap_bytes() const noexcept { return heap_bytes_; }
+        [[nodiscard]] size_type samples() const noexcept { return samples_; }
+        void set_samples(size_type samples) noexcept { samples_ = samples == 0 ? 1 : samples; }
+
+        // `heap` is what the key and value own on the heap, `deadline` is set for keys with a TTL
+        void assign(const key_type &key, size_type heap, std::optional<time_point> deadline) {
+            auto [it, inserted] = rows_.try_emplace(key, entries_.size());
+            if (inserted) {
+                entries_.push_back(entry{key, 0, tick(), kCounterInit, time_point::max(), kNotExpiring});
+            } else {
+                touch(entries_[it->second]);
+            }
+
+            entry &stored = entries_[it->second];
+            heap_bytes_ = heap_bytes_ - stored.heap + heap;
+            stored.heap = heap;
+            stored.deadline = deadline.value_or(time_point::max());
+            set_expiring(it->second, deadline.has_value());
+        }
+
+        void touch(const key_type &key) {
+            auto it = rows_.find(key);
+            if (it != rows_.end())
+                touch(entries_[it->second]);
+        }
+
+        void erase(const key_type &key) {
+            auto it = rows_.find(key);
+            if (it == rows_.end())
+                return;
+
+            const size_type row = it->second, last = entries_.size() - 1;
+            rows_.erase(it);
+            heap_bytes_ -= entries_[row].heap;
+            set_expiring(row, false);
+
+            if (row != last) {
+                rows_[entries_[last].key] = row;
+                entries_[row] = std::move(entries_[last]);
+                if (entries_[row].expiring != kNotExpiring)
+                    expiring_[entries_[row].expiring] = row;
+            }
+            entries_.pop_back();
+        }
+
+        void clear() noexcept {
+            entries_.clear();
+            expiring_.clear();
+            rows_.clear();
+            heap_bytes_ = 0;
+        }
+
+        [[nodiscard]] size_type expiring() const noexcept { return expiring_.size(); }
+
+        /*
+         * The best eviction candidate among `samples` random entries (among
+         * the keys with a TTL for volatile-ttl), or nullopt when the policy
+         * has nothing to offer: no keys, or no key with a TTL. `keep`, if
+         * given, is never picked: the key a write is about to store.
+         */
+        [[nodiscard]] std::optional<key_type> victim(eviction_policy policy, const key_type *keep = nullptr) {
+            const bool volatile_only = policy == eviction_policy::kVolatileTtl;
+            const size_type population = volatile_only ? expiring_.size() : entries_.size();
+
+            std::optional<size_type> kept;
+            if (keep) {
+                auto it = rows_.find(*keep);
+                if (it != rows_.end() and (!volatile_only or entries_[it->second].expiring != kNotExpiring))
+                    kept = it->second;
+            }
+            if (population == (kept ? 1 : 0))
+                return std::nullopt;
+
+            std::uniform_int_distribution<size_type> pick(0, population - 1);
+            auto sample = [&]() -> const entry & {
+                size_type row;
+                do {
+                    const size_type i = pick(random_);
+                    row = volatile_only ? expiring_[i] : i;
+                } while (row == kept);
+                return entries_[row];
+            };
+
+            if (policy == eviction_policy::kAllKeysRandom)
+                return sample().key;
+
+            const entry *best = nullptr;
+            for (size_type i = 0; i != samples_; ++i) {
+                const entry &candidate = sample();
+                if (!best or better_victim(policy, candidate, *best))
+                    best = &candidate;
+            }
+
+            return best->key;
+        }
+
+    private:
+        struct entry {
+            key_type key;
+            size_type heap;
+            clock_type clock : 24;
+            clock_type counter : 8;
+            time_point deadline;
+            size_type expiring;     // its index in expiring_, kNotExpiring without a TTL
+        };
+
+        size_type samples_;
+        std::mt19937_64 random_;
+        clock_type clock_ = 0;
+
+        std::vector<entry> entries_;
+        std::vector<size_type> expiring_;   // rows of the entries with a deadline
+        std::unordered_map<key_type, size_type> rows_;
+        size_type heap_bytes_ = 0;
+
+        clock_type tick() noexcept {
+            clock_ = (clock_ + 1) & kClockMask;
+            return clock_;
+        }
+
+        [[nodiscard]] clock_type idle(const entry &e) const noexcept { return (clock_ - e.clock) & kClockMask; }
+
+        [[nodiscard]] clock_type decayed_counter(const entry &e) const noexcept {
+            const clock_type periods = idle(e) / kCounterDecayTicks;
+            return periods >= e.counter ? 0 : e.counter - periods;
+        }
+
+        // adds the row to expiring_ or takes it out, moving the last one into the hole
+        void set_expiring(size_type row, bool expiring) {
+            entry &e = entries_[row];
+            if (expiring == (e.expiring != kNotExpiring))
+                return;
+
+            if (expiring) {
+                e.expiring = expiring_.size();
+                expiring_.push_back(row);
+                return;
+            }
+
+            const size_type slot = e.expiring, last = expiring_.size() - 1;
+            if (slot != last) {
+                expiring_[slot] = expiring_[last];
+                entries_[expiring_[slot]].expiring = slot;
+            }
+            expiring_.pop_back();
+            e.expiring = kNotExpiring;
+        }
+
+        void touch(entry &e) {
+            clock_type counter = decayed_counter(e);
+            if (counter < kCounterMax) {
+                const double base = counter > kCounterInit ? counter - kCounterInit : 0;
+                if (std::uniform_real_distribution<double>(0.0, 1.0)(random_) < 1.0 / (base * kCounterLogFactor + 1))
+                    ++counter;
+            }
+
+            e.counter = counter;
+            e.clock = tick();
+        }
+
+        bool better_victim(eviction_policy policy, const entry &lhs, const entry &rhs) const noexcept {
+            switch (policy) {
+                case eviction_policy::kAllKeysLfu:  return decayed_counter(lhs) < decayed_counter(rhs);
+                case eviction_policy::kVolatileTtl: return lhs.deadline < rhs.deadline;
+                default:                            return idle(lhs) > idle(rhs);
+            }
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_EVICTION_H
@@ -1,42 +1,57 @@
 #ifndef TRANSACTIONS_LIBRARY_CPP_FUNCTIONS_H
 #define TRANSACTIONS_LIBRARY_CPP_FUNCTIONS_H
 
+#include <algorithm>
 #include <chrono>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "engine_traits.h"
 
 namespace ttl {
     class Functions {
     public:
+        /*
+         * One quick timing of `choice` over `tests_count` keys, for the
+         * interactive comparison. Keys are 0..n in a shuffled order so the
+         * trees don't get the sorted-insert best case. For repeatable
+         * numbers use the storage benchmarks (make benchmarks).
+         */
         template<typename AssociativeContainer>
-        static double Execute(std::size_t choice, std::size_t tests_count, AssociativeContainer storage) {
+        static double Execute(std::size_t choice, std::size_t tests_count, AssociativeContainer &storage) {
             using key_type = typename AssociativeContainer::key_type;
-            using mapped_type = typename AssociativeContainer::mapped_type;
 
-            if constexpr (std::is_same_v<AssociativeContainer, unordered_map<key_type, mapped_type>>)
+            if constexpr (engine_traits<AssociativeContainer>::kReservable)
                 storage.reserve(tests_count);
 
+            std::vector<key_type> keys(tests_count);
+            std::iota(keys.begin(), keys.end(), key_type{});
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
             if (choice == 1) { // SET
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i)
+                    for (key_type i : keys)
                         storage.insert({i, i});
                 });
             }
 
             if (choice == 2) { // GET
-                for (std::size_t i = 0; i != tests_count; ++i)
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i)
+                    for (key_type i : keys)
                         storage[i];
                 });
             }
 
             if (choice == 3) { // EXISTS
-                for (std::size_t i = 0; i != tests_count; ++i)
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i) {
+                    for (key_type i : keys) {
                         if (storage.find(i) == storage.end())
                             storage[i] = i;
                     }
@@ -44,31 +59,31 @@ namespace ttl {
             }
 
             if (choice == 4) { // DEL
-                for (std::size_t i = 0; i != tests_count; ++i)
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i)
+                    for (key_type i : keys)
                         storage.erase(storage.find(i));
                 });
             }
 
             if (choice == 5) { // UPDATE
-                for (std::size_t i = 0; i != tests_count; ++i)
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i)
+                    for (key_type i : keys)
                         storage[i] = i;
                 });
             }
 
             if (choice == 6) { // RENAME
-                for (std::size_t i = 0; i != tests_count; ++i)
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i) {
+                    for (key_type i : keys) {
                         if (storage.find(i) == storage.end())
                             continue;
 
@@ -79,15 +94,16 @@ namespace ttl {
                 });
             }
 
-            if (choice == 7) { // EXISTS
-                for (std::size_t i = 0; i != tests_count; ++i)
+            if (choice == 7) { // FIND: one pass over every value, as FIND scans the whole storage
+                for (key_type i : keys)
                     storage.insert({i, i});
 
                 return getTime([&]() {
-                    for (std::size_t i = 0; i != tests_count; ++i) {
-                        if (storage.find(i) == storage.end())
-                            storage[i] = i;
-                    }
+                    std::size_t found = 0;
+                    for (const auto &[key, value] : storage)
+                        found += value % 7 == 0;
+                    volatile std::size_t sink = found;
+                    (void)sink;
                 });
             }
 
@@ -98,9 +114,9 @@ namespace ttl {
         template<typename Functor>
         static double getTime(Functor functor) {
             using namespace std::chrono;
-            auto begin = high_resolution_clock::now();
+            auto begin = steady_clock::now();
             functor();
-            auto end = high_resolution_clock::now();
+            auto end = steady_clock::now();
             return duration_cast<microseconds>(end - begin).count() / 1000.0;
         }
     };
@@ -0,0 +1,37 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_GLOB_H
+#define TRANSACTIONS_LIBRARY_CPP_GLOB_H
+
+#include <string_view>
+
+namespace ttl {
+    /*
+     * Glob match used by MATCH options: '*' matches any run of characters,
+     * '?' matches one character, everything else matches itself.
+     */
+    inline bool GlobMatch(std::string_view pattern, std::string_view text) {
+        std::size_t p = 0, t = 0;
+        std::size_t star = std::string_view::npos, resume = 0;
+
+        while (t != text.size()) {
+            if (p != pattern.size() and (pattern[p] == '?' or pattern[p] == text[t])) {
+                ++p;
+                ++t;
+            } else if (p != pattern.size() and pattern[p] == '*') {
+                star = p++;
+                resume = t;
+            } else if (star != std::string_view::npos) {
+                p = star + 1;
+                t = ++resume;
+            } else {
+                return false;
+            }
+        }
+
+        while (p != pattern.size() and pattern[p] == '*')
+            ++p;
+
+        return p == pattern.size();
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_GLOB_H
@@ -0,0 +1,65 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_KEY_VERSIONS_H
+#define TRANSACTIONS_LIBRARY_CPP_KEY_VERSIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ttl {
+    /*
+     * Write counters for the keys someone WATCHes. Only watched keys have
+     * an entry, so a write to any other key costs one empty() check or a
+     * failed lookup; an entry goes away when its last watcher leaves. A
+     * key is watched whether it is stored or not: creating it counts as a
+     * write too.
+     */
+    template <typename Key>
+    class key_versions {
+    public:
+        using key_type = Key;
+        using version_type = std::uint64_t;
+        using size_type = std::size_t;
+
+    private:
+        struct entry {
+            version_type version = 0;
+            size_type watchers = 0;
+        };
+
+        std::unordered_map<key_type, entry> entries_;
+
+    public:
+        // starts watching key and returns the version to compare against later
+        version_type watch(const key_type &key) {
+            entry &watched = entries_[key];
+            ++watched.watchers;
+            return watched.version;
+        }
+
+        void unwatch(const key_type &key) {
+            auto it = entries_.find(key);
+            if (it != entries_.end() and --it->second.watchers == 0)
+                entries_.erase(it);
+        }
+
+        // called on every write and erase of key
+        void touch(const key_type &key) {
+            if (entries_.empty())
+                return;
+
+            auto it = entries_.find(key);
+            if (it != entries_.end())
+                ++it->second.version;
+        }
+
+        [[nodiscard]] bool changed(const key_type &key, version_type seen) const {
+            auto it = entries_.find(key);
+            return it == entries_.end() or it->second.version != seen;
+        }
+
+        [[nodiscard]] size_type size() const noexcept { return entries_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_KEY_VERSIONS_H
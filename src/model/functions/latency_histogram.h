@@ -0,0 +1,102 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_LATENCY_HISTOGRAM_H
+#define TRANSACTIONS_LIBRARY_CPP_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace ttl {
+    /*
+     * HDR-style histogram of durations in nanoseconds: every power of two is
+     * split into kSubBuckets linear buckets, so any recorded value is
+     * reported within 1/kSubBuckets (about 3%) of itself. Recording is a
+     * count-leading-zeros and an increment; memory is fixed at ~9 KB.
+     */
+    class latency_histogram {
+    public:
+        using value_type = std::uint64_t;
+        using size_type = std::size_t;
+
+        static constexpr unsigned kSubBucketBits = 5;
+        static constexpr size_type kSubBuckets = size_type{1} << kSubBucketBits;
+        // values from 2^kMaxExponent ns (~18 minutes) up share the last bucket
+        static constexpr unsigned kMaxExponent = 40;
+        static constexpr size_type kBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    public:
+        void record(value_type nanoseconds) noexcept {
+            counts_[index(nanoseconds)]++;
+            count_++;
+            sum_ += nanoseconds;
+            min_ = std::min(min_, nanoseconds);
+            max_ = std::max(max_, nanoseconds);
+        }
+
+        void merge(const latency_histogram &other) noexcept {
+            for (size_type i = 0; i != kBuckets; ++i)
+                counts_[i] += other.counts_[i];
+            count_ += other.count_;
+            sum_ += other.sum_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        void reset() noexcept { *this = latency_histogram{}; }
+
+        [[nodiscard]] value_type count() const noexcept { return count_; }
+        [[nodiscard]] value_type sum() const noexcept { return sum_; }
+        [[nodiscard]] value_type min() const noexcept { return count_ ? min_ : 0; }
+        [[nodiscard]] value_type max() const noexcept { return max_; }
+        [[nodiscard]] double mean() const noexcept { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+        // smallest recorded value v such that `quantile` of the values are <= v, up to bucket precision
+        [[nodiscard]] value_type percentile(double quantile) const noexcept {
+            if (count_ == 0)
+                return 0;
+
+            const auto rank = static_cast<value_type>(std::max(1.0, quantile * static_cast<double>(count_) + 0.5));
+            value_type seen = 0;
+            for (size_type i = 0; i != kBuckets; ++i) {
+                seen += counts_[i];
+                if (seen >= rank)
+                    return std::clamp(upper_bound(i), min_, max_);
+            }
+            return max_;
+        }
+
+    private:
+        std::array<value_type, kBuckets> counts_ {};
+        value_type count_ = 0;
+        value_type sum_ = 0;
+        value_type min_ = std::numeric_limits<value_type>::max();
+        value_type max_ = 0;
+
+        static size_type index(value_type value) noexcept {
+            if (value < kSubBuckets)
+                return static_cast<size_type>(value);
+
+            const auto exponent = static_cast<unsigned>(63 - __builtin_clzll(value));
+            if (exponent >= kMaxExponent)
+                return kBuckets - 1;
+
+            const auto sub = static_cast<size_type>(value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+            return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+        }
+
+        // largest value that falls into bucket `i`
+        static value_type upper_bound(size_type i) noexcept {
+            if (i < kSubBuckets)
+                return static_cast<value_type>(i);
+            if (i == kBuckets - 1)
+                return std::numeric_limits<value_type>::max();
+
+            const auto exponent = static_cast<unsigned>(i / kSubBuckets) + kSubBucketBits - 1;
+            const auto sub = static_cast<value_type>(i % kSubBuckets);
+            const value_type width = value_type{1} << (exponent - kSubBucketBits);
+            return (value_type{1} << exponent) + sub * width + width - 1;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_LATENCY_HISTOGRAM_H
@@ -0,0 +1,90 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_MEMORY_USAGE_H
+#define TRANSACTIONS_LIBRARY_CPP_MEMORY_USAGE_H
+
+#include <cctype>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace ttl {
+    /*
+     * Bytes held by a storage, split by what holds them: the bucket array or
+     * other per-table bookkeeping, the nodes the entries live in, and the heap
+     * blocks the keys and values own (long strings and the like). payload is
+     * what the entries would need packed in an array with no engine around.
+     */
+    struct memory_stats {
+        std::size_t entries = 0;
+        std::size_t buckets = 0;
+
+        std::size_t table_bytes = 0;
+        std::size_t node_bytes = 0;
+        std::size_t heap_bytes = 0;
+        std::size_t payload_bytes = 0;
+
+        [[nodiscard]] std::size_t total() const noexcept { return table_bytes + node_bytes + heap_bytes; }
+
+        [[nodiscard]] double bytes_per_entry() const noexcept {
+            return entries ? static_cast<double>(total()) / static_cast<double>(entries) : 0.0;
+        }
+
+        // total / payload, 1.0 means the engine costs nothing on top of the data
+        [[nodiscard]] double overhead_ratio() const noexcept {
+            return payload_bytes ? static_cast<double>(total()) / static_cast<double>(payload_bytes) : 0.0;
+        }
+
+        [[nodiscard]] double load_factor() const noexcept {
+            return buckets ? static_cast<double>(entries) / static_cast<double>(buckets) : 0.0;
+        }
+    };
+
+    /*
+     * Heap bytes owned by a value beyond sizeof(value). Types that own heap
+     * memory overload heap_size next to their definition so that ADL finds it.
+     */
+    template <typename T>
+    std::size_t heap_size(const T &) noexcept { return 0; }
+
+    inline std::size_t heap_size(const std::string &value) noexcept {
+        static const std::size_t kInlineCapacity = std::string().capacity();
+        return value.capacity() > kInlineCapacity ? value.capacity() + 1 : 0;
+    }
+
+    template <typename First, typename Second>
+    std::size_t heap_size(const std::pair<First, Second> &value) noexcept {
+        return heap_size(value.first) + heap_size(value.second);
+    }
+
+    // "1024", "64kb", "100mb", "2gb" (any case) to bytes; nullopt when malformed
+    inline std::optional<std::size_t> parse_memory_size(const std::string &text) {
+        std::size_t digits = 0, value = 0;
+        for (; digits != text.size() and std::isdigit(static_cast<unsigned char>(text[digits])); ++digits)
+            value = value * 10 + static_cast<std::size_t>(text[digits] - '0');
+        if (digits == 0)
+            return std::nullopt;
+
+        std::string unit;
+        for (std::size_t i = digits; i != text.size(); ++i)
+            unit += static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+
+        if (unit.empty() or unit == "b") return value;
+        if (unit == "kb") return value << 10;
+        if (unit == "mb") return value << 20;
+        if (unit == "gb") return value << 30;
+        return std::nullopt;
+    }
+
+    namespace detail {
+        // a malloc'd block of `size` bytes, rounded the way glibc does (16 bytes, one word of header)
+        inline constexpr std::size_t allocation_size(std::size_t size) noexcept {
+            if (size == 0)
+                return 0;
+
+            constexpr std::size_t kAlignment = 16, kHeader = sizeof(std::size_t);
+            return (size + kHeader + kAlignment - 1) / kAlignment * kAlignment;
+        }
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_MEMORY_USAGE_H
@@ -0,0 +1,139 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_SCAN_EXECUTOR_H
+#define TRANSACTIONS_LIBRARY_CPP_SCAN_EXECUTOR_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "engine_traits.h"
+
+namespace ttl {
+    /*
+     * Fixed pool of workers for read-only full scans. A storage that provides
+     * split(parts) is cut into iterator ranges; every range is mapped on some
+     * worker (the calling thread helps too) and results come back in range
+     * order, so ordered storages keep their order after the merge.
+     */
+    class ScanExecutor {
+    public:
+        static constexpr std::size_t kMinParallelSize = 1 << 14;
+        static constexpr std::size_t kPartsPerThread = 4;
+
+        explicit ScanExecutor(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+            : threads_(std::max<std::size_t>(1, threads)) {
+            for (std::size_t i = 1; i < threads_; ++i)
+                workers_.emplace_back([this] { Loop(); });
+        }
+
+        ScanExecutor(const ScanExecutor &) = delete;
+        ScanExecutor &operator=(const ScanExecutor &) = delete;
+
+        ~ScanExecutor() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+
+            for (auto &worker : workers_)
+                worker.join();
+        }
+
+        [[nodiscard]] std::size_t threads() const noexcept { return threads_; }
+
+        template <typename Container, typename Functor>
+        auto Map(Container &storage, Functor functor) {
+            using iterator = decltype(storage.begin());
+            using result_type = std::invoke_result_t<Functor &, iterator, iterator>;
+
+            std::vector<std::pair<iterator, iterator>> ranges;
+            if constexpr (detail::has_split<Container>::value)
+                if (threads_ > 1 and storage.size() >= kMinParallelSize)
+                    ranges = storage.split(threads_ * kPartsPerThread);
+
+            if (ranges.empty())
+                ranges.emplace_back(storage.begin(), storage.end());
+
+            std::vector<result_type> results(ranges.size());
+            Run(ranges.size(), [&](std::size_t index) {
+                results[index] = functor(ranges[index].first, ranges[index].second);
+            });
+
+            return results;
+        }
+
+        // runs task(0) .. task(tasks - 1) across the pool, the calling thread included
+        template <typename Functor>
+        void ForEach(std::size_t tasks, Functor functor) {
+            const std::function<void(std::size_t)> task = std::ref(functor);
+            Run(tasks, task);
+        }
+
+    private:
+        std::size_t threads_;
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable finished_;
+
+        const std::function<void(std::size_t)> *task_ = nullptr;
+        std::size_t tasks_ = 0, next_ = 0, done_ = 0;
+        std::size_t generation_ = 0;
+        bool stop_ = false;
+
+        void Run(std::size_t tasks, const std::function<void(std::size_t)> &task) {
+            if (workers_.empty() or tasks < 2) {
+                for (std::size_t i = 0; i != tasks; ++i)
+                    task(i);
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_ = &task;
+            tasks_ = tasks;
+            next_ = done_ = 0;
+            ++generation_;
+            wake_.notify_all();
+
+            Drain(lock);
+            finished_.wait(lock, [this] { return done_ == tasks_; });
+            task_ = nullptr;
+        }
+
+        void Drain(std::unique_lock<std::mutex> &lock) {
+            while (next_ != tasks_) {
+                std::size_t index = next_++;
+                const auto *task = task_;
+
+                lock.unlock();
+                (*task)(index);
+                lock.lock();
+
+                if (++done_ == tasks_)
+                    finished_.notify_all();
+            }
+        }
+
+        void Loop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            std::size_t seen = generation_;
+
+            while (true) {
+                wake_.wait(lock, [&] { return stop_ or generation_ != seen; });
+                if (stop_)
+                    return;
+
+                seen = generation_;
+                Drain(lock);
+            }
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_SCAN_EXECUTOR_H
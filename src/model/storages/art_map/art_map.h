@@ -0,0 +1,621 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ART_MAP_H
+#define TRANSACTIONS_LIBRARY_CPP_ART_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "engine_stats.h"
+#include "memory_usage.h"
+#include "map_cursor.h"
+#include "art_map_iterator.h"
+#include "art_map_node.h"
+
+namespace ttl {
+    /*
+     * Adaptive radix tree over string keys, with the ordered interface of
+     * map (lower_bound/upper_bound/equal_range, in-order iteration, scan
+     * and split), so RANGE, PREFIX, KEYS and SCAN work on it unchanged.
+     *
+     * A lookup walks one node per distinct key byte instead of comparing
+     * whole keys on O(log n) nodes, and keys sharing a prefix share the
+     * nodes for it. Inner nodes come in four sizes (4, 16, 48 and 256
+     * children) and grow or shrink with their fan-out; a run of nodes with
+     * a single child is compressed into the prefix of the node below, and
+     * a subtree with one key is just its leaf.
+     *
+     * Keys are ordered byte by byte as unsigned char, shorter first, which
+     * is std::less<std::string>. Leaves are threaded in that order, so
+     * iterator steps are a single pointer load. References stay valid until
+     * the entry is erased; iterators too, except for the erased one.
+     */
+    template <typename Key, typename Value>
+    class art_map {
+        static_assert(std::is_same_v<Key, std::string>, "art_map orders keys by their bytes: Key must be std::string");
+
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using size_type = std::size_t;
+        using cursor_type = map_cursor<key_type>;
+
+    private:
+        using leaf_type = detail::art_leaf<value_type>;
+        using leaf_pointer = leaf_type *;
+        using node_pointer = detail::art_node *;
+        using inner_pointer = detail::art_inner *;
+
+    public:
+        using iterator = art_map_iterator<leaf_type, value_type>;
+        using const_iterator = art_map_iterator<const leaf_type, const value_type>;
+
+    public:
+        art_map() = default;
+
+        art_map(const art_map &other) {
+            if (other.root_)
+                root_ = clone(other.root_);
+            size_ = other.size_;
+        }
+
+        art_map(art_map &&other) noexcept { swap(other); }
+
+        art_map &operator=(const art_map &other) {
+            if (this != &other) {
+                art_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        art_map &operator=(art_map &&other) noexcept {
+            if (this != &other) {
+                art_map moved(std::move(other));
+                swap(moved);
+            }
+            return *this;
+        }
+
+        ~art_map() { release(root_); }
+
+        void swap(art_map &other) noexcept {
+            std::swap(root_, other.root_);
+            std::swap(head_, other.head_);
+            std::swap(tail_, other.tail_);
+            std::swap(size_, other.size_);
+            std::swap(inner_bytes_, other.inner_bytes_);
+            std::swap(stats_, other.stats_);
+        }
+
+    public:
+        [[nodiscard]] size_type size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == size_type{}; }
+
+        [[nodiscard]] const engine_stats &stats() const noexcept { return stats_; }
+        void reset_stats() noexcept { stats_ = engine_stats{}; }
+
+        /*
+         * Inner nodes are the table part and are kept as a running total, so
+         * only the heap walk of the entries depends on `with_heap`. Compressed
+         * prefixes too long for the string's inline buffer aren't counted.
+         */
+        [[nodiscard]] memory_stats memory(bool with_heap = true) const {
+            memory_stats stats;
+            stats.entries = size_;
+            stats.table_bytes = sizeof(*this) + static_cast<std::size_t>(inner_bytes_);
+            stats.node_bytes = size_ * detail::allocation_size(sizeof(leaf_type));
+
+            if (with_heap)
+                for (const auto &kv : *this)
+                    stats.heap_bytes += heap_size(kv);
+            stats.payload_bytes = size_ * sizeof(value_type) + stats.heap_bytes;
+            return stats;
+        }
+
+    public:
+        iterator begin() noexcept { return iterator(head_); }
+        const_iterator begin() const noexcept { return const_iterator(head_); }
+
+        iterator end() noexcept { return iterator(); }
+        const_iterator end() const noexcept { return const_iterator(); }
+
+        /*
+         * Cuts the keys into at most `parts` consecutive iterator ranges. The
+         * boundaries are the first keys of the subtrees on the shallowest
+         * level of the tree with at least `parts` of them.
+         */
+        std::vector<std::pair<iterator, iterator>> split(size_type parts) {
+            std::vector<std::pair<iterator, iterator>> ranges;
+            if (parts == 0 or empty())
+                return ranges;
+
+            std::vector<node_pointer> level {root_}, next;
+            for (bool expanded = true; level.size() < parts and expanded; level.swap(next)) {
+                expanded = false;
+                next.clear();
+                for (node_pointer node : level) {
+                    if (node->is_leaf()) {
+                        next.push_back(node);
+                        continue;
+                    }
+
+                    expanded = true;
+                    for_each_child(static_cast<inner_pointer>(node), [&](node_pointer child) { next.push_back(child); });
+                }
+            }
+
+            iterator first = begin();
+            for (size_type part = 1; part <= parts; ++part) {
+                iterator last = end();
+                if (part != parts)
+                    last = iterator(min_leaf(level[level.size() * part / parts]));
+
+                if (first != last)
+                    ranges.emplace_back(first, last);
+                first = last;
+            }
+
+            return ranges;
+        }
+
+    public:
+        std::pair<iterator, bool> insert(const value_type &kv) { return emplace_key(kv.first, kv.second); }
+        std::pair<iterator, bool> insert(value_type &&kv) { return emplace_key(kv.first, std::move(kv.second)); }
+
+        // like std::map::try_emplace: the key is copied and the value built only when the key is new
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        mapped_type &operator[](const key_type &key) { return emplace_key(key).first->second; }
+        mapped_type &operator[](key_type &&key) { return emplace_key(std::move(key)).first->second; }
+
+        bool erase(const key_type &key) {
+            if (!root_)
+                return false;
+
+            const size_type probes_before = stats_.lookup();
+            leaf_pointer leaf = erase_at(root_, 0, key);
+            if (!leaf)
+                return false;
+
+            stats_.hit(probes_before);
+            unlink(leaf);
+            delete leaf;
+            size_--;
+            stats_.erases++;
+            return true;
+        }
+
+        bool erase(iterator it) { return it != end() and erase(it->first); }
+
+        iterator find(const key_type &key) { return iterator(find_leaf(key)); }
+
+        // first entry whose key is not less than `key`
+        iterator lower_bound(const key_type &key) { return iterator(lower_bound_leaf(key)); }
+        const_iterator lower_bound(const key_type &key) const { return const_iterator(lower_bound_leaf(key)); }
+
+        // first entry whose key is greater than `key`
+        iterator upper_bound(const key_type &key) { return iterator(upper_bound_leaf(key)); }
+        const_iterator upper_bound(const key_type &key) const { return const_iterator(upper_bound_leaf(key)); }
+
+        std::pair<iterator, iterator> equal_range(const key_type &key) {
+            return std::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return std::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        /*
+         * Calls functor for up to `count` entries following the cursor in key
+         * order and returns the cursor to continue from (see map_cursor).
+         */
+        template <typename Functor>
+        cursor_type scan(const cursor_type &cursor, size_type count, Functor functor) {
+            if (empty())
+                return cursor_type{};
+
+            iterator it = cursor.after ? upper_bound(*cursor.after) : begin();
+            cursor_type next = cursor;
+            for (size_type visited = 0; it != end() and visited != count; ++it, ++visited) {
+                functor(*it);
+                next.after = it->first;
+            }
+
+            return it != end() ? next : cursor_type{};
+        }
+
+    private:
+        node_pointer root_ = nullptr;
+        leaf_pointer head_ = nullptr, tail_ = nullptr;
+        size_type size_ = 0;
+        std::ptrdiff_t inner_bytes_ = 0;
+
+        engine_stats stats_;
+
+        static std::uint8_t byte_at(const key_type &key, size_type index) noexcept {
+            return static_cast<std::uint8_t>(key[index]);
+        }
+
+        // bytes of the node's prefix that `key` matches from `depth` on
+        static size_type match_prefix(const detail::art_inner *node, const key_type &key, size_type depth) noexcept {
+            size_type matched = 0;
+            while (matched != node->prefix.size() and depth + matched != key.size() and
+                   key[depth + matched] == node->prefix[matched])
+                ++matched;
+            return matched;
+        }
+
+        template <typename K, typename... Args>
+        leaf_pointer make_leaf(K &&key, Args &&...args) {
+            size_++;
+            stats_.inserts++;
+            return new leaf_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        // hangs `leaf` under `node`, as its terminal if its key ends at `depth`
+        void attach(node_pointer &node, leaf_pointer leaf, size_type depth) {
+            const key_type &key = leaf->kv.first;
+            if (depth == key.size())
+                static_cast<inner_pointer>(node)->terminal = leaf;
+            else
+                inner_bytes_ += detail::art_add_child(node, byte_at(key, depth), leaf);
+        }
+
+        /*
+         * A new key lands in one of four places, and each of them knows its
+         * neighbours in key order without another descent: next to the leaf
+         * it splits, before or after the subtree whose prefix it splits, or
+         * between the siblings around its byte in the node it joins.
+         */
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> emplace_key(K &&key, Args &&...args) {
+            const size_type probes_before = stats_.lookup();
+            if (!root_) {
+                leaf_pointer leaf = make_leaf(std::forward<K>(key), std::forward<Args>(args)...);
+                root_ = leaf;
+                link_before(leaf, nullptr);
+                return std::make_pair(iterator(leaf), true);
+            }
+
+            node_pointer *slot = &root_;
+            for (size_type depth = 0;; ++depth) {
+                stats_.probes++;
+
+                if ((*slot)->is_leaf()) {
+                    auto existing = static_cast<leaf_pointer>(*slot);
+                    const key_type &other = existing->kv.first;
+                    if (other == key) {
+                        stats_.hit(probes_before);
+                        return std::make_pair(iterator(existing), false);
+                    }
+
+                    size_type common = depth;
+                    while (common != key.size() and common != other.size() and key[common] == other[common])
+                        ++common;
+
+                    const bool before = key < other;
+                    auto *split = new detail::art_node4;
+                    inner_bytes_ += detail::art_node_bytes(split->type);
+                    split->prefix.assign(key, depth, common - depth);
+
+                    leaf_pointer leaf = make_leaf(std::forward<K>(key), std::forward<Args>(args)...);
+                    node_pointer node = split;
+                    attach(node, existing, common);
+                    attach(node, leaf, common);
+                    *slot = node;
+
+                    link_before(leaf, before ? existing : existing->next);
+                    return std::make_pair(iterator(leaf), true);
+                }
+
+                auto inner = static_cast<inner_pointer>(*slot);
+                const size_type matched = match_prefix(inner, key, depth);
+                if (matched != inner->prefix.size()) {
+                    const std::uint8_t old_byte = static_cast<std::uint8_t>(inner->prefix[matched]);
+                    const bool before = depth + matched == key.size() or byte_at(key, depth + matched) < old_byte;
+
+                    auto *split = new detail::art_node4;
+                    inner_bytes_ += detail::art_node_bytes(split->type);
+                    split->prefix.assign(inner->prefix, 0, matched);
+                    inner->prefix.erase(0, matched + 1);
+
+                    leaf_pointer leaf = make_leaf(std::forward<K>(key), std::forward<Args>(args)...);
+                    node_pointer node = split;
+                    inner_bytes_ += detail::art_add_child(node, old_byte, inner);
+                    attach(node, leaf, depth + matched);
+                    *slot = node;
+
+                    link_before(leaf, before ? min_leaf(inner) : max_leaf(inner)->next);
+                    return std::make_pair(iterator(leaf), true);
+                }
+
+                depth += matched;
+                if (depth == key.size()) {
+                    if (inner->terminal) {
+                        stats_.hit(probes_before);
+                        return std::make_pair(iterator(static_cast<leaf_pointer>(inner->terminal)), false);
+                    }
+
+                    // a node without a terminal has at least two children
+                    leaf_pointer leaf = make_leaf(std::forward<K>(key), std::forward<Args>(args)...);
+                    inner->terminal = leaf;
+                    link_before(leaf, min_leaf(detail::art_child_from(inner, 0)));
+                    return std::make_pair(iterator(leaf), true);
+                }
+
+                const std::uint8_t byte = byte_at(key, depth);
+                if (node_pointer *child = detail::art_find_child(inner, byte)) {
+                    slot = child;
+                    continue;
+                }
+
+                leaf_pointer next = nullptr;
+                if (node_pointer after = detail::art_child_from(inner, byte + 1u)) {
+                    next = min_leaf(after);
+                } else {
+                    node_pointer prior = detail::art_child_before(inner, byte);
+                    next = (prior ? max_leaf(prior) : static_cast<leaf_pointer>(inner->terminal))->next;
+                }
+
+                leaf_pointer leaf = make_leaf(std::forward<K>(key), std::forward<Args>(args)...);
+                inner_bytes_ += detail::art_add_child(*slot, byte, leaf);
+                link_before(leaf, next);
+                return std::make_pair(iterator(leaf), true);
+            }
+        }
+
+        leaf_pointer find_leaf(const key_type &key) {
+            const size_type probes_before = stats_.lookup();
+
+            node_pointer node = root_;
+            for (size_type depth = 0; node != nullptr; ++depth) {
+                stats_.probes++;
+
+                if (node->is_leaf()) {
+                    auto leaf = static_cast<leaf_pointer>(node);
+                    if (leaf->kv.first != key)
+                        return nullptr;
+
+                    stats_.hit(probes_before);
+                    return leaf;
+                }
+
+                auto inner = static_cast<inner_pointer>(node);
+                if (key.compare(depth, inner->prefix.size(), inner->prefix) != 0)
+                    return nullptr;
+
+                depth += inner->prefix.size();
+                if (depth == key.size()) {
+                    node = inner->terminal;
+                    continue;
+                }
+
+                node_pointer *child = detail::art_find_child(inner, byte_at(key, depth));
+                node = child ? *child : nullptr;
+            }
+
+            return nullptr;
+        }
+
+        /*
+         * Descends along `key`; once the key leaves the tree, the bound is the
+         * first leaf of the next subtree, or the leaf after the last one of
+         * the subtree that is entirely smaller.
+         */
+        leaf_pointer lower_bound_leaf(const key_type &key) const {
+            node_pointer node = root_;
+            for (size_type depth = 0; node != nullptr; ++depth) {
+                if (node->is_leaf()) {
+                    auto leaf = static_cast<leaf_pointer>(node);
+                    return leaf->kv.first < key ? leaf->next : leaf;
+                }
+
+                auto inner = static_cast<inner_pointer>(node);
+                for (size_type i = 0; i != inner->prefix.size(); ++i, ++depth) {
+                    if (depth == key.size())
+                        return min_leaf(inner);
+
+                    const std::uint8_t byte = byte_at(key, depth);
+                    const auto prefix_byte = static_cast<std::uint8_t>(inner->prefix[i]);
+                    if (byte != prefix_byte)
+                        return byte < prefix_byte ? min_leaf(inner) : max_leaf(inner)->next;
+                }
+
+                if (depth == key.size())
+                    return min_leaf(inner);
+
+                const std::uint8_t byte = byte_at(key, depth);
+                if (node_pointer *child = detail::art_find_child(inner, byte)) {
+                    node = *child;
+                    continue;
+                }
+
+                node_pointer after = detail::art_child_from(inner, byte + 1u);
+                return after ? min_leaf(after) : max_leaf(inner)->next;
+            }
+
+            return nullptr;
+        }
+
+        leaf_pointer upper_bound_leaf(const key_type &key) const {
+            leaf_pointer leaf = lower_bound_leaf(key);
+            return leaf and leaf->kv.first == key ? leaf->next : leaf;
+        }
+
+        /*
+         * Removes the leaf with `key` from the subtree in `slot` and returns
+         * it, or null when there is none. On the way back up, nodes shrink
+         * to a smaller size, a node left with one child merges into it and a
+         * node left with only its terminal is replaced by the leaf.
+         */
+        leaf_pointer erase_at(node_pointer &slot, size_type depth, const key_type &key) {
+            stats_.probes++;
+            if (slot->is_leaf()) {
+                auto leaf = static_cast<leaf_pointer>(slot);
+                if (leaf->kv.first != key)
+                    return nullptr;
+
+                slot = nullptr;
+                return leaf;
+            }
+
+            auto inner = static_cast<inner_pointer>(slot);
+            if (key.compare(depth, inner->prefix.size(), inner->prefix) != 0)
+                return nullptr;
+
+            depth += inner->prefix.size();
+            leaf_pointer removed = nullptr;
+            if (depth == key.size()) {
+                removed = static_cast<leaf_pointer>(inner->terminal);
+                if (!removed)
+                    return nullptr;
+                inner->terminal = nullptr;
+            } else {
+                const std::uint8_t byte = byte_at(key, depth);
+                node_pointer *child = detail::art_find_child(inner, byte);
+                if (!child)
+                    return nullptr;
+
+                removed = erase_at(*child, depth + 1, key);
+                if (!removed)
+                    return nullptr;
+
+                if (*child == nullptr)
+                    inner_bytes_ -= detail::art_remove_child(slot, byte);
+            }
+
+            collapse(slot);
+            return removed;
+        }
+
+        void collapse(node_pointer &slot) {
+            auto inner = static_cast<inner_pointer>(slot);
+            if (inner->count == 0) {
+                slot = inner->terminal;
+            } else if (inner->count == 1 and !inner->terminal) {
+                unsigned byte = 0;
+                node_pointer child = detail::art_child_from(inner, 0, &byte);
+                if (!child->is_leaf()) {
+                    auto below = static_cast<inner_pointer>(child);
+                    below->prefix.insert(0, 1, static_cast<char>(byte));
+                    below->prefix.insert(0, inner->prefix);
+                }
+                slot = child;
+            } else {
+                return;
+            }
+
+            inner_bytes_ -= detail::art_node_bytes(inner->type);
+            detail::art_delete_inner(inner);
+        }
+
+        static leaf_pointer min_leaf(node_pointer node) noexcept {
+            while (!node->is_leaf()) {
+                auto inner = static_cast<inner_pointer>(node);
+                node = inner->terminal ? inner->terminal : detail::art_child_from(inner, 0);
+            }
+            return static_cast<leaf_pointer>(node);
+        }
+
+        static leaf_pointer max_leaf(node_pointer node) noexcept {
+            while (!node->is_leaf()) {
+                auto inner = static_cast<inner_pointer>(node);
+                node_pointer last = detail::art_child_before(inner, 256);
+                node = last ? last : inner->terminal;
+            }
+            return static_cast<leaf_pointer>(node);
+        }
+
+        // calls functor with the terminal, then every child, in key order
+        template <typename Functor>
+        static void for_each_child(const detail::art_inner *node, Functor functor) {
+            if (node->terminal)
+                functor(node->terminal);
+
+            unsigned byte = 0;
+            for (node_pointer child = detail::art_child_from(node, 0, &byte); child != nullptr;
+                 child = byte == 255 ? nullptr : detail::art_child_from(node, byte + 1, &byte))
+                functor(child);
+        }
+
+        // `next` null links at the tail
+        void link_before(leaf_pointer leaf, leaf_pointer next) noexcept {
+            leaf->next = next;
+            leaf->prev = next ? next->prev : tail_;
+            (leaf->prev ? leaf->prev->next : head_) = leaf;
+            (next ? next->prev : tail_) = leaf;
+        }
+
+        void unlink(leaf_pointer leaf) noexcept {
+            (leaf->prev ? leaf->prev->next : head_) = leaf->next;
+            (leaf->next ? leaf->next->prev : tail_) = leaf->prev;
+        }
+
+        // copies the subtree, appending its leaves to the list in key order
+        node_pointer clone(const detail::art_node *node) {
+            if (node->is_leaf()) {
+                auto leaf = new leaf_type(static_cast<const leaf_type *>(node)->kv);
+                link_before(leaf, nullptr);
+                return leaf;
+            }
+
+            inner_pointer copy = nullptr;
+            switch (node->type) {
+                case detail::art_node_type::kNode4:
+                    copy = new detail::art_node4(*static_cast<const detail::art_node4 *>(node));
+                    break;
+                case detail::art_node_type::kNode16:
+                    copy = new detail::art_node16(*static_cast<const detail::art_node16 *>(node));
+                    break;
+                case detail::art_node_type::kNode48:
+                    copy = new detail::art_node48(*static_cast<const detail::art_node48 *>(node));
+                    break;
+                default:
+                    copy = new detail::art_node256(*static_cast<const detail::art_node256 *>(node));
+                    break;
+            }
+            inner_bytes_ += detail::art_node_bytes(copy->type);
+
+            // the copy still points at the source's children, replace them in key order
+            if (copy->terminal)
+                copy->terminal = clone(copy->terminal);
+
+            unsigned byte = 0;
+            for (node_pointer child = detail::art_child_from(copy, 0, &byte); child != nullptr;
+                 child = byte == 255 ? nullptr : detail::art_child_from(copy, byte + 1, &byte))
+                *detail::art_find_child(copy, static_cast<std::uint8_t>(byte)) = clone(child);
+
+            return copy;
+        }
+
+        void release(node_pointer node) noexcept {
+            if (!node)
+                return;
+
+            if (node->is_leaf()) {
+                delete static_cast<leaf_pointer>(node);
+                return;
+            }
+
+            auto inner = static_cast<inner_pointer>(node);
+            for_each_child(inner, [this](node_pointer child) { release(child); });
+            detail::art_delete_inner(inner);
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ART_MAP_H
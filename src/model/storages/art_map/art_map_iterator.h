@@ -0,0 +1,59 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ART_MAP_ITERATOR_H
+#define TRANSACTIONS_LIBRARY_CPP_ART_MAP_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace ttl {
+    // walks the threaded leaves; like map's iterator, decrementing end() stays at end()
+    template <typename Leaf, typename Value>
+    class art_map_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::remove_const_t<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        art_map_iterator() = default;
+        explicit art_map_iterator(Leaf *leaf) noexcept : leaf_(leaf) {}
+
+        reference operator*() const { return leaf_->kv; }
+        pointer operator->() const { return &leaf_->kv; }
+
+        art_map_iterator &operator++() {
+            if (leaf_)
+                leaf_ = leaf_->next;
+            return *this;
+        }
+
+        art_map_iterator operator++(int) {
+            art_map_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        art_map_iterator &operator--() {
+            if (leaf_)
+                leaf_ = leaf_->prev;
+            return *this;
+        }
+
+        art_map_iterator operator--(int) {
+            art_map_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        Leaf *leaf() const noexcept { return leaf_; }
+
+        bool operator==(const art_map_iterator &other) const { return leaf_ == other.leaf_; }
+        bool operator!=(const art_map_iterator &other) const { return !(*this == other); }
+
+    private:
+        Leaf *leaf_ = nullptr;
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ART_MAP_ITERATOR_H
@@ -0,0 +1,416 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ART_MAP_NODE_H
+#define TRANSACTIONS_LIBRARY_CPP_ART_MAP_NODE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "memory_usage.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ttl::detail {
+    enum class art_node_type : std::uint8_t {
+        kLeaf,
+        kNode4,
+        kNode16,
+        kNode48,
+        kNode256
+    };
+
+    struct art_node {
+        explicit art_node(art_node_type node_type) noexcept : type(node_type) {}
+
+        art_node_type type;
+
+        [[nodiscard]] bool is_leaf() const noexcept { return type == art_node_type::kLeaf; }
+    };
+
+    /*
+     * One entry. Leaves carry the whole key (lazy expansion: a leaf hangs
+     * as high in the tree as its key is unique) and are threaded in key
+     * order, so iterator steps are a single pointer load.
+     */
+    template <typename Value>
+    struct art_leaf : art_node {
+        template <typename... Args>
+        explicit art_leaf(Args &&...args) : art_node(art_node_type::kLeaf), kv(std::forward<Args>(args)...) {}
+
+        Value kv;
+        art_leaf *prev = nullptr;
+        art_leaf *next = nullptr;
+    };
+
+    /*
+     * Common part of the four inner node sizes. `prefix` is the compressed
+     * path below the parent's byte (pessimistic path compression: all of
+     * it is stored, short prefixes stay in the string's inline buffer).
+     * `terminal` is the leaf whose key ends exactly at this node, which is
+     * how a key that is a prefix of other keys is kept; it sorts before
+     * every child.
+     */
+    struct art_inner : art_node {
+        explicit art_inner(art_node_type node_type) noexcept : art_node(node_type) {}
+
+        std::uint16_t count = 0;
+        std::string prefix;
+        art_node *terminal = nullptr;
+    };
+
+    // children sorted by key byte, found by a linear scan
+    struct art_node4 : art_inner {
+        static constexpr art_node_type kType = art_node_type::kNode4;
+        static constexpr std::uint16_t kCapacity = 4;
+
+        art_node4() noexcept : art_inner(art_node_type::kNode4) {}
+
+        std::uint8_t keys[kCapacity] = {};
+        art_node *children[kCapacity] = {};
+    };
+
+    // children sorted by key byte, found with one SSE2 compare where available
+    struct art_node16 : art_inner {
+        static constexpr art_node_type kType = art_node_type::kNode16;
+        static constexpr std::uint16_t kCapacity = 16;
+
+        art_node16() noexcept : art_inner(art_node_type::kNode16) {}
+
+        std::uint8_t keys[kCapacity] = {};
+        art_node *children[kCapacity] = {};
+    };
+
+    // a 256-entry byte -> slot + 1 index over 48 unordered child slots
+    struct art_node48 : art_inner {
+        static constexpr art_node_type kType = art_node_type::kNode48;
+        static constexpr std::uint16_t kCapacity = 48;
+
+        art_node48() noexcept : art_inner(art_node_type::kNode48) {}
+
+        std::uint8_t index[256] = {};
+        art_node *children[kCapacity] = {};
+    };
+
+    // a child pointer per byte value
+    struct art_node256 : art_inner {
+        static constexpr art_node_type kType = art_node_type::kNode256;
+        static constexpr std::uint16_t kCapacity = 256;
+
+        art_node256() noexcept : art_inner(art_node_type::kNode256) {}
+
+        art_node *children[kCapacity] = {};
+    };
+
+    // heap bytes of an inner node of `type`, see detail::allocation_size
+    inline std::ptrdiff_t art_node_bytes(art_node_type type) noexcept {
+        switch (type) {
+            case art_node_type::kNode4: return static_cast<std::ptrdiff_t>(allocation_size(sizeof(art_node4)));
+            case art_node_type::kNode16: return static_cast<std::ptrdiff_t>(allocation_size(sizeof(art_node16)));
+            case art_node_type::kNode48: return static_cast<std::ptrdiff_t>(allocation_size(sizeof(art_node48)));
+            case art_node_type::kNode256: return static_cast<std::ptrdiff_t>(allocation_size(sizeof(art_node256)));
+            default: return 0;
+        }
+    }
+
+    inline void art_delete_inner(art_inner *node) noexcept {
+        switch (node->type) {
+            case art_node_type::kNode4: delete static_cast<art_node4 *>(node); break;
+            case art_node_type::kNode16: delete static_cast<art_node16 *>(node); break;
+            case art_node_type::kNode48: delete static_cast<art_node48 *>(node); break;
+            case art_node_type::kNode256: delete static_cast<art_node256 *>(node); break;
+            default: break;
+        }
+    }
+
+    // slot holding the child for `byte`, or null
+    inline art_node **art_find_child(art_inner *node, std::uint8_t byte) noexcept {
+        switch (node->type) {
+            case art_node_type::kNode4: {
+                auto *n = static_cast<art_node4 *>(node);
+                for (std::uint16_t i = 0; i != n->count; ++i)
+                    if (n->keys[i] == byte)
+                        return &n->children[i];
+                return nullptr;
+            }
+            case art_node_type::kNode16: {
+                auto *n = static_cast<art_node16 *>(node);
+#if defined(__SSE2__)
+                const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys));
+                const __m128i match = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(byte)));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match)) & ((1u << n->count) - 1);
+                return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+                for (std::uint16_t i = 0; i != n->count; ++i)
+                    if (n->keys[i] == byte)
+                        return &n->children[i];
+                return nullptr;
+#endif
+            }
+            case art_node_type::kNode48: {
+                auto *n = static_cast<art_node48 *>(node);
+                return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+            }
+            case art_node_type::kNode256: {
+                auto *n = static_cast<art_node256 *>(node);
+                return n->children[byte] ? &n->children[byte] : nullptr;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    // child with the smallest key byte >= `from` (0..256) and that byte, or null
+    inline art_node *art_child_from(const art_inner *node, unsigned from, unsigned *byte = nullptr) noexcept {
+        switch (node->type) {
+            case art_node_type::kNode4:
+            case art_node_type::kNode16: {
+                const bool small = node->type == art_node_type::kNode4;
+                const std::uint8_t *keys = small ? static_cast<const art_node4 *>(node)->keys
+                                                 : static_cast<const art_node16 *>(node)->keys;
+                art_node *const *children = small ? static_cast<const art_node4 *>(node)->children
+                                                  : static_cast<const art_node16 *>(node)->children;
+                for (std::uint16_t i = 0; i != node->count; ++i) {
+                    if (keys[i] >= from) {
+                        if (byte) *byte = keys[i];
+                        return children[i];
+                    }
+                }
+                return nullptr;
+            }
+            case art_node_type::kNode48: {
+                auto *n = static_cast<const art_node48 *>(node);
+                for (unsigned b = from; b < 256; ++b) {
+                    if (n->index[b]) {
+                        if (byte) *byte = b;
+                        return n->children[n->index[b] - 1];
+                    }
+                }
+                return nullptr;
+            }
+            case art_node_type::kNode256: {
+                auto *n = static_cast<const art_node256 *>(node);
+                for (unsigned b = from; b < 256; ++b) {
+                    if (n->children[b]) {
+                        if (byte) *byte = b;
+                        return n->children[b];
+                    }
+                }
+                return nullptr;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    // child with the largest key byte < `before` (0..256), or null
+    inline art_node *art_child_before(const art_inner *node, unsigned before) noexcept {
+        switch (node->type) {
+            case art_node_type::kNode4:
+            case art_node_type::kNode16: {
+                const bool small = node->type == art_node_type::kNode4;
+                const std::uint8_t *keys = small ? static_cast<const art_node4 *>(node)->keys
+                                                 : static_cast<const art_node16 *>(node)->keys;
+                art_node *const *children = small ? static_cast<const art_node4 *>(node)->children
+                                                  : static_cast<const art_node16 *>(node)->children;
+                for (std::uint16_t i = node->count; i != 0; --i)
+                    if (keys[i - 1] < before)
+                        return children[i - 1];
+                return nullptr;
+            }
+            case art_node_type::kNode48: {
+                auto *n = static_cast<const art_node48 *>(node);
+                for (unsigned b = before; b != 0; --b)
+                    if (n->index[b - 1])
+                        return n->children[n->index[b - 1] - 1];
+                return nullptr;
+            }
+            case art_node_type::kNode256: {
+                auto *n = static_cast<const art_node256 *>(node);
+                for (unsigned b = before; b != 0; --b)
+                    if (n->children[b - 1])
+                        return n->children[b - 1];
+                return nullptr;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    template <typename From, typename To>
+    void art_move_header(From *from, To *to) {
+        to->prefix = std::move(from->prefix);
+        to->terminal = from->terminal;
+    }
+
+    /*
+     * Adds `child` under `byte` to the node in `slot`, first replacing the
+     * node by the next larger size when it is full. Returns the bytes the
+     * inner nodes grew by.
+     */
+    inline std::ptrdiff_t art_add_child(art_node *&slot, std::uint8_t byte, art_node *child) {
+        auto *node = static_cast<art_inner *>(slot);
+        switch (node->type) {
+            case art_node_type::kNode4:
+            case art_node_type::kNode16: {
+                const bool small = node->type == art_node_type::kNode4;
+                const std::uint16_t capacity = small ? art_node4::kCapacity : art_node16::kCapacity;
+                std::uint8_t *keys = small ? static_cast<art_node4 *>(node)->keys : static_cast<art_node16 *>(node)->keys;
+                art_node **children = small ? static_cast<art_node4 *>(node)->children
+                                            : static_cast<art_node16 *>(node)->children;
+
+                if (node->count < capacity) {
+                    std::uint16_t at = 0;
+                    while (at != node->count and keys[at] < byte)
+                        ++at;
+                    std::memmove(keys + at + 1, keys + at, node->count - at);
+                    std::memmove(children + at + 1, children + at, (node->count - at) * sizeof(art_node *));
+                    keys[at] = byte;
+                    children[at] = child;
+                    ++node->count;
+                    return 0;
+                }
+
+                if (small) {
+                    auto *grown = new art_node16;
+                    art_move_header(node, grown);
+                    std::copy(keys, keys + node->count, grown->keys);
+                    std::copy(children, children + node->count, grown->children);
+                    grown->count = node->count;
+                    slot = grown;
+                    delete static_cast<art_node4 *>(node);
+                    art_add_child(slot, byte, child);
+                    return art_node_bytes(art_node16::kType) - art_node_bytes(art_node4::kType);
+                }
+
+                auto *grown = new art_node48;
+                art_move_header(node, grown);
+                for (std::uint16_t i = 0; i != node->count; ++i) {
+                    grown->children[i] = children[i];
+                    grown->index[keys[i]] = static_cast<std::uint8_t>(i + 1);
+                }
+                grown->count = node->count;
+                slot = grown;
+                delete static_cast<art_node16 *>(node);
+                art_add_child(slot, byte, child);
+                return art_node_bytes(art_node48::kType) - art_node_bytes(art_node16::kType);
+            }
+            case art_node_type::kNode48: {
+                auto *n = static_cast<art_node48 *>(node);
+                if (n->count < art_node48::kCapacity) {
+                    std::uint16_t free = 0;
+                    while (n->children[free] != nullptr)
+                        ++free;
+                    n->children[free] = child;
+                    n->index[byte] = static_cast<std::uint8_t>(free + 1);
+                    ++n->count;
+                    return 0;
+                }
+
+                auto *grown = new art_node256;
+                art_move_header(n, grown);
+                for (unsigned b = 0; b != 256; ++b)
+                    if (n->index[b])
+                        grown->children[b] = n->children[n->index[b] - 1];
+                grown->count = n->count;
+                slot = grown;
+                delete n;
+                art_add_child(slot, byte, child);
+                return art_node_bytes(art_node256::kType) - art_node_bytes(art_node48::kType);
+            }
+            case art_node_type::kNode256: {
+                auto *n = static_cast<art_node256 *>(node);
+                n->children[byte] = child;
+                ++n->count;
+                return 0;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    /*
+     * Removes the child under `byte` from the node in `slot`, replacing the
+     * node by the next smaller size once it is well under that size's
+     * capacity (the gap keeps a node at the boundary from flapping).
+     * Returns how many heap bytes the inner nodes shrank by.
+     */
+    inline std::ptrdiff_t art_remove_child(art_node *&slot, std::uint8_t byte) {
+        auto *node = static_cast<art_inner *>(slot);
+        switch (node->type) {
+            case art_node_type::kNode4:
+            case art_node_type::kNode16: {
+                const bool small = node->type == art_node_type::kNode4;
+                std::uint8_t *keys = small ? static_cast<art_node4 *>(node)->keys : static_cast<art_node16 *>(node)->keys;
+                art_node **children = small ? static_cast<art_node4 *>(node)->children
+                                            : static_cast<art_node16 *>(node)->children;
+
+                std::uint16_t at = 0;
+                while (keys[at] != byte)
+                    ++at;
+                std::memmove(keys + at, keys + at + 1, node->count - at - 1);
+                std::memmove(children + at, children + at + 1, (node->count - at - 1) * sizeof(art_node *));
+                --node->count;
+
+                if (small or node->count > 3)
+                    return 0;
+
+                auto *shrunk = new art_node4;
+                art_move_header(node, shrunk);
+                std::copy(keys, keys + node->count, shrunk->keys);
+                std::copy(children, children + node->count, shrunk->children);
+                shrunk->count = node->count;
+                slot = shrunk;
+                delete static_cast<art_node16 *>(node);
+                return art_node_bytes(art_node16::kType) - art_node_bytes(art_node4::kType);
+            }
+            case art_node_type::kNode48: {
+                auto *n = static_cast<art_node48 *>(node);
+                n->children[n->index[byte] - 1] = nullptr;
+                n->index[byte] = 0;
+                --n->count;
+
+                if (n->count > 12)
+                    return 0;
+
+                auto *shrunk = new art_node16;
+                art_move_header(n, shrunk);
+                for (unsigned b = 0; b != 256; ++b) {
+                    if (n->index[b]) {
+                        shrunk->keys[shrunk->count] = static_cast<std::uint8_t>(b);
+                        shrunk->children[shrunk->count++] = n->children[n->index[b] - 1];
+                    }
+                }
+                slot = shrunk;
+                delete n;
+                return art_node_bytes(art_node48::kType) - art_node_bytes(art_node16::kType);
+            }
+            case art_node_type::kNode256: {
+                auto *n = static_cast<art_node256 *>(node);
+                n->children[byte] = nullptr;
+                --n->count;
+
+                if (n->count > 37)
+                    return 0;
+
+                auto *shrunk = new art_node48;
+                art_move_header(n, shrunk);
+                for (unsigned b = 0; b != 256; ++b) {
+                    if (n->children[b]) {
+                        shrunk->children[shrunk->count] = n->children[b];
+                        shrunk->index[b] = static_cast<std::uint8_t>(++shrunk->count);
+                    }
+                }
+                slot = shrunk;
+                delete n;
+                return art_node_bytes(art_node256::kType) - art_node_bytes(art_node48::kType);
+            }
+            default:
+                return 0;
+        }
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ART_MAP_NODE_H
@@ -1,14 +1,29 @@
 #ifndef TRANSACTIONS_LIBRARY_CPP_map_H
 #define TRANSACTIONS_LIBRARY_CPP_map_H
 
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "engine_stats.h"
+#include "memory_usage.h"
+#include "map_cursor.h"
 #include "map_node.h"
 #include "map_normal_iterator.h"
 
 namespace ttl {
-    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    /*
+     * Red-black tree map. Options (see map_options) add per-node data:
+     * kOrderStatistics stores subtree sizes, which costs one word per node and
+     * a little work per rotation, and enables rank/select/count_range in
+     * O(log n); kThreaded keeps nodes in an in-order list, which costs two
+     * words per node and makes every iterator step a single pointer load.
+     */
+    template <typename Key, typename Value, typename Compare = std::less<Key>, unsigned Options = map_options::kNone>
     class map {
     private:
-        using node_type      = detail::map_node<Key, Value>;
+        using node_type      = detail::map_node<Key, Value, Options>;
         using node_pointer   = node_type *;
         using color_type     = detail::map_node_color;
 
@@ -18,6 +33,10 @@ namespace ttl {
         using value_type     = typename node_type::value_type;
         using size_type      = typename node_type::size_type;
         using compare_type   = Compare;
+        using cursor_type    = map_cursor<key_type>;
+
+        static constexpr bool kOrderStatistics = (Options & map_options::kOrderStatistics) != 0;
+        static constexpr bool kThreaded = (Options & map_options::kThreaded) != 0;
 
         using iterator       = map_normal_iterator<node_type>;
         using const_iterator = map_normal_iterator<const node_type>;
@@ -28,9 +47,12 @@ namespace ttl {
         compare_type compare_;
         size_type size_ {};
 
+        engine_stats stats_;
+
     public:
         map() : null_(new node_type), root_(null_), compare_(compare_type{}) {};
-        map(const map &other) {
+        map(const map &other) : map() {
+            compare_ = other.compare_;
             for (const auto &kv : other)
                 insert(kv);
         }
@@ -39,9 +61,8 @@ namespace ttl {
             if (this == &other)
                 return *this;
 
-            if (!empty())
-                clear_recursive(root_);
-
+            clear();
+            compare_ = other.compare_;
             for (const auto &kv : other)
                 insert(kv);
 
@@ -77,6 +98,23 @@ namespace ttl {
         [[nodiscard]] size_type size() const noexcept { return size_; }
         [[nodiscard]] bool empty() const noexcept { return size_ == size_type{}; }
 
+        [[nodiscard]] const engine_stats &stats() const noexcept { return stats_; }
+        void reset_stats() noexcept { stats_ = engine_stats{}; }
+
+        // one allocation per entry plus the null node; walks the entries for their heap when `with_heap`
+        [[nodiscard]] memory_stats memory(bool with_heap = true) const {
+            memory_stats stats;
+            stats.entries = size_;
+            stats.table_bytes = sizeof(*this) + detail::allocation_size(sizeof(node_type));
+            stats.node_bytes = size_ * detail::allocation_size(sizeof(node_type));
+
+            if (with_heap)
+                for (const auto &kv : *this)
+                    stats.heap_bytes += heap_size(kv);
+            stats.payload_bytes = size_ * sizeof(value_type) + stats.heap_bytes;
+            return stats;
+        }
+
     public:
         iterator begin() noexcept {
             node_pointer min = min_node(root_);
@@ -91,88 +129,53 @@ namespace ttl {
         iterator end() noexcept { return iterator(null_, null_, root_); }
         const_iterator end() const noexcept { return const_iterator(null_, null_, root_); }
 
-    public:
-        std::pair<iterator, bool> insert(const value_type &kv) {
-            node_pointer node = root_;
-            node_pointer parent = nullptr;
-
-            while (!is_null(node)) {
-                parent = node;
-
-                if (kv.first == node->kv.first)
-                    return std::make_pair(iterator(node, null_, root_), false);
-
-                if (compare_(kv.first, node->kv.first))
-                    node = node->left;
-                else
-                    node = node->right;
+        /*
+         * Cuts the tree into at most `parts` consecutive iterator ranges. The
+         * boundaries are taken from the top levels of the tree, which split
+         * the keys into subtrees of similar size.
+         */
+        std::vector<std::pair<iterator, iterator>> split(size_type parts) {
+            std::vector<std::pair<iterator, iterator>> ranges;
+            if (parts == 0 or empty())
+                return ranges;
+
+            std::vector<node_pointer> top;
+            for (size_type depth = 1; top.size() + 1 < parts and top.size() < size_; ++depth) {
+                top.clear();
+                collect_top(root_, depth, top);
             }
 
-            node = new node_type(kv);
-            node->parent = parent;
-            node->left = null_;
-            node->right = null_;
-            node->color = color_type::kRed;
+            iterator first = begin();
+            for (size_type part = 1; part <= parts; ++part) {
+                iterator last = end();
+                if (part != parts and !top.empty())
+                    last = iterator(top[top.size() * part / parts], null_, root_);
 
-            if (parent) {
-                if (compare_(node->kv.first, parent->kv.first))
-                    parent->left = node;
-                else
-                    parent->right = node;
-            } else {
-                root_ = node;
+                if (first != last)
+                    ranges.emplace_back(first, last);
+                first = last;
             }
 
-            insersion_fix(node);
-            size_++;
-            return std::make_pair(iterator(node, null_, root_), true);
+            return ranges;
         }
 
-        std::pair<iterator, bool> insert(value_type &&kv) {
-            node_pointer node = root_;
-            node_pointer parent = nullptr;
-
-            while (!is_null(node)) {
-                parent = node;
-
-                if (kv.first == node->kv.first)
-                    return std::make_pair(iterator(node, null_, root_), false);
-
-                if (compare_(kv.first, node->kv.first))
-                    node = node->left;
-                else
-                    node = node->right;
-            }
-
-            node = new node_type(std::move(kv));
-            node->parent = parent;
-            node->left = null_;
-            node->right = null_;
-            node->color = color_type::kRed;
-
-            if (parent) {
-                if (compare_(node->kv.first, parent->kv.first))
-                    parent->left = node;
-                else
-                    parent->right = node;
-            } else {
-                root_ = node;
-            }
+    public:
+        std::pair<iterator, bool> insert(const value_type &kv) { return emplace_key(kv.first, kv.second); }
+        std::pair<iterator, bool> insert(value_type &&kv) { return emplace_key(kv.first, std::move(kv.second)); }
 
-            insersion_fix(node);
-            size_++;
-            return std::make_pair(iterator(node, null_, root_), true);
+        // like std::map::try_emplace: the key is copied and the value built only when the key is new
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+            return emplace_key(key, std::forward<Args>(args)...);
         }
 
-        mapped_type &operator[](const key_type &key) {
-            auto it = insert(std::make_pair(key, mapped_type{})).first;
-            return it->second;
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
         }
 
-        mapped_type &operator[](key_type &&key) {
-            auto it = insert(std::make_pair(std::move(key), mapped_type{})).first;
-            return it->second;
-        }
+        mapped_type &operator[](const key_type &key) { return emplace_key(key).first->second; }
+        mapped_type &operator[](key_type &&key) { return emplace_key(std::move(key)).first->second; }
 
         void erase(const key_type &key) {
             node_pointer node = find_pointer(root_, key);
@@ -193,6 +196,13 @@ namespace ttl {
                 child = delete_node->right;
             }
 
+            if constexpr (kOrderStatistics)
+                for (node_pointer ancestor = delete_node->parent; ancestor; ancestor = ancestor->parent)
+                    ancestor->count--;
+
+            if constexpr (kThreaded)
+                thread_unlink(delete_node);
+
             child->parent = delete_node->parent;
             if (delete_node->parent) {
                 if (delete_node->is_left_child()) {
@@ -209,6 +219,7 @@ namespace ttl {
 
             delete delete_node;
             size_--;
+            stats_.erases++;
         }
 
         void erase(key_type &&key) {
@@ -230,6 +241,13 @@ namespace ttl {
                 child = delete_node->right;
             }
 
+            if constexpr (kOrderStatistics)
+                for (node_pointer ancestor = delete_node->parent; ancestor; ancestor = ancestor->parent)
+                    ancestor->count--;
+
+            if constexpr (kThreaded)
+                thread_unlink(delete_node);
+
             child->parent = delete_node->parent;
             if (delete_node->parent) {
                 if (delete_node->is_left_child()) {
@@ -246,6 +264,7 @@ namespace ttl {
 
             delete delete_node;
             size_--;
+            stats_.erases++;
         }
 
         void erase(iterator it) {
@@ -266,10 +285,149 @@ namespace ttl {
             return end();
         }
 
+        // number of keys less than `key`
+        template <bool Enabled = kOrderStatistics, std::enable_if_t<Enabled, int> = 0>
+        size_type rank(const key_type &key) const {
+            size_type result = 0;
+            for (node_pointer node = root_; node and !is_null(node);) {
+                if (compare_(node->kv.first, key)) {
+                    result += node->left->count + 1;
+                    node = node->right;
+                } else {
+                    node = node->left;
+                }
+            }
+            return result;
+        }
+
+        // entry with exactly `index` smaller keys, end() when index >= size()
+        template <bool Enabled = kOrderStatistics, std::enable_if_t<Enabled, int> = 0>
+        iterator select(size_type index) {
+            if (index >= size_)
+                return end();
+
+            node_pointer node = root_;
+            while (index != node->left->count) {
+                if (index < node->left->count) {
+                    node = node->left;
+                } else {
+                    index -= node->left->count + 1;
+                    node = node->right;
+                }
+            }
+            return iterator(node, null_, root_);
+        }
+
+        // number of keys in [from, to]
+        template <bool Enabled = kOrderStatistics, std::enable_if_t<Enabled, int> = 0>
+        size_type count_range(const key_type &from, const key_type &to) const {
+            if (compare_(to, from))
+                return 0;
+
+            size_type not_greater = 0;
+            for (node_pointer node = root_; node and !is_null(node);) {
+                if (compare_(to, node->kv.first)) {
+                    node = node->left;
+                } else {
+                    not_greater += node->left->count + 1;
+                    node = node->right;
+                }
+            }
+            return not_greater - rank(from);
+        }
+
+        // first entry whose key is not less than `key`
+        iterator lower_bound(const key_type &key) { return iterator(lower_bound_pointer(key), null_, root_); }
+        const_iterator lower_bound(const key_type &key) const { return const_iterator(lower_bound_pointer(key), null_, root_); }
+
+        // first entry whose key is greater than `key`
+        iterator upper_bound(const key_type &key) { return iterator(upper_bound_pointer(key), null_, root_); }
+        const_iterator upper_bound(const key_type &key) const { return const_iterator(upper_bound_pointer(key), null_, root_); }
+
+        std::pair<iterator, iterator> equal_range(const key_type &key) {
+            return std::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return std::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        /*
+         * Calls functor for up to `count` entries following the cursor in key
+         * order and returns the cursor to continue from (see map_cursor).
+         */
+        template <typename Functor>
+        cursor_type scan(const cursor_type &cursor, size_type count, Functor functor) {
+            if (empty())
+                return cursor_type{};
+
+            iterator it = cursor.after ? upper_bound(*cursor.after) : begin();
+            cursor_type next = cursor;
+            for (size_type visited = 0; it != end() and visited != count; ++it, ++visited) {
+                functor(*it);
+                next.after = it->first;
+            }
+
+            return it != end() ? next : cursor_type{};
+        }
+
     private:
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> emplace_key(K &&key, Args &&...args) {
+            node_pointer node = root_;
+            node_pointer parent = nullptr;
+
+            const size_type probes_before = stats_.lookup();
+            while (!is_null(node)) {
+                parent = node;
+                stats_.probes++;
+
+                if (key == node->kv.first) {
+                    stats_.hit(probes_before);
+                    return std::make_pair(iterator(node, null_, root_), false);
+                }
+
+                if (compare_(key, node->kv.first))
+                    node = node->left;
+                else
+                    node = node->right;
+            }
+
+            node = new node_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+            node->parent = parent;
+            node->left = null_;
+            node->right = null_;
+            node->color = color_type::kRed;
+
+            if (parent) {
+                if (compare_(node->kv.first, parent->kv.first))
+                    parent->left = node;
+                else
+                    parent->right = node;
+            } else {
+                root_ = node;
+            }
+
+            if constexpr (kOrderStatistics) {
+                node->count = 1;
+                for (node_pointer ancestor = parent; ancestor; ancestor = ancestor->parent)
+                    ancestor->count++;
+            }
+
+            if constexpr (kThreaded)
+                thread_link(node);
+
+            insersion_fix(node);
+            size_++;
+            stats_.inserts++;
+            return std::make_pair(iterator(node, null_, root_), true);
+        }
+
         void clear() {
             if (root_ and size_ != size_type{})
                 clear_recursive(root_);
+            root_ = null_;
         }
 
         void clear_recursive(node_pointer node) {
@@ -284,6 +442,41 @@ namespace ttl {
 
         bool is_null(node_pointer node) const { return node == null_; }
 
+        // a new leaf sits right before its parent if it is a left child, right after it otherwise
+        void thread_link(node_pointer node) {
+            node_pointer parent = node->parent;
+            if (!parent) {
+                node->prev = node->next = null_;
+                return;
+            }
+
+            if (node->is_left_child()) {
+                node->next = parent;
+                node->prev = parent->prev;
+            } else {
+                node->prev = parent;
+                node->next = parent->next;
+            }
+
+            if (!is_null(node->prev)) node->prev->next = node;
+            if (!is_null(node->next)) node->next->prev = node;
+        }
+
+        void thread_unlink(node_pointer node) {
+            if (!is_null(node->prev)) node->prev->next = node->next;
+            if (!is_null(node->next)) node->next->prev = node->prev;
+        }
+
+        // in-order list of the nodes that lie less than `depth` levels below `node`
+        void collect_top(node_pointer node, size_type depth, std::vector<node_pointer> &nodes) const {
+            if (depth == 0 or !node or is_null(node))
+                return;
+
+            collect_top(node->left, depth - 1, nodes);
+            nodes.push_back(node);
+            collect_top(node->right, depth - 1, nodes);
+        }
+
         void insersion_fix(node_pointer x) {
             while (x != root_ and x->parent->color == color_type::kRed) {
                 auto parent = x->parent;
@@ -387,14 +580,44 @@ namespace ttl {
             }
         }
 
+        node_pointer lower_bound_pointer(const key_type &key) const {
+            node_pointer node = root_, bound = null_;
+            while (node and !is_null(node)) {
+                if (compare_(node->kv.first, key)) {
+                    node = node->right;
+                } else {
+                    bound = node;
+                    node = node->left;
+                }
+            }
+            return bound;
+        }
+
+        node_pointer upper_bound_pointer(const key_type &key) const {
+            node_pointer node = root_, bound = null_;
+            while (node and !is_null(node)) {
+                if (compare_(key, node->kv.first)) {
+                    bound = node;
+                    node = node->left;
+                } else {
+                    node = node->right;
+                }
+            }
+            return bound;
+        }
+
         node_pointer find_pointer(node_pointer n, const key_type &key) {
             node_pointer node = n;
+            const size_type probes_before = stats_.lookup();
             if (!node or is_null(node))
                 return null_;
 
             while (!is_null(node)) {
-                if (node->kv.first == key)
+                stats_.probes++;
+                if (node->kv.first == key) {
+                    stats_.hit(probes_before);
                     return node;
+                }
 
                 if (compare_(key, node->kv.first))
                     node = node->left;
@@ -406,12 +629,16 @@ namespace ttl {
 
         node_pointer find_pointer(node_pointer n, key_type &&key) {
             node_pointer node = n;
+            const size_type probes_before = stats_.lookup();
             if (!node or is_null(node))
                 return null_;
 
             while (!is_null(node)) {
-                if (std::move(node->kv.first) == std::move(key))
+                stats_.probes++;
+                if (std::move(node->kv.first) == std::move(key)) {
+                    stats_.hit(probes_before);
                     return node;
+                }
 
                 if (compare_(std::move(key), std::move(node->kv.first)))
                     node = node->left;
@@ -423,6 +650,7 @@ namespace ttl {
 
 
         void rotate_left(node_pointer node) {
+            stats_.rotations++;
             node_pointer y = node->right;
             node_pointer mid = y->left;
             node->right = mid;
@@ -444,9 +672,17 @@ namespace ttl {
 
             y->left = node;
             node->parent = y;
+
+            if constexpr (kOrderStatistics) {
+                if (y != null_) {
+                    y->count = node->count;
+                    node->count = node->left->count + node->right->count + 1;
+                }
+            }
         }
 
         void rotate_right(node_pointer node) {
+            stats_.rotations++;
             node_pointer x = node->left;
             node_pointer mid = x->right;
             node->left = mid;
@@ -468,6 +704,13 @@ namespace ttl {
 
             x->right = node;
             node->parent = x;
+
+            if constexpr (kOrderStatistics) {
+                if (x != null_) {
+                    x->count = node->count;
+                    node->count = node->left->count + node->right->count + 1;
+                }
+            }
         }
 
         node_pointer min_node(node_pointer n) const {
@@ -0,0 +1,54 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_MAP_CURSOR_H
+#define TRANSACTIONS_LIBRARY_CPP_MAP_CURSOR_H
+
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace ttl {
+    /*
+     * Position of an incremental map scan: the last key already returned.
+     * The next batch starts at the first key greater than it, so the scan is
+     * unaffected by inserts and erases made between calls.
+     *
+     * A default cursor starts a scan, and a default cursor returned by scan()
+     * means it's finished.
+     */
+    template <typename Key>
+    struct map_cursor {
+        std::optional<Key> after;
+
+        bool operator==(const map_cursor &other) const { return after == other.after; }
+        bool operator!=(const map_cursor &other) const { return after != other.after; }
+    };
+
+    template <typename Key>
+    std::string to_string(const map_cursor<Key> &cursor) {
+        if (!cursor.after)
+            return "0";
+
+        std::ostringstream ss;
+        ss << '@' << *cursor.after;
+        return ss.str();
+    }
+
+    template <typename Key>
+    bool parse_cursor(const std::string &text, map_cursor<Key> &cursor) {
+        cursor = map_cursor<Key>{};
+        if (text == "0")
+            return true;
+
+        if (text.size() < 2 or text.front() != '@')
+            return false;
+
+        std::istringstream ss(text.substr(1));
+        Key key;
+        if (!(ss >> key))
+            return false;
+
+        cursor.after = std::move(key);
+        return true;
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_MAP_CURSOR_H
@@ -3,6 +3,15 @@
 
 #include <iostream>
 #include <memory>
+#include <utility>
+
+namespace ttl::map_options {
+    inline constexpr unsigned kNone            = 0;
+    // subtree sizes for rank/select/count_range in O(log n)
+    inline constexpr unsigned kOrderStatistics = 1u << 0;
+    // in-order next/prev links, iterator steps become a single pointer load
+    inline constexpr unsigned kThreaded        = 1u << 1;
+}
 
 namespace ttl::detail {
     enum class map_node_color : bool {
@@ -10,9 +19,31 @@ namespace ttl::detail {
         kBlack
     };
 
-    template <typename Key, typename Value>
-    struct map_node {
+    // number of nodes in the subtree, stored only by order-statistic maps
+    template <bool Counted>
+    struct map_node_count {};
+
+    template <>
+    struct map_node_count<true> {
+        std::size_t count = 0;
+    };
+
+    // in-order neighbours, stored only by threaded maps; the map's null node ends the list
+    template <bool Threaded, typename Node>
+    struct map_node_thread {};
+
+    template <typename Node>
+    struct map_node_thread<true, Node> {
+        Node *next = nullptr;
+        Node *prev = nullptr;
+    };
+
+    template <typename Key, typename Value, unsigned Options = map_options::kNone>
+    struct map_node : map_node_count<(Options & map_options::kOrderStatistics) != 0>,
+                      map_node_thread<(Options & map_options::kThreaded) != 0, map_node<Key, Value, Options>> {
     public:
+        static constexpr bool kThreaded = (Options & map_options::kThreaded) != 0;
+
         using key_type = Key;
         using mapped_type = Value;
         using value_type = std::pair<key_type, mapped_type>;
@@ -35,6 +66,10 @@ namespace ttl::detail {
         explicit map_node(const value_type &kv) : kv(kv) {};
         explicit map_node(value_type &&kv) noexcept : kv(std::move(kv)) {};
 
+        template <typename KeyArgs, typename MappedArgs>
+        map_node(std::piecewise_construct_t, KeyArgs &&key, MappedArgs &&mapped)
+            : kv(std::piecewise_construct, std::forward<KeyArgs>(key), std::forward<MappedArgs>(mapped)) {}
+
     public:
         [[nodiscard]] bool is_left_child() const { return parent and this == parent->left; }
         [[nodiscard]] bool is_right_child() const { return parent and this == parent->right; }
@@ -29,6 +29,12 @@ namespace ttl {
         pointer operator->() { return &(current_->kv); }
 
         map_normal_iterator &operator++() {
+            if constexpr (node_type::kThreaded) {
+                if (current_ != null_)
+                    current_ = current_->next;
+                return *this;
+            }
+
             if (current_ == null_)
                 current_ = null_;
             else if (current_->right != null_) {
@@ -54,6 +60,12 @@ namespace ttl {
         }
 
         map_normal_iterator &operator--() {
+            if constexpr (node_type::kThreaded) {
+                if (current_ != null_)
+                    current_ = current_->prev;
+                return *this;
+            }
+
             if (current_ == null_)
                 current_ = null_;
             else if (current_->left != null_) {
@@ -0,0 +1,456 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_H
+#define TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "engine_stats.h"
+#include "memory_usage.h"
+#include "robin_hood_map_cursor.h"
+#include "robin_hood_map_iterator.h"
+#include "robin_hood_probe_stats.h"
+#include "unordered_map_hash.h"
+
+namespace ttl {
+    /*
+     * Open-addressing hash table with Robin Hood placement and the same
+     * interface as unordered_map. An insert that meets an entry closer to
+     * its home slot than the new one takes that slot and carries the
+     * displaced entry on, so probe distances stay short and even.
+     *
+     * That order is what the rest relies on: a lookup stops at the first
+     * entry closer to home than the probe (the key can't be further on),
+     * and erase shifts the following entries back one slot instead of
+     * leaving a tombstone, so heavy DEL churn doesn't lengthen probes.
+     *
+     * Slots hold the hash and a pointer to a node with the entry, so probes
+     * compare hashes in one array and entries never move in memory:
+     * references stay valid until the entry is erased. Iterators are
+     * invalidated by any insert or erase.
+     */
+    template <typename Key, typename Value, typename Hash = seeded_hash<Key>>
+    class robin_hood_map {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using hash_type = Hash;
+        using size_type = std::size_t;
+        using cursor_type = robin_hood_map_cursor;
+
+        static constexpr size_type kMinCapacity = 8;
+        static constexpr double kMaxLoad = 0.875;
+        // shrinks below this load, to the smallest table under kMaxLoad / 2, see update_shrink
+        static constexpr double kShrinkLoad = 0.125;
+        // an insert probing further than this grows a table that is at least half full
+        static constexpr size_type kMaxDistance = 64;
+
+    private:
+        using slot_type = detail::robin_hood_slot<value_type>;
+        using table_type = std::vector<slot_type>;
+
+    public:
+        using iterator = robin_hood_map_iterator<slot_type, value_type>;
+        using const_iterator = robin_hood_map_iterator<const slot_type, const value_type>;
+
+    public:
+        robin_hood_map() = default;
+        explicit robin_hood_map(const hash_type &hash) : hash_(hash) {}
+
+        robin_hood_map(const robin_hood_map &other)
+            : slots_(other.slots_.size()), size_(other.size_), hash_(other.hash_) {
+            // same hash and capacity: every entry goes to the slot it had
+            for (size_type index = 0; index != slots_.size(); ++index) {
+                if (other.slots_[index].node == nullptr)
+                    continue;
+                slots_[index].node = new value_type(*other.slots_[index].node);
+                slots_[index].hash = other.slots_[index].hash;
+            }
+        }
+
+        robin_hood_map(robin_hood_map &&other) noexcept
+            : slots_(std::move(other.slots_)), size_(other.size_), hash_(std::move(other.hash_)),
+              stats_(other.stats_) {
+            other.slots_.clear();
+            other.size_ = 0;
+        }
+
+        robin_hood_map &operator=(const robin_hood_map &other) {
+            if (this != &other) {
+                robin_hood_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        robin_hood_map &operator=(robin_hood_map &&other) noexcept {
+            if (this != &other) {
+                release();
+                slots_ = std::move(other.slots_);
+                size_ = other.size_;
+                hash_ = std::move(other.hash_);
+                stats_ = other.stats_;
+                other.slots_.clear();
+                other.size_ = 0;
+            }
+            return *this;
+        }
+
+        ~robin_hood_map() { release(); }
+
+        void swap(robin_hood_map &other) noexcept {
+            std::swap(slots_, other.slots_);
+            std::swap(size_, other.size_);
+            std::swap(hash_, other.hash_);
+            std::swap(stats_, other.stats_);
+        }
+
+        std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type> &kv) {
+            return emplace_key(kv.first, kv.second);
+        }
+
+        std::pair<iterator, bool> insert(std::pair<key_type, mapped_type> &&kv) {
+            return emplace_key(std::move(kv.first), std::move(kv.second));
+        }
+
+        // like std::unordered_map::try_emplace: the key is copied and the value built only when the key is new
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        mapped_type &operator[](const key_type &key) { return emplace_key(key).first->second; }
+        mapped_type &operator[](key_type &&key) { return emplace_key(std::move(key)).first->second; }
+
+    public:
+        iterator begin() noexcept { return make_iterator(0); }
+        const_iterator begin() const noexcept { return make_iterator(0); }
+
+        iterator end() noexcept { return make_iterator(slots_.size()); }
+        const_iterator end() const noexcept { return make_iterator(slots_.size()); }
+
+        /*
+         * Cuts the table into at most `parts` disjoint iterator ranges over
+         * equal slot spans, for scanning them independently.
+         */
+        std::vector<std::pair<iterator, iterator>> split(size_type parts) {
+            std::vector<std::pair<iterator, iterator>> ranges;
+            if (parts == 0 or empty())
+                return ranges;
+
+            iterator first = begin();
+            for (size_type part = 1; part <= parts; ++part) {
+                iterator last = make_iterator(slots_.size() * part / parts);
+                if (first != last)
+                    ranges.emplace_back(first, last);
+                first = last;
+            }
+
+            return ranges;
+        }
+
+    public:
+        [[nodiscard]] size_type size() const noexcept { return size_; }
+        [[nodiscard]] size_type capacity() const noexcept { return slots_.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == size_type{}; }
+
+    public:
+        iterator find(const key_type &key) {
+            if (empty()) return end();
+
+            const size_type index = find_index(hash_(key), key);
+            return index == kNotFound ? end() : make_iterator(index);
+        }
+
+        iterator find(key_type &&key) { return find(static_cast<const key_type &>(key)); }
+
+    public:
+        bool erase(const key_type &key) {
+            if (empty()) return false;
+
+            const size_type index = find_index(hash_(key), key);
+            if (index == kNotFound)
+                return false;
+
+            erase_at(index);
+            update_shrink();
+            return true;
+        }
+
+        bool erase(key_type &&key) { return erase(static_cast<const key_type &>(key)); }
+
+        bool erase(iterator it) { return erase(it->first); }
+
+        /*
+         * Grows the table so that `items_count` entries fit without another
+         * rehash. Never shrinks it.
+         */
+        void reserve(size_type items_count) {
+            const size_type capacity = fitting_capacity(items_count, kMaxLoad);
+            if (capacity > slots_.size())
+                rehash(capacity);
+        }
+
+        /*
+         * Rehashes into the smallest table that holds the current entries
+         * under kMaxLoad; an empty map releases its slots.
+         */
+        void shrink_to_fit() {
+            if (empty()) {
+                table_type().swap(slots_);
+                return;
+            }
+
+            const size_type capacity = fitting_capacity(size_, kMaxLoad);
+            if (capacity < slots_.size())
+                rehash(capacity);
+        }
+
+        [[nodiscard]] size_type bucket_count() const noexcept { return slots_.size(); }
+
+        /*
+         * Histogram of probe distances over every slot, or over `sample`
+         * evenly spaced slots when that is fewer.
+         */
+        [[nodiscard]] robin_hood_probe_stats probe_stats(size_type sample = 0) const {
+            robin_hood_probe_stats stats;
+            stats.slots = slots_.size();
+
+            const size_type step = sample == 0 or sample >= slots_.size() ? 1 : slots_.size() / sample;
+            for (size_type index = 0; index < slots_.size(); index += step) {
+                ++stats.sampled;
+                if (slots_[index].node != nullptr)
+                    stats.add(distance(index, slots_[index].hash));
+            }
+
+            return stats;
+        }
+
+        [[nodiscard]] const engine_stats &stats() const noexcept { return stats_; }
+        void reset_stats() noexcept { stats_ = engine_stats{}; }
+
+        /*
+         * Walks every entry to add up the heap its key and value own, unless
+         * `with_heap` is false; the table and node parts are O(1).
+         */
+        [[nodiscard]] memory_stats memory(bool with_heap = true) const {
+            memory_stats stats;
+            stats.entries = size_;
+            stats.buckets = slots_.size();
+            stats.table_bytes = sizeof(*this) + detail::allocation_size(slots_.capacity() * sizeof(slot_type));
+            stats.node_bytes = size_ * detail::allocation_size(sizeof(value_type));
+
+            if (with_heap)
+                for (const auto &kv : *this)
+                    stats.heap_bytes += heap_size(kv);
+            stats.payload_bytes = size_ * sizeof(value_type) + stats.heap_bytes;
+            return stats;
+        }
+
+        /*
+         * Calls functor for the entries of whole home slots, in the cursor's
+         * reverse-binary order, until at least `count` entries were visited,
+         * and returns the cursor to continue from (see robin_hood_map_cursor).
+         */
+        template <typename Functor>
+        cursor_type scan(cursor_type cursor, size_type count, Functor functor) {
+            if (empty())
+                return cursor_type{};
+
+            const size_type mask = slots_.size() - 1;
+            size_type position = cursor.position, visited = 0, empty_visits = 0;
+            do {
+                const size_type entries = visit_home(position & mask, functor);
+                visited += entries;
+                empty_visits += entries == 0;
+
+                position |= ~mask;
+                position = reverse_bits(reverse_bits(position) + 1);
+            } while (position != 0 and visited < count and empty_visits < count * 10);
+
+            return cursor_type{position};
+        }
+
+    private:
+        static constexpr size_type kNotFound = static_cast<size_type>(-1);
+
+        table_type slots_;
+        size_type size_ = 0;
+        hash_type hash_;
+
+        engine_stats stats_;
+
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> emplace_key(K &&key, Args &&...args) {
+            const size_type hashed_key = hash_(key);
+            if (!slots_.empty()) {
+                const size_type index = find_index(hashed_key, key);
+                if (index != kNotFound)
+                    return std::make_pair(make_iterator(index), false);
+            }
+
+            if (static_cast<double>(size_ + 1) > kMaxLoad * static_cast<double>(slots_.size()))
+                rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+
+            auto *node = new value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+            size_++;
+            stats_.inserts++;
+
+            auto [index, longest] = place(slots_, slot_type{node, hashed_key});
+            if (longest > kMaxDistance and size_ * 2 >= slots_.size()) {
+                rehash(slots_.size() * 2);
+                index = find_index(hashed_key, node->first);
+            }
+
+            return std::make_pair(make_iterator(index), true);
+        }
+
+        [[nodiscard]] size_type distance(size_type index, size_type hashed_key) const noexcept {
+            return (index - (hashed_key & (slots_.size() - 1))) & (slots_.size() - 1);
+        }
+
+        // slot of `key`, or kNotFound as soon as the probe passes an entry closer to its home
+        size_type find_index(size_type hashed_key, const key_type &key) {
+            const size_type mask = slots_.size() - 1;
+            const size_type probes_before = stats_.lookup();
+
+            for (size_type index = hashed_key & mask, probe = 0;; index = (index + 1) & mask, ++probe) {
+                const slot_type &slot = slots_[index];
+                if (slot.node == nullptr or distance(index, slot.hash) < probe)
+                    return kNotFound;
+
+                stats_.probes++;
+                if (slot.hash == hashed_key and slot.node->first == key) {
+                    stats_.hit(probes_before);
+                    return index;
+                }
+            }
+        }
+
+        /*
+         * Robin Hood insert of `entry` into `slots`, which has a free slot:
+         * returns the slot it landed in and the longest probe distance
+         * reached by it or an entry it displaced.
+         */
+        static std::pair<size_type, size_type> place(table_type &slots, slot_type entry) noexcept {
+            const size_type mask = slots.size() - 1;
+            size_type landed = kNotFound, longest = 0;
+
+            for (size_type index = entry.hash & mask, probe = 0;; index = (index + 1) & mask, ++probe) {
+                slot_type &slot = slots[index];
+                if (probe > longest)
+                    longest = probe;
+
+                if (slot.node == nullptr) {
+                    slot = entry;
+                    return std::make_pair(landed == kNotFound ? index : landed, longest);
+                }
+
+                const size_type resident = (index - (slot.hash & mask)) & mask;
+                if (resident < probe) {
+                    std::swap(slot, entry);
+                    if (landed == kNotFound)
+                        landed = index;
+                    probe = resident;
+                }
+            }
+        }
+
+        // frees the entry and pulls the rest of its cluster back one slot: no tombstones
+        void erase_at(size_type index) {
+            delete slots_[index].node;
+            size_--;
+            stats_.erases++;
+
+            const size_type mask = slots_.size() - 1;
+            for (size_type next = (index + 1) & mask;
+                 slots_[next].node != nullptr and distance(next, slots_[next].hash) != 0;
+                 next = (next + 1) & mask) {
+                slots_[index] = slots_[next];
+                index = next;
+            }
+            slots_[index] = slot_type{};
+        }
+
+        // entries whose home slot is `home`; they sit together in its cluster
+        template <typename Functor>
+        size_type visit_home(size_type home, Functor &functor) {
+            const size_type mask = slots_.size() - 1;
+            size_type visited = 0;
+
+            for (size_type index = home, probe = 0;; index = (index + 1) & mask, ++probe) {
+                slot_type &slot = slots_[index];
+                if (slot.node == nullptr or distance(index, slot.hash) < probe)
+                    return visited;
+
+                if ((slot.hash & mask) == home) {
+                    functor(*slot.node);
+                    ++visited;
+                }
+            }
+        }
+
+        static size_type reverse_bits(size_type value) noexcept {
+            size_type reversed = 0;
+            for (size_type bit = 0; bit != sizeof(size_type) * 8; ++bit, value >>= 1)
+                reversed = (reversed << 1) | (value & 1);
+            return reversed;
+        }
+
+        iterator make_iterator(size_type index) noexcept {
+            slot_type *slots = slots_.data();
+            return iterator(slots + index, slots + slots_.size());
+        }
+
+        const_iterator make_iterator(size_type index) const noexcept {
+            const slot_type *slots = slots_.data();
+            return const_iterator(slots + index, slots + slots_.size());
+        }
+
+        // smallest power of two, at least kMinCapacity, whose load stays under `load` with `items_count` entries
+        static size_type fitting_capacity(size_type items_count, double load) noexcept {
+            size_type capacity = kMinCapacity;
+            while (static_cast<double>(items_count) > load * static_cast<double>(capacity))
+                capacity *= 2;
+            return capacity;
+        }
+
+        // nodes stay where they are: a rehash allocates only the new slot array
+        void rehash(size_type capacity) {
+            stats_.rehashes++;
+            table_type slots(capacity);
+            for (const slot_type &slot : slots_)
+                if (slot.node != nullptr)
+                    place(slots, slot);
+            slots_ = std::move(slots);
+        }
+
+        void update_shrink() {
+            if (slots_.size() <= kMinCapacity or
+                static_cast<double>(size_) >= kShrinkLoad * static_cast<double>(slots_.size()))
+                return;
+
+            const size_type capacity = fitting_capacity(size_, kMaxLoad / 2);
+            if (capacity < slots_.size())
+                rehash(capacity);
+        }
+
+        void release() noexcept {
+            for (slot_type &slot : slots_)
+                delete slot.node;
+            slots_.clear();
+            size_ = 0;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_H
@@ -0,0 +1,52 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_CURSOR_H
+#define TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_CURSOR_H
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+
+namespace ttl {
+    /*
+     * Position of an incremental robin_hood_map scan. The table has a
+     * power-of-two size and an entry's home slot is hash & (size - 1), so
+     * the cursor walks home slots in reverse-binary order, as Redis does:
+     * after the table doubles or halves, the homes already visited map onto
+     * a prefix of the new order. Keys present for the whole scan are returned
+     * at least once, and may be returned twice if the table shrinks.
+     *
+     * Scanning by home slot instead of by array position keeps this true
+     * while inserts displace entries and erases shift them back.
+     *
+     * A default cursor starts a scan, and a default cursor returned by scan()
+     * means it's finished.
+     */
+    struct robin_hood_map_cursor {
+        std::size_t position = 0;
+
+        bool operator==(const robin_hood_map_cursor &other) const { return position == other.position; }
+        bool operator!=(const robin_hood_map_cursor &other) const { return !(*this == other); }
+    };
+
+    inline std::string to_string(const robin_hood_map_cursor &cursor) { return std::to_string(cursor.position); }
+
+    inline bool parse_cursor(const std::string &text, robin_hood_map_cursor &cursor) {
+        cursor = robin_hood_map_cursor{};
+        if (text.empty() or text.size() > 20)
+            return false;
+
+        std::size_t position = 0;
+        for (char c : text) {
+            if (!std::isdigit(static_cast<unsigned char>(c)))
+                return false;
+            const std::size_t next = position * 10 + static_cast<std::size_t>(c - '0');
+            if (next / 10 != position)
+                return false;
+            position = next;
+        }
+
+        cursor.position = position;
+        return true;
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_CURSOR_H
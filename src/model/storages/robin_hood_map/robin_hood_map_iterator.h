@@ -0,0 +1,63 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_ITERATOR_H
+#define TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace ttl {
+    namespace detail {
+        /*
+         * One slot of the open-addressing array: the entry's node, null for a
+         * free slot, and its full hash, which gives the home slot and the
+         * probe distance without touching the node.
+         */
+        template <typename Node>
+        struct robin_hood_slot {
+            Node *node = nullptr;
+            std::size_t hash = 0;
+        };
+    }
+
+    template <typename Slot, typename Value>
+    class robin_hood_map_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        robin_hood_map_iterator() = default;
+        robin_hood_map_iterator(Slot *slot, Slot *end) : slot_(slot), end_(end) { skip_free(); }
+
+        reference operator*() const { return *slot_->node; }
+        pointer operator->() const { return slot_->node; }
+
+        robin_hood_map_iterator &operator++() {
+            ++slot_;
+            skip_free();
+            return *this;
+        }
+
+        robin_hood_map_iterator operator++(int) {
+            robin_hood_map_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const robin_hood_map_iterator &other) const { return slot_ == other.slot_; }
+        bool operator!=(const robin_hood_map_iterator &other) const { return !(*this == other); }
+
+    private:
+        Slot *slot_ = nullptr;
+        Slot *end_ = nullptr;
+
+        void skip_free() noexcept {
+            while (slot_ != end_ and slot_->node == nullptr)
+                ++slot_;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_MAP_ITERATOR_H
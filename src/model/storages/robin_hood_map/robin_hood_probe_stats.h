@@ -0,0 +1,58 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_PROBE_STATS_H
+#define TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_PROBE_STATS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ttl {
+    /*
+     * Probe distances of the entries in a robin_hood_map, over every slot
+     * or an evenly spaced sample of them. distances[i] counts entries
+     * sitting i slots past their home; the last slot also takes every
+     * longer distance.
+     *
+     * A hit on an entry at distance d costs d + 1 probes. Robin Hood
+     * placement keeps the variance of d low (roughly constant in the load
+     * factor), so a high variance or max_distance means a clustering hash.
+     */
+    struct robin_hood_probe_stats {
+        static constexpr std::size_t kTrackedDistance = 16;
+
+        std::size_t slots = 0;
+        std::size_t sampled = 0;
+        std::size_t entries = 0;
+        std::size_t max_distance = 0;
+        std::vector<std::size_t> distances = std::vector<std::size_t>(kTrackedDistance + 1);
+
+        std::size_t distance_sum = 0;
+        std::size_t distance_squares = 0;
+
+        void add(std::size_t distance) {
+            ++entries;
+            max_distance = distance > max_distance ? distance : max_distance;
+            distances[distance < kTrackedDistance ? distance : kTrackedDistance]++;
+            distance_sum += distance;
+            distance_squares += distance * distance;
+        }
+
+        [[nodiscard]] double load_factor() const noexcept {
+            return sampled ? static_cast<double>(entries) / static_cast<double>(sampled) : 0.0;
+        }
+
+        [[nodiscard]] double mean_distance() const noexcept {
+            return entries ? static_cast<double>(distance_sum) / static_cast<double>(entries) : 0.0;
+        }
+
+        [[nodiscard]] double distance_variance() const noexcept {
+            if (entries == 0)
+                return 0.0;
+
+            const double mean = mean_distance();
+            return static_cast<double>(distance_squares) / static_cast<double>(entries) - mean * mean;
+        }
+
+        [[nodiscard]] double probes_per_hit() const noexcept { return entries ? 1.0 + mean_distance() : 0.0; }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_ROBIN_HOOD_PROBE_STATS_H
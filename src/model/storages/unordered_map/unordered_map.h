@@ -1,14 +1,31 @@
 #ifndef TRANSACTIONS_LIBRARY_CPP_HASH_TABLE_H
 #define TRANSACTIONS_LIBRARY_CPP_HASH_TABLE_H
 
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <unordered_map>
 #include <vector>
 #include <forward_list>
 
+#include "engine_stats.h"
+#include "memory_usage.h"
 #include "unordered_map_size.h"
+#include "unordered_map_cursor.h"
+#include "unordered_map_bitmap.h"
+#include "unordered_map_chain_stats.h"
+#include "unordered_map_hash.h"
+#include "unordered_map_overflow.h"
 #include "unordered_map_normal_iterator.h"
 
 namespace ttl {
-    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    /*
+     * Separate-chaining hash table. The default hash is keyed per instance
+     * (seeded_hash); a chain that still grows past kTreeifyLength gets a
+     * balanced-tree index (unordered_map_overflow) so a flooded bucket costs
+     * O(log n) per lookup instead of O(n).
+     */
+    template <typename Key, typename Value, typename Hash = seeded_hash<Key>>
     class unordered_map {
     public:
         using key_type = Key;
@@ -16,6 +33,10 @@ namespace ttl {
         using value_type = std::pair<const Key, Value>;
         using hash_type = Hash;
         using size_type = std::size_t;
+        using cursor_type = unordered_map_cursor;
+
+        static constexpr size_type kTreeifyLength = 8;
+        static constexpr size_type kUntreeifyLength = 6;
 
     private:
         using map_table_size = detail::unordered_map_size;
@@ -31,80 +52,120 @@ namespace ttl {
         using const_iterator = unordered_map_normal_iterator<table_const_iterator, bucket_const_iterator>;
 
     public:
-        unordered_map() noexcept = default;
-
-        std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type> &kv) {
-            if (map_.empty()) resize();
-
-            size_type hashed_key = hash_(kv.first);
-            size_type hashed_key_mod = hashed_key % map_table_size::size(size_index_);
+        unordered_map() = default;
+        explicit unordered_map(const hash_type &hash) : hash_(hash) {}
+
+        // buckets keep their order in the copy; the overflow indexes point into the source's lists, so they are rebuilt
+        unordered_map(const unordered_map &other)
+            : size_index_(other.size_index_), size_(other.size_), map_(other.map_), hash_(other.hash_),
+              occupied_(other.occupied_), first_occupied_(other.first_occupied_) {
+            treeified_.assign(map_.size());
+            for (size_type index = other.treeified_.find_next(0); index < map_.size();
+                 index = other.treeified_.find_next(index + 1))
+                treeify(index);
+        }
 
-            auto &bucket = map_[hashed_key_mod];
-            auto  table_it = map_.begin() + hashed_key_mod;
+        // the bucket array changes hands with its lists, so the overflow indexes stay valid
+        unordered_map(unordered_map &&other) noexcept
+            : size_index_(other.size_index_), size_(other.size_), map_(std::move(other.map_)),
+              hash_(std::move(other.hash_)), occupied_(std::move(other.occupied_)),
+              first_occupied_(other.first_occupied_), treeified_(std::move(other.treeified_)),
+              overflow_(std::move(other.overflow_)), stats_(other.stats_) {
+            other.release_table();
+        }
 
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it)
-                if (b_it->first == kv.first)
-                    return std::make_pair(iterator(table_it, b_it, map_.end()), false);
+        unordered_map &operator=(const unordered_map &other) {
+            if (this != &other) {
+                unordered_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
 
-            size_++;
-            update_alpha();
+        unordered_map &operator=(unordered_map &&other) noexcept {
+            if (this != &other) {
+                unordered_map moved(std::move(other));
+                swap(moved);
+            }
+            return *this;
+        }
 
-            hashed_key_mod = hashed_key % map_table_size::size(size_index_);
-            map_[hashed_key_mod].emplace_front(kv);
+        void swap(unordered_map &other) noexcept {
+            std::swap(size_index_, other.size_index_);
+            std::swap(size_, other.size_);
+            map_.swap(other.map_);
+            std::swap(hash_, other.hash_);
+            occupied_.swap(other.occupied_);
+            std::swap(first_occupied_, other.first_occupied_);
+            treeified_.swap(other.treeified_);
+            overflow_.swap(other.overflow_);
+            std::swap(stats_, other.stats_);
+        }
 
-            return std::make_pair(iterator(map_.begin() + hashed_key_mod, map_[hashed_key_mod].begin(), map_.end()), true);
+        std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type> &kv) {
+            return emplace_key(kv.first, kv.second);
         }
 
         std::pair<iterator, bool> insert(std::pair<key_type, mapped_type> &&kv) {
-            if (map_.empty()) resize();
-
-            size_type hashed_key = hash_(kv.first);
-            size_type hashed_key_mod = hashed_key % map_table_size::size(size_index_);
-
-            auto &bucket = map_[hashed_key_mod];
-            auto  table_it = map_.begin() + hashed_key_mod;
-
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it)
-                if (b_it->first == kv.first)
-                    return std::make_pair(iterator(table_it, b_it, map_.end()), false);
-
-            size_++;
-            update_alpha();
-
-            hashed_key_mod = hashed_key % map_table_size::size(size_index_);
-            map_[hashed_key_mod].emplace_front(std::move(kv));
-
-            return std::make_pair(iterator(map_.begin() + hashed_key_mod, map_[hashed_key_mod].begin(), map_.end()), true);
+            return emplace_key(std::move(kv.first), std::move(kv.second));
         }
 
-        mapped_type &operator[](const key_type &key) {
-            auto it = insert(std::make_pair(key, mapped_type{})).first;
-            return it->second;
+        // like std::unordered_map::try_emplace: the key is copied and the value built only when the key is new
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+            return emplace_key(key, std::forward<Args>(args)...);
         }
 
-        mapped_type &operator[](key_type &&key) {
-            auto it = insert(std::make_pair(std::move(key), mapped_type{})).first;
-            return it->second;
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
         }
 
+        mapped_type &operator[](const key_type &key) { return emplace_key(key).first->second; }
+        mapped_type &operator[](key_type &&key) { return emplace_key(std::move(key)).first->second; }
+
     public:
 
         iterator begin() noexcept {
-            for (auto tit = map_.begin(), tend = map_.end(); tit != tend; ++tit)
-                for (auto bit = tit->begin(), bend = tit->end(); bit != bend; ++bit)
-                    return iterator(tit, bit, map_.end());
-            return end();
+            if (first_occupied_ >= map_.size())
+                return end();
+
+            auto tit = map_.begin() + first_occupied_;
+            return make_iterator(tit, tit->begin());
         }
+
         const_iterator begin() const noexcept {
-            for (auto tit = map_.cbegin(), tend = map_.cend(); tit != tend; ++tit)
-                for (auto bit = tit->cbegin(), bend = tit->cend(); bit != bend; ++bit)
-                    return const_iterator(tit, bit, map_.end());
-            return end();
+            if (first_occupied_ >= map_.size())
+                return end();
+
+            auto tit = map_.cbegin() + first_occupied_;
+            return make_iterator(tit, tit->cbegin());
         }
 
         iterator end() noexcept { return iterator(map_.end()); }
         const_iterator end() const noexcept { return const_iterator(map_.end()); }
 
+        /*
+         * Cuts the table into at most `parts` disjoint iterator ranges over
+         * equal bucket spans, for scanning them independently.
+         */
+        std::vector<std::pair<iterator, iterator>> split(size_type parts) {
+            std::vector<std::pair<iterator, iterator>> ranges;
+            if (parts == 0 or empty())
+                return ranges;
+
+            const size_type buckets = map_.size();
+            iterator first = begin();
+            for (size_type part = 1; part <= parts; ++part) {
+                iterator last = part == parts ? end() : bucket_begin(buckets * part / parts);
+                if (first != last)
+                    ranges.emplace_back(first, last);
+                first = last;
+            }
+
+            return ranges;
+        }
+
     public:
         [[nodiscard]] size_type size() const noexcept { return size_; }
         [[nodiscard]] size_type capacity() const noexcept { return map_table_size::size(size_index_); }
@@ -115,94 +176,147 @@ namespace ttl {
         iterator find(const key_type &key) {
             if (empty()) return end();
 
-            size_type hashed_key_mod = hash_(key) % map_table_size::size(size_index_);
+            const size_type hashed_key = hash_(key);
+            const size_type index = hashed_key % map_.size();
 
-            auto &bucket = map_[hashed_key_mod];
-            auto table_it = map_.begin() + hashed_key_mod;
-
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it)
-                if (b_it->first == key)
-                    return iterator(table_it, b_it, map_.end());
-
-            return end();
+            auto [before, found] = find_before(index, hashed_key, key);
+            return found ? make_iterator(map_.begin() + index, std::next(before)) : end();
         }
 
-        iterator find(key_type &&key) {
-            if (empty()) return end();
+        iterator find(key_type &&key) { return find(static_cast<const key_type &>(key)); }
 
-            size_type hashed_key_mod = hash_(std::move(key)) % map_table_size::size(size_index_);
+    public:
+        bool erase(const key_type &key) {
+            if (empty()) return false;
 
-            auto &bucket = map_[hashed_key_mod];
-            auto table_it = map_.begin() + hashed_key_mod;
+            const size_type hashed_key = hash_(key);
+            const size_type index = hashed_key % map_.size();
 
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it)
-                if (b_it->first == std::move(key))
-                    return iterator(table_it, b_it, map_.end());
+            auto [before, found] = find_before(index, hashed_key, key);
+            if (!found)
+                return false;
 
-            return end();
+            unlink_after(index, hashed_key, before);
+            size_--;
+            stats_.erases++;
+            update_shrink();
+            return true;
         }
 
-    public:
-        bool erase(const key_type &key) {
-            if (empty()) return false;
+        bool erase(key_type &&key) { return erase(static_cast<const key_type &>(key)); }
 
-            size_type hashed_key_mod = hash_(key) % map_table_size::size(size_index_);
+        bool erase(iterator it) { return erase(it->first); }
 
-            auto &bucket = map_[hashed_key_mod];
-            if (bucket.empty())
-                return false;
+        /*
+         * Grows the table so that `items_count` entries fit without another
+         * rehash. Never shrinks it; existing entries are rehashed in place.
+         */
+        void reserve(std::size_t items_count) {
+            size_type index = fitting_size_index(items_count, map_table_size::kResizeAlpha);
+            if (index > size_index_)
+                rehash(index);
+        }
 
-            auto prev_b_it = bucket.before_begin();
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it) {
-                if (b_it->first == key) {
-                    bucket.erase_after(prev_b_it);
-                    size_--;
-                    return true;
-                }
-                ++prev_b_it;
+        /*
+         * Rehashes into the smallest table that holds the current entries
+         * under the growth load factor; an empty map releases its buckets.
+         * Invalidates iterators, like any rehash.
+         */
+        void shrink_to_fit() {
+            if (empty()) {
+                release_table();
+                return;
             }
 
-            return false;
+            size_type index = fitting_size_index(size_, map_table_size::kResizeAlpha);
+            if (index < size_index_)
+                rehash(index);
         }
 
-        bool erase(key_type &&key) {
-            if (empty()) return false;
+        [[nodiscard]] size_type bucket_count() const noexcept { return map_.size(); }
+        [[nodiscard]] size_type treeified_count() const noexcept { return overflow_.size(); }
 
-            size_type hashed_key_mod = hash_(std::move(key)) % map_table_size::size(size_index_);
+        /*
+         * Measures chain lengths over every bucket, or over `sample` evenly
+         * spaced buckets when that is fewer, which keeps it cheap enough to
+         * poll on a large table.
+         */
+        [[nodiscard]] unordered_map_chain_stats chain_stats(size_type sample = 0) const {
+            unordered_map_chain_stats stats;
+            stats.buckets = map_.size();
 
-            auto &bucket = map_[hashed_key_mod];
-            if (bucket.empty())
-                return false;
+            const size_type step = sample == 0 or sample >= map_.size() ? 1 : map_.size() / sample;
+            for (size_type index = 0; index < map_.size(); index += step)
+                stats.add(static_cast<size_type>(std::distance(map_[index].begin(), map_[index].end())));
 
-            auto prev_b_it = bucket.before_begin();
-            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it) {
-                if (b_it->first == std::move(key)) {
-                    bucket.erase_after(prev_b_it);
-                    size_--;
-                    return true;
+            return stats;
+        }
+
+        [[nodiscard]] const engine_stats &stats() const noexcept { return stats_; }
+        void reset_stats() noexcept { stats_ = engine_stats{}; }
+
+        /*
+         * Walks every entry to add up the heap its key and value own, unless
+         * `with_heap` is false; the table and node parts are O(1).
+         */
+        [[nodiscard]] memory_stats memory(bool with_heap = true) const {
+            memory_stats stats;
+            stats.entries = size_;
+            stats.buckets = map_.size();
+            stats.table_bytes = sizeof(*this) + occupied_.bytes() +
+                                detail::allocation_size(map_.capacity() * sizeof(typename map_type::value_type));
+            stats.node_bytes = size_ * detail::allocation_size(sizeof(void *) + sizeof(value_type));
+
+            if (with_heap)
+                for (const auto &kv : *this)
+                    stats.heap_bytes += heap_size(kv);
+            stats.payload_bytes = size_ * sizeof(value_type) + stats.heap_bytes;
+            return stats;
+        }
+
+        /*
+         * Calls functor for the entries of whole buckets starting at the
+         * cursor until at least `count` entries were visited, and returns the
+         * cursor to continue from (see unordered_map_cursor).
+         */
+        template <typename Functor>
+        cursor_type scan(cursor_type cursor, size_type count, Functor functor) {
+            if (empty())
+                return cursor_type{};
+
+            if (cursor.table != size_index_) {
+                if (cursor.table != 0 and cursor.table < map_table_size::sizes.size()) {
+                    cursor.filter_table = cursor.table;
+                    cursor.filter_bucket = cursor.bucket;
                 }
-                ++prev_b_it;
+                cursor.table = size_index_;
+                cursor.bucket = 0;
             }
 
-            return false;
-        }
+            if (cursor.filter_table >= map_table_size::sizes.size())
+                cursor.filter_table = cursor.filter_bucket = 0;
 
-        bool erase(iterator it) { return erase(it->first); }
+            const size_type buckets = map_.size();
+            const size_type filter_size = map_table_size::size(cursor.filter_table);
+            size_type visited = 0, empty_visits = 0;
 
-        void reserve(std::size_t items_count) {
-            if (!empty())
-                return;
+            while (cursor.bucket < buckets and visited < count and empty_visits < count * 10) {
+                auto &bucket = map_[cursor.bucket++];
+                if (bucket.empty()) {
+                    ++empty_visits;
+                    continue;
+                }
 
-            const auto &sizes = map_table_size::sizes;
-            std::size_t index = 0;
-            for (const auto &size : sizes) {
-                if (static_cast<double>(items_count) < map_table_size::kResizeAlpha * size) {
-                    map_.resize(size);
-                    size_index_ = index;
-                    return;
+                for (auto &kv : bucket) {
+                    if (filter_size != 0 and hash_(kv.first) % filter_size < cursor.filter_bucket)
+                        continue;
+
+                    functor(kv);
+                    ++visited;
                 }
-                ++index;
             }
+
+            return cursor.bucket < buckets ? cursor : cursor_type{};
         }
 
     private:
@@ -212,26 +326,207 @@ namespace ttl {
         map_type map_;
         hash_type hash_;
 
+        detail::unordered_map_bitmap occupied_;
+        size_type first_occupied_ = 0;
+
+        // buckets whose chains carry an overflow index; the bitmap keeps the common path to one bit test
+        using overflow_type = detail::unordered_map_overflow<key_type, bucket_iterator>;
+        detail::unordered_map_bitmap treeified_;
+        std::unordered_map<size_type, overflow_type> overflow_;
+
+        engine_stats stats_;
+
+        // back to the state of a default-constructed map, without buckets
+        void release_table() noexcept {
+            map_type().swap(map_);
+            occupied_.assign(0);
+            treeified_.assign(0);
+            overflow_.clear();
+            size_index_ = size_ = first_occupied_ = 0;
+        }
+
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> emplace_key(K &&key, Args &&...args) {
+            if (map_.empty()) resize();
+
+            const size_type hashed_key = hash_(key);
+            size_type index = hashed_key % map_.size();
+
+            auto [before, found] = find_before(index, hashed_key, key);
+            if (found)
+                return std::make_pair(make_iterator(map_.begin() + index, std::next(before)), false);
+
+            size_++;
+            stats_.inserts++;
+            update_alpha();
+
+            index = hashed_key % map_.size();
+            link_front(index, hashed_key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+            return std::make_pair(make_iterator(map_.begin() + index, map_[index].begin()), true);
+        }
+
+        // {iterator before the entry for `key`, whether it was found}
+        std::pair<bucket_iterator, bool> find_before(size_type index, size_type hashed_key, const key_type &key) {
+            auto &bucket = map_[index];
+            const size_type probes_before = stats_.lookup();
+
+            if (treeified_.test(index)) {
+                auto before = overflow_.find(index)->second.find(hashed_key, key, stats_.probes);
+                if (!before)
+                    return std::make_pair(bucket.before_begin(), false);
+
+                stats_.hit(probes_before);
+                return std::make_pair(*before, true);
+            }
+
+            auto prev_b_it = bucket.before_begin();
+            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it, ++prev_b_it) {
+                stats_.probes++;
+                if (b_it->first == key) {
+                    stats_.hit(probes_before);
+                    return std::make_pair(prev_b_it, true);
+                }
+            }
+
+            return std::make_pair(prev_b_it, false);
+        }
+
+        template <typename... Args>
+        void link_front(size_type index, size_type hashed_key, Args &&...args) {
+            auto &bucket = map_[index];
+            const auto old_front = bucket.begin();
+            bucket.emplace_front(std::forward<Args>(args)...);
+            mark_occupied(index);
+
+            if (treeified_.test(index)) {
+                auto &overflow = overflow_.find(index)->second;
+                if (old_front != bucket.end())
+                    overflow.relink(hash_(old_front->first), old_front->first, bucket.begin());
+                overflow.assign(hashed_key, bucket.begin()->first, bucket.before_begin());
+            } else if (static_cast<size_type>(std::distance(bucket.begin(), bucket.end())) > kTreeifyLength) {
+                treeify(index);
+            }
+        }
+
+        void unlink_after(size_type index, size_type hashed_key, bucket_iterator before) {
+            auto &bucket = map_[index];
+
+            if (treeified_.test(index)) {
+                auto &overflow = overflow_.find(index)->second;
+                auto node = std::next(before), next = std::next(node);
+                if (next != bucket.end())
+                    overflow.relink(hash_(next->first), next->first, before);
+                overflow.erase(hashed_key, node->first);
+
+                if (overflow.size() <= kUntreeifyLength) {
+                    overflow_.erase(index);
+                    treeified_.reset(index);
+                }
+            }
+
+            bucket.erase_after(before);
+            mark_erased(index);
+        }
+
+        void treeify(size_type index) {
+            auto &bucket = map_[index];
+            auto &overflow = overflow_[index];
+
+            auto prev_b_it = bucket.before_begin();
+            for (auto b_it = bucket.begin(), b_end = bucket.end(); b_it != b_end; ++b_it, ++prev_b_it)
+                overflow.assign(hash_(b_it->first), b_it->first, prev_b_it);
+
+            treeified_.set(index);
+        }
+
+        iterator bucket_begin(size_type index) noexcept {
+            size_type occupied = occupied_.find_next(index);
+            if (occupied >= map_.size())
+                return end();
+
+            auto tit = map_.begin() + occupied;
+            return make_iterator(tit, tit->begin());
+        }
+
+        iterator make_iterator(table_iterator table, bucket_iterator bucket) noexcept {
+            return iterator(table, bucket, map_.begin(), map_.end(), &occupied_);
+        }
+
+        const_iterator make_iterator(table_const_iterator table, bucket_const_iterator bucket) const noexcept {
+            return const_iterator(table, bucket, map_.cbegin(), map_.cend(), &occupied_);
+        }
+
+        void mark_occupied(size_type index) noexcept {
+            occupied_.set(index);
+            if (index < first_occupied_)
+                first_occupied_ = index;
+        }
+
+        void mark_erased(size_type index) noexcept {
+            if (!map_[index].empty())
+                return;
+
+            occupied_.reset(index);
+            if (index == first_occupied_)
+                first_occupied_ = occupied_.find_next(index + 1);
+        }
+
         [[nodiscard]] double get_alpha() const { return size_ / static_cast<double>(map_table_size::size(size_index_)); }
 
-        void resize() {
-            size_type new_map_size = map_table_size::size(++size_index_);
+        // smallest table index whose load factor stays under `alpha` with `items_count` entries
+        static size_type fitting_size_index(size_type items_count, double alpha) noexcept {
+            const auto &sizes = map_table_size::sizes;
+            for (size_type index = 1; index + 1 < sizes.size(); ++index)
+                if (static_cast<double>(items_count) < alpha * static_cast<double>(sizes[index]))
+                    return index;
+            return sizes.size() - 2;
+        }
+
+        void resize() { rehash(size_index_ + 1); }
+
+        void rehash(size_type size_index) {
+            stats_.rehashes++;
+            size_index_ = size_index;
+            size_type new_map_size = map_table_size::size(size_index_);
             map_type new_map(new_map_size);
+            detail::unordered_map_bitmap new_occupied;
+            new_occupied.assign(new_map_size);
 
+            // nodes are spliced, not copied: a rehash allocates only the new bucket array
             for (auto &bucket : map_) {
-                for (auto &&[key, value]: bucket) {
-                    std::size_t key_hash_mod = hash_(key) % new_map_size;
-                    new_map[key_hash_mod].emplace_front(std::move(key), std::move(value));
+                while (!bucket.empty()) {
+                    std::size_t key_hash_mod = hash_(bucket.front().first) % new_map_size;
+                    auto &target = new_map[key_hash_mod];
+                    target.splice_after(target.before_begin(), bucket, bucket.before_begin());
+                    new_occupied.set(key_hash_mod);
                 }
             }
 
             map_ = std::move(new_map);
+            occupied_.swap(new_occupied);
+            first_occupied_ = occupied_.find_next(0);
+
+            overflow_.clear();
+            treeified_.assign(new_map_size);
+            for (size_type index = occupied_.find_next(0); index < new_map_size; index = occupied_.find_next(index + 1))
+                if (static_cast<size_type>(std::distance(map_[index].begin(), map_[index].end())) > kTreeifyLength)
+                    treeify(index);
         }
 
         void update_alpha() noexcept {
             if (get_alpha() >= map_table_size::kResizeAlpha)
                 resize();
         }
+
+        void update_shrink() {
+            if (size_index_ <= 1 or get_alpha() >= map_table_size::kShrinkAlpha)
+                return;
+
+            size_type index = fitting_size_index(size_, map_table_size::kResizeAlpha / 2);
+            if (index < size_index_)
+                rehash(index);
+        }
     };
 }
 
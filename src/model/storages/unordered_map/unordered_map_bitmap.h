@@ -0,0 +1,63 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_BITMAP_H
+#define TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_BITMAP_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ttl::detail {
+    /*
+     * One bit per bucket, set while the bucket is non-empty. Iteration jumps
+     * straight to the next occupied bucket with ctz over 64-bit words instead
+     * of touching every empty forward_list in between.
+     */
+    class unordered_map_bitmap {
+    public:
+        using size_type = std::size_t;
+        using word_type = std::uint64_t;
+
+        static constexpr size_type kWordBits = std::numeric_limits<word_type>::digits;
+
+    public:
+        void assign(size_type bits) {
+            words_.assign((bits + kWordBits - 1) / kWordBits, word_type{});
+            size_ = bits;
+        }
+
+        [[nodiscard]] size_type size() const noexcept { return size_; }
+        [[nodiscard]] size_type bytes() const noexcept { return words_.capacity() * sizeof(word_type); }
+
+        void set(size_type index) noexcept { words_[index / kWordBits] |= bit(index); }
+        void reset(size_type index) noexcept { words_[index / kWordBits] &= ~bit(index); }
+        [[nodiscard]] bool test(size_type index) const noexcept { return words_[index / kWordBits] & bit(index); }
+
+        // first set bit at or after `from`, size() when there is none
+        [[nodiscard]] size_type find_next(size_type from) const noexcept {
+            if (from >= size_)
+                return size_;
+
+            size_type word = from / kWordBits;
+            word_type bits = words_[word] & (~word_type{} << (from % kWordBits));
+            while (bits == word_type{}) {
+                if (++word == words_.size())
+                    return size_;
+                bits = words_[word];
+            }
+
+            return word * kWordBits + static_cast<size_type>(__builtin_ctzll(bits));
+        }
+
+        void swap(unordered_map_bitmap &other) noexcept {
+            words_.swap(other.words_);
+            std::swap(size_, other.size_);
+        }
+
+    private:
+        std::vector<word_type> words_;
+        size_type size_ = 0;
+
+        static word_type bit(size_type index) noexcept { return word_type{1} << (index % kWordBits); }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_BITMAP_H
@@ -0,0 +1,58 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CHAIN_STATS_H
+#define TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CHAIN_STATS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ttl {
+    /*
+     * Shape of the bucket chains, over all buckets or an evenly spaced
+     * sample of them. lengths[i] counts buckets holding exactly i entries;
+     * the last slot also takes every longer chain.
+     *
+     * With a uniform hash a hit costs about 1 + load/2 probes and a miss
+     * about load probes; a hash that clusters keys shows up as chains far
+     * longer than that long before it shows up as latency.
+     */
+    struct unordered_map_chain_stats {
+        static constexpr std::size_t kTrackedLength = 16;
+        // degraded() once hits cost this many times what a uniform hash would
+        static constexpr double kDegradedFactor = 2.0;
+
+        std::size_t buckets = 0;
+        std::size_t sampled = 0;
+        std::size_t entries = 0;
+        std::size_t max_chain = 0;
+        std::vector<std::size_t> lengths = std::vector<std::size_t>(kTrackedLength + 1);
+
+        // sum over sampled chains of 1 + 2 + ... + length
+        std::size_t hit_probes = 0;
+
+        void add(std::size_t length) {
+            ++sampled;
+            entries += length;
+            max_chain = length > max_chain ? length : max_chain;
+            lengths[length < kTrackedLength ? length : kTrackedLength]++;
+            hit_probes += length * (length + 1) / 2;
+        }
+
+        [[nodiscard]] double load_factor() const noexcept {
+            return sampled ? static_cast<double>(entries) / static_cast<double>(sampled) : 0.0;
+        }
+
+        [[nodiscard]] double probes_per_hit() const noexcept {
+            return entries ? static_cast<double>(hit_probes) / static_cast<double>(entries) : 0.0;
+        }
+
+        // a miss walks the whole chain of a random bucket
+        [[nodiscard]] double probes_per_miss() const noexcept { return load_factor(); }
+
+        [[nodiscard]] double expected_probes_per_hit() const noexcept { return entries ? 1.0 + load_factor() / 2 : 0.0; }
+
+        [[nodiscard]] bool degraded() const noexcept {
+            return probes_per_hit() > kDegradedFactor * expected_probes_per_hit();
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CHAIN_STATS_H
@@ -0,0 +1,62 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CURSOR_H
+#define TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CURSOR_H
+
+#include <sstream>
+#include <string>
+
+namespace ttl {
+    /*
+     * Position of an incremental unordered_map scan. Buckets are indexed by
+     * hash % size with sizes that are not powers of two, so a reverse-binary
+     * cursor can't be used. Instead the cursor remembers the table it was
+     * issued against: after a resize the scan restarts on the new table and
+     * skips keys whose old bucket (hash % old size) was already visited.
+     * Keys present for the whole scan are returned at least once; a key may be
+     * returned twice when the table is resized more than once.
+     *
+     * A default cursor starts a scan, and a default cursor returned by scan()
+     * means it's finished.
+     */
+    struct unordered_map_cursor {
+        std::size_t table = 0;
+        std::size_t bucket = 0;
+        std::size_t filter_table = 0;
+        std::size_t filter_bucket = 0;
+
+        bool operator==(const unordered_map_cursor &other) const {
+            return table == other.table and bucket == other.bucket and
+                   filter_table == other.filter_table and filter_bucket == other.filter_bucket;
+        }
+
+        bool operator!=(const unordered_map_cursor &other) const { return !(*this == other); }
+    };
+
+    inline std::string to_string(const unordered_map_cursor &cursor) {
+        if (cursor == unordered_map_cursor{})
+            return "0";
+
+        std::string text = std::to_string(cursor.table) + '.' + std::to_string(cursor.bucket);
+        if (cursor.filter_table != 0)
+            text += '.' + std::to_string(cursor.filter_table) + '.' + std::to_string(cursor.filter_bucket);
+        return text;
+    }
+
+    inline bool parse_cursor(const std::string &text, unordered_map_cursor &cursor) {
+        cursor = unordered_map_cursor{};
+        if (text == "0")
+            return true;
+
+        std::istringstream ss(text);
+        char dot1 = 0, dot2 = 0, dot3 = 0;
+        if (!(ss >> cursor.table >> dot1 >> cursor.bucket) or dot1 != '.')
+            return false;
+
+        if (ss.peek() == std::char_traits<char>::eof())
+            return true;
+
+        return (ss >> dot2 >> cursor.filter_table >> dot3 >> cursor.filter_bucket) and dot2 == '.' and dot3 == '.' and
+               ss.peek() == std::char_traits<char>::eof();
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_CURSOR_H
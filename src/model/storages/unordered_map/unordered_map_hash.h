@@ -0,0 +1,113 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_HASH_H
+#define TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_HASH_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ttl {
+    namespace detail {
+        inline std::uint64_t rotl(std::uint64_t x, unsigned bits) noexcept { return (x << bits) | (x >> (64 - bits)); }
+
+        /*
+         * SipHash-1-3 (one compression round, three finalization rounds) of
+         * `size` bytes under the 128-bit key (k0, k1). Blocks are read in host
+         * order, which is the reference little-endian order on x86 and ARM.
+         */
+        inline std::uint64_t siphash13(std::uint64_t k0, std::uint64_t k1, const void *data, std::size_t size) noexcept {
+            std::uint64_t v0 = k0 ^ 0x736f6d6570736575ull;
+            std::uint64_t v1 = k1 ^ 0x646f72616e646f6dull;
+            std::uint64_t v2 = k0 ^ 0x6c7967656e657261ull;
+            std::uint64_t v3 = k1 ^ 0x7465646279746573ull;
+
+            auto round = [&] {
+                v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+                v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+                v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+                v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+            };
+
+            const auto *bytes = static_cast<const unsigned char *>(data);
+            const std::size_t blocks = size / 8;
+            for (std::size_t i = 0; i != blocks; ++i) {
+                std::uint64_t m;
+                std::memcpy(&m, bytes + i * 8, 8);
+                v3 ^= m;
+                round();
+                v0 ^= m;
+            }
+
+            std::uint64_t last = static_cast<std::uint64_t>(size) << 56;
+            for (std::size_t i = 0, tail = size % 8; i != tail; ++i)
+                last |= static_cast<std::uint64_t>(bytes[blocks * 8 + i]) << (8 * i);
+
+            v3 ^= last;
+            round();
+            v0 ^= last;
+
+            v2 ^= 0xff;
+            round();
+            round();
+            round();
+            return v0 ^ v1 ^ v2 ^ v3;
+        }
+
+        inline std::uint64_t splitmix64(std::uint64_t &state) noexcept {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        // a fresh key for every call: one random_device draw per process, then a counter
+        inline std::pair<std::uint64_t, std::uint64_t> next_hash_key() noexcept {
+            static const std::uint64_t kProcessSeed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^
+                                                      std::random_device{}();
+            static std::atomic<std::uint64_t> counter {0};
+
+            std::uint64_t state = kProcessSeed ^ (counter.fetch_add(1, std::memory_order_relaxed) * 0xd1b54a32d192ed03ull);
+            const std::uint64_t k0 = splitmix64(state);
+            return {k0, splitmix64(state)};
+        }
+    }
+
+    /*
+     * Keyed hash for unordered_map: every default-constructed instance draws
+     * its own random key, so bucket placement can't be predicted (or
+     * flooded) from outside. Strings are hashed byte-wise with SipHash-1-3;
+     * other keys hash their std::hash value under the same key.
+     */
+    template <typename Key>
+    class seeded_hash {
+    public:
+        seeded_hash() noexcept {
+            auto [k0, k1] = detail::next_hash_key();
+            k0_ = k0;
+            k1_ = k1;
+        }
+
+        seeded_hash(std::uint64_t k0, std::uint64_t k1) noexcept : k0_(k0), k1_(k1) {}
+
+        std::size_t operator()(const Key &key) const noexcept {
+            if constexpr (std::is_convertible_v<const Key &, std::string_view>) {
+                std::string_view view = key;
+                return static_cast<std::size_t>(detail::siphash13(k0_, k1_, view.data(), view.size()));
+            } else {
+                const std::uint64_t value = std::hash<Key>{}(key);
+                return static_cast<std::size_t>(detail::siphash13(k0_, k1_, &value, sizeof(value)));
+            }
+        }
+
+    private:
+        std::uint64_t k0_;
+        std::uint64_t k1_;
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_HASH_H
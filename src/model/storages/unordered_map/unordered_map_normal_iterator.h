@@ -3,6 +3,8 @@
 
 #include <iterator>
 
+#include "unordered_map_bitmap.h"
+
 namespace ttl {
     template <typename TableIterator, typename BucketIterator>
     class unordered_map_normal_iterator {
@@ -11,8 +13,10 @@ namespace ttl {
         using pointer = typename BucketIterator::pointer;
         using reference = typename BucketIterator::reference;
 
-        explicit unordered_map_normal_iterator(TableIterator it) : table_(it) {}
-        unordered_map_normal_iterator(TableIterator main, BucketIterator bucket, TableIterator end) : table_(main), bucket_(bucket), end_(end) {};
+        explicit unordered_map_normal_iterator(TableIterator it) : table_(it), end_(it) {}
+        unordered_map_normal_iterator(TableIterator main, BucketIterator bucket, TableIterator begin, TableIterator end,
+                                      const detail::unordered_map_bitmap *occupied)
+            : table_(main), bucket_(bucket), begin_(begin), end_(end), occupied_(occupied) {};
 
         reference operator*() const {
             return *bucket_;
@@ -28,15 +32,11 @@ namespace ttl {
                 return *this;
             }
 
-            ++table_;
-            while (table_->empty()) {
-                if (table_ != end_)
-                    ++table_;
-                else
-                    return *this;
-            }
+            auto index = static_cast<std::size_t>(table_ - begin_);
+            table_ = begin_ + static_cast<std::ptrdiff_t>(occupied_->find_next(index + 1));
+            if (table_ != end_)
+                bucket_ = table_->begin();
 
-            bucket_ = table_->begin();
             return *this;
         }
 
@@ -47,17 +47,19 @@ namespace ttl {
         }
 
         bool operator==(const unordered_map_normal_iterator &other) const {
-            return table_ == other.table_;
+            return table_ == other.table_ and (table_ == end_ or bucket_ == other.bucket_);
         }
 
         bool operator!=(const unordered_map_normal_iterator &other) const {
-            return table_ != other.table_;
+            return !(*this == other);
         }
 
     private:
         TableIterator table_;
         BucketIterator bucket_;
+        TableIterator begin_;
         TableIterator end_;
+        const detail::unordered_map_bitmap *occupied_ = nullptr;
     };
 }
 
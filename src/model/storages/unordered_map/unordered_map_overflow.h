@@ -0,0 +1,81 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_OVERFLOW_H
+#define TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_OVERFLOW_H
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ttl::detail {
+    template <typename Key, typename = void>
+    struct is_less_comparable : std::false_type {};
+
+    template <typename Key>
+    struct is_less_comparable<Key, std::void_t<decltype(std::declval<const Key &>() < std::declval<const Key &>())>>
+        : std::true_type {};
+
+    /*
+     * Balanced-tree index over one overflowing bucket chain, the way Java's
+     * HashMap treeifies a bin. Entries stay in the bucket's forward_list, so
+     * iterators and scans don't change; the index maps (full hash, key) to
+     * the list iterator *before* each entry, which is what erase_after needs.
+     * Keys that can't be ordered fall back to a walk among equal full hashes.
+     */
+    template <typename Key, typename BucketIterator>
+    class unordered_map_overflow {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+
+    public:
+        [[nodiscard]] size_type size() const noexcept { return entries_.size(); }
+
+        void assign(size_type hash, const key_type &key, BucketIterator before) {
+            entries_.emplace(entry_key{hash, &key}, before);
+        }
+
+        // iterator before the entry for `key`; `probes` counts the keys compared
+        std::optional<BucketIterator> find(size_type hash, const key_type &key, size_type &probes) const {
+            for (auto [it, last] = entries_.equal_range(entry_key{hash, &key}); it != last; ++it) {
+                ++probes;
+                if (*it->first.key == key)
+                    return it->second;
+            }
+            return std::nullopt;
+        }
+
+        // `key` must be the key stored in the bucket, entries are matched by address
+        void relink(size_type hash, const key_type &key, BucketIterator before) { locate(hash, key)->second = before; }
+        void erase(size_type hash, const key_type &key) { entries_.erase(locate(hash, key)); }
+
+    private:
+        struct entry_key {
+            size_type hash;
+            const key_type *key;
+        };
+
+        struct entry_less {
+            bool operator()(const entry_key &lhs, const entry_key &rhs) const {
+                if (lhs.hash != rhs.hash)
+                    return lhs.hash < rhs.hash;
+                if constexpr (is_less_comparable<key_type>::value)
+                    return *lhs.key < *rhs.key;
+                else
+                    return false;
+            }
+        };
+
+        using entries_type = std::multimap<entry_key, BucketIterator, entry_less>;
+        entries_type entries_;
+
+        typename entries_type::iterator locate(size_type hash, const key_type &key) {
+            auto [it, last] = entries_.equal_range(entry_key{hash, &key});
+            while (it != last and it->first.key != &key)
+                ++it;
+            return it;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_UNORDERED_MAP_OVERFLOW_H
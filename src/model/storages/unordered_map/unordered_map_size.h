@@ -8,6 +8,7 @@ namespace ttl::detail {
     struct unordered_map_size {
         static const std::array<unsigned long long, 31> sizes;
         static const double kResizeAlpha;
+        static const double kShrinkAlpha;
 
         static std::size_t size(std::size_t index) {
             return sizes[index];
@@ -35,6 +36,13 @@ namespace ttl::detail {
 
     inline constexpr double unordered_map_size::kResizeAlpha = 0.75;
 
+    /*
+     * The table shrinks only once the load factor drops below kShrinkAlpha,
+     * and then to the smallest size that keeps it under kResizeAlpha / 2.
+     * The gap keeps insert/erase at a boundary from rehashing back and forth.
+     */
+    inline constexpr double unordered_map_size::kShrinkAlpha = 0.125;
+
     /*
      *
      * 1st array is:  sum of 2nd array from 0 to i element
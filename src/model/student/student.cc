@@ -1,9 +1,14 @@
 #include "student.h"
+#include "memory_usage.h"
 
 #include <iostream>
 #include <string>
 #include <chrono>
 
+std::size_t ttl::heap_size(const Student &student) noexcept {
+    return heap_size(student.surname) + heap_size(student.name) + heap_size(student.city);
+}
+
 [[nodiscard]] bool operator==(const ttl::Student &lhs, const ttl::Student &rhs) {
     if (lhs.surname != rhs.surname and rhs.surname != "-")
         return false;
@@ -29,6 +29,9 @@ namespace ttl {
             return *this;
         }
     };
+
+    // heap owned by the string fields, for memory accounting (see memory_usage.h)
+    [[nodiscard]] std::size_t heap_size(const Student &student) noexcept;
 }
 
 [[nodiscard]] bool operator==(const ttl::Student &lhs, const ttl::Student &rhs);
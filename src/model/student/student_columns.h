@@ -0,0 +1,265 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_COLUMNS_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_COLUMNS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "student.h"
+#include "student_kernels.h"
+
+namespace ttl {
+    namespace detail {
+        /*
+         * Append-only string dictionary: every distinct value gets a dense
+         * 32-bit code, so string columns are stored and compared as integers.
+         */
+        class student_dictionary {
+        public:
+            using code_type = std::uint32_t;
+            using size_type = std::size_t;
+
+            static constexpr code_type kNoCode = std::numeric_limits<code_type>::max();
+
+        public:
+            code_type encode(const std::string &value) {
+                auto [it, inserted] = codes_.try_emplace(value, static_cast<code_type>(values_.size()));
+                if (inserted)
+                    values_.push_back(value);
+                return it->second;
+            }
+
+            [[nodiscard]] code_type lookup(const std::string &value) const {
+                auto it = codes_.find(value);
+                return it == codes_.end() ? kNoCode : it->second;
+            }
+
+            [[nodiscard]] const std::string &decode(code_type code) const { return values_[code]; }
+            [[nodiscard]] size_type size() const noexcept { return values_.size(); }
+
+            void clear() noexcept {
+                values_.clear();
+                codes_.clear();
+            }
+
+        private:
+            std::vector<std::string> values_;
+            std::unordered_map<std::string, code_type> codes_;
+        };
+    }
+
+    /*
+     * Struct-of-arrays copy of Student records: one contiguous column per field.
+     * Rows are kept dense (erase moves the last row into the hole), so a FIND
+     * pattern is evaluated as a few linear passes over int/code columns that
+     * produce a selection bitmap, one bit per row.
+     */
+    template <typename Key>
+    class student_columns {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+        using code_type = detail::student_dictionary::code_type;
+        using word_type = std::uint64_t;
+        using selection_type = std::vector<word_type>;
+
+        static constexpr size_type kWordBits = std::numeric_limits<word_type>::digits;
+
+    public:
+        [[nodiscard]] size_type size() const noexcept { return keys_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+
+        void reserve(size_type rows_count) {
+            keys_.reserve(rows_count);
+            surnames_.reserve(rows_count);
+            names_.reserve(rows_count);
+            cities_.reserve(rows_count);
+            years_.reserve(rows_count);
+            coins_.reserve(rows_count);
+            times_.reserve(rows_count);
+            life_begins_.reserve(rows_count);
+            rows_.reserve(rows_count);
+        }
+
+        void assign(const key_type &key, const Student &student) {
+            auto [it, inserted] = rows_.try_emplace(key, keys_.size());
+            if (inserted) {
+                keys_.push_back(key);
+                surnames_.emplace_back();
+                names_.emplace_back();
+                cities_.emplace_back();
+                years_.emplace_back();
+                coins_.emplace_back();
+                times_.emplace_back();
+                life_begins_.emplace_back();
+            }
+
+            const size_type row = it->second;
+            surnames_[row] = surnames_dictionary_.encode(student.surname);
+            names_[row] = names_dictionary_.encode(student.name);
+            cities_[row] = cities_dictionary_.encode(student.city);
+            years_[row] = student.year;
+            coins_[row] = student.coins;
+            times_[row] = student.time;
+            life_begins_[row] = student.life_begin;
+        }
+
+        bool erase(const key_type &key) {
+            auto it = rows_.find(key);
+            if (it == rows_.end())
+                return false;
+
+            const size_type row = it->second, last = keys_.size() - 1;
+            rows_.erase(it);
+
+            if (row != last) {
+                rows_[keys_[last]] = row;
+                keys_[row] = std::move(keys_[last]);
+                surnames_[row] = surnames_[last];
+                names_[row] = names_[last];
+                cities_[row] = cities_[last];
+                years_[row] = years_[last];
+                coins_[row] = coins_[last];
+                times_[row] = times_[last];
+                life_begins_[row] = life_begins_[last];
+            }
+
+            keys_.pop_back();
+            surnames_.pop_back();
+            names_.pop_back();
+            cities_.pop_back();
+            years_.pop_back();
+            coins_.pop_back();
+            times_.pop_back();
+            life_begins_.pop_back();
+            return true;
+        }
+
+        void clear() noexcept {
+            keys_.clear();
+            surnames_.clear();
+            names_.clear();
+            cities_.clear();
+            years_.clear();
+            coins_.clear();
+            times_.clear();
+            life_begins_.clear();
+            rows_.clear();
+            surnames_dictionary_.clear();
+            names_dictionary_.clear();
+            cities_dictionary_.clear();
+        }
+
+    public:
+        /*
+         * Uses the same wildcard rules as operator==(Student, Student):
+         * "-" in a string field and -1 in an int field match anything.
+         */
+        [[nodiscard]] selection_type find(const Student &pattern) const {
+            selection_type selection = all();
+
+            if (!filter_string(surnames_, surnames_dictionary_, pattern.surname, selection) or
+                !filter_string(names_, names_dictionary_, pattern.name, selection) or
+                !filter_string(cities_, cities_dictionary_, pattern.city, selection))
+                return selection_type(selection.size(), word_type{});
+
+            if (pattern.year != -1)
+                filter_equal(years_, pattern.year, selection);
+            if (pattern.coins != -1)
+                filter_equal(coins_, pattern.coins, selection);
+
+            return selection;
+        }
+
+        [[nodiscard]] selection_type all() const {
+            selection_type selection((size() + kWordBits - 1) / kWordBits, ~word_type{});
+            if (size_type tail = size() % kWordBits; tail != 0)
+                selection.back() = (word_type{1} << tail) - 1;
+            return selection;
+        }
+
+        template <typename Functor>
+        static void for_each(const selection_type &selection, Functor functor) {
+            for (size_type w = 0, words = selection.size(); w != words; ++w) {
+                for (word_type bits = selection[w]; bits; bits &= bits - 1)
+                    functor(w * kWordBits + static_cast<size_type>(__builtin_ctzll(bits)));
+            }
+        }
+
+        static size_type count(const selection_type &selection) {
+            size_type result = 0;
+            for (word_type bits : selection)
+                result += static_cast<size_type>(__builtin_popcountll(bits));
+            return result;
+        }
+
+    public:
+        [[nodiscard]] const key_type &key(size_type row) const { return keys_[row]; }
+        [[nodiscard]] int time(size_type row) const { return times_[row]; }
+        [[nodiscard]] time_point_t life_begin(size_type row) const { return life_begins_[row]; }
+
+        [[nodiscard]] Student record(size_type row) const {
+            Student student;
+            student.surname = surnames_dictionary_.decode(surnames_[row]);
+            student.name = names_dictionary_.decode(names_[row]);
+            student.city = cities_dictionary_.decode(cities_[row]);
+            student.year = years_[row];
+            student.coins = coins_[row];
+            student.time = times_[row];
+            student.life_begin = life_begins_[row];
+            return student;
+        }
+
+    private:
+        std::vector<key_type> keys_;
+        std::vector<code_type> surnames_;
+        std::vector<code_type> names_;
+        std::vector<code_type> cities_;
+        std::vector<int> years_;
+        std::vector<int> coins_;
+        std::vector<int> times_;
+        std::vector<time_point_t> life_begins_;
+
+        std::unordered_map<key_type, size_type> rows_;
+
+        detail::student_dictionary surnames_dictionary_;
+        detail::student_dictionary names_dictionary_;
+        detail::student_dictionary cities_dictionary_;
+
+        static bool filter_string(const std::vector<code_type> &column, const detail::student_dictionary &dictionary,
+                                  const std::string &value, selection_type &selection) {
+            if (value == "-")
+                return true;
+
+            code_type code = dictionary.lookup(value);
+            if (code == detail::student_dictionary::kNoCode)
+                return false;
+
+            filter_equal(column, code, selection);
+            return true;
+        }
+
+        template <typename T>
+        static void filter_equal(const std::vector<T> &column, T value, selection_type &selection) {
+            static_assert(sizeof(T) == sizeof(std::uint32_t), "column kernel works on 32-bit values");
+
+            const size_type rows = column.size();
+            const auto *data = reinterpret_cast<const std::uint32_t *>(column.data());
+            const auto needle = static_cast<std::uint32_t>(value);
+
+            for (size_type w = 0, words = selection.size(); w != words; ++w) {
+                if (selection[w] == word_type{})
+                    continue;
+
+                const size_type first = w * kWordBits;
+                const size_type last = std::min(first + kWordBits, rows);
+                selection[w] &= detail::equal_mask(data + first, last - first, needle);
+            }
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_COLUMNS_H
@@ -0,0 +1,174 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_GENERATOR_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_GENERATOR_H
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "scan_executor.h"
+#include "student.h"
+#include "student_snapshot.h"
+
+namespace ttl {
+    struct student_generator_options {
+        std::size_t count = 0;
+        // keys are the record number zero-padded to at least this many digits
+        std::size_t key_length = 8;
+        // share of records written with an EX life time in [1, max_ttl] seconds
+        double ttl_fraction = 0.0;
+        int max_ttl = 3600;
+        std::uint64_t seed = 42;
+    };
+
+    /*
+     * Varied Student records for UPLOAD, FIND and index benchmarks: names
+     * and surnames from dictionaries, cities skewed toward the first
+     * (largest) ones, years clustered around 2000 and coins with a long
+     * tail. Records are produced in chunks on a ScanExecutor; each chunk
+     * seeds its own generator from (seed, chunk), so the output is the
+     * same for any number of threads.
+     */
+    class student_generator {
+    public:
+        static constexpr std::size_t kChunkRecords = 1 << 15;
+
+        explicit student_generator(student_generator_options options) : options_(options) {}
+
+        [[nodiscard]] const student_generator_options &options() const noexcept { return options_; }
+
+        template <typename URBG>
+        Student record(URBG &generator) const {
+            std::uniform_int_distribution<std::size_t> surname(0, kSurnames.size() - 1);
+            std::uniform_int_distribution<std::size_t> name(0, kNames.size() - 1);
+            std::normal_distribution<double> year(2000.0, 6.0);
+            std::geometric_distribution<int> coins(1.0 / 500.0);
+            std::bernoulli_distribution expires(options_.ttl_fraction);
+            std::uniform_int_distribution<int> ttl(1, std::max(1, options_.max_ttl));
+
+            Student student;
+            student.surname = kSurnames[surname(generator)];
+            student.name = kNames[name(generator)];
+            student.city = kCities[cities()(generator)];
+            student.year = std::clamp(static_cast<int>(year(generator)), 1950, 2010);
+            student.coins = std::min(coins(generator), 1'000'000);
+            if (expires(generator))
+                student.time = ttl(generator);
+            return student;
+        }
+
+        [[nodiscard]] std::string key(std::size_t index) const {
+            std::string digits = std::to_string(index + 1);
+            if (digits.size() < options_.key_length)
+                digits.insert(0, options_.key_length - digits.size(), '0');
+            return digits;
+        }
+
+        // "surname name year city coins [EX ttl]", the fields SET and UPLOAD read
+        static void append_fields(std::string &buffer, const Student &student) {
+            buffer += student.surname;
+            buffer += ' ';
+            buffer += student.name;
+            buffer += ' ';
+            append_number(buffer, student.year);
+            buffer += ' ';
+            buffer += student.city;
+            buffer += ' ';
+            append_number(buffer, student.coins);
+            if (student.time != -1) {
+                buffer += " EX ";
+                append_number(buffer, student.time);
+            }
+        }
+
+        // UPLOAD text format, one "key fields" line per record
+        void write_text(std::ostream &out, ScanExecutor &executor) const {
+            write(out, executor, [](std::string &buffer, const std::string &key, const Student &student) {
+                buffer += key;
+                buffer += ' ';
+                append_fields(buffer, student);
+                buffer += '\n';
+            });
+        }
+
+        void write_snapshot(std::ostream &out, ScanExecutor &executor) const {
+            snapshot::write_header(out, options_.count);
+            write(out, executor, snapshot::append_record);
+        }
+
+    private:
+        static constexpr std::array<const char *, 32> kSurnames = {
+            "Ivanov", "Petrov", "Sidorov", "Smirnov", "Kuznetsov", "Popov", "Vasiliev", "Sokolov",
+            "Mikhailov", "Novikov", "Fedorov", "Morozov", "Volkov", "Alekseev", "Lebedev", "Semenov",
+            "Egorov", "Pavlov", "Kozlov", "Stepanov", "Nikolaev", "Orlov", "Andreev", "Makarov",
+            "Nikitin", "Zakharov", "Zaitsev", "Soloviev", "Borisov", "Yakovlev", "Grigoriev", "Romanov"};
+        static constexpr std::array<const char *, 32> kNames = {
+            "Ivan", "Petr", "Anna", "Olga", "Nikita", "Maria", "Artem", "Elena",
+            "Dmitry", "Sofia", "Maxim", "Daria", "Alexey", "Polina", "Sergey", "Anastasia",
+            "Andrey", "Ekaterina", "Mikhail", "Victoria", "Egor", "Ksenia", "Kirill", "Alina",
+            "Roman", "Valeria", "Pavel", "Yulia", "Denis", "Irina", "Timur", "Nurislam"};
+        static constexpr std::array<const char *, 24> kCities = {
+            "Moscow", "Saint-Petersburg", "Novosibirsk", "Yekaterinburg", "Kazan", "Nizhny-Novgorod",
+            "Chelyabinsk", "Samara", "Omsk", "Rostov", "Ufa", "Krasnoyarsk",
+            "Voronezh", "Perm", "Volgograd", "Krasnodar", "Saratov", "Tyumen",
+            "Tolyatti", "Izhevsk", "Barnaul", "Ulyanovsk", "Irkutsk", "Tver"};
+
+        student_generator_options options_;
+
+        // city i is picked with weight 1 / (i + 1)
+        static std::discrete_distribution<std::size_t> &cities() {
+            thread_local std::discrete_distribution<std::size_t> distribution = [] {
+                std::vector<double> weights(kCities.size());
+                for (std::size_t i = 0; i != weights.size(); ++i)
+                    weights[i] = 1.0 / static_cast<double>(i + 1);
+                return std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+            }();
+            return distribution;
+        }
+
+        static void append_number(std::string &buffer, int value) {
+            char digits[16];
+            auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer.append(digits, end);
+        }
+
+        /*
+         * Fills one buffer per chunk in parallel, a batch of chunks at a
+         * time, and writes the batch in chunk order with one write call
+         * per chunk, so memory stays at a few chunks per thread.
+         */
+        template <typename Format>
+        void write(std::ostream &out, ScanExecutor &executor, Format format) const {
+            const std::size_t chunks = (options_.count + kChunkRecords - 1) / kChunkRecords;
+            const std::size_t batch = executor.threads() * ScanExecutor::kPartsPerThread;
+            std::vector<std::string> buffers(batch);
+
+            for (std::size_t first = 0; first < chunks; first += batch) {
+                const std::size_t last = std::min(chunks, first + batch);
+                executor.ForEach(last - first, [&](std::size_t offset) {
+                    const std::size_t chunk = first + offset;
+                    std::seed_seq seed {static_cast<std::uint32_t>(options_.seed),
+                                        static_cast<std::uint32_t>(options_.seed >> 32),
+                                        static_cast<std::uint32_t>(chunk),
+                                        static_cast<std::uint32_t>(static_cast<std::uint64_t>(chunk) >> 32)};
+                    std::mt19937_64 generator(seed);
+
+                    std::string &buffer = buffers[offset];
+                    buffer.clear();
+                    const std::size_t begin = chunk * kChunkRecords;
+                    for (std::size_t i = begin, end = std::min(options_.count, begin + kChunkRecords); i != end; ++i)
+                        format(buffer, key(i), record(generator));
+                });
+
+                for (std::size_t offset = 0; offset != last - first; ++offset)
+                    out.write(buffers[offset].data(), static_cast<std::streamsize>(buffers[offset].size()));
+            }
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_GENERATOR_H
@@ -0,0 +1,286 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_INDEX_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_INDEX_H
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "student.h"
+
+namespace ttl {
+    enum class student_field : std::size_t {
+        kSurname,
+        kName,
+        kYear,
+        kCity,
+        kCoins,
+        kCount
+    };
+
+    enum class student_index_type : bool {
+        kHash,
+        kOrdered
+    };
+
+    namespace detail {
+        template <student_field Field> struct student_field_traits;
+
+        template <> struct student_field_traits<student_field::kSurname> {
+            using value_type = std::string;
+            static const value_type &get(const Student &student) { return student.surname; }
+        };
+
+        template <> struct student_field_traits<student_field::kName> {
+            using value_type = std::string;
+            static const value_type &get(const Student &student) { return student.name; }
+        };
+
+        template <> struct student_field_traits<student_field::kYear> {
+            using value_type = int;
+            static const value_type &get(const Student &student) { return student.year; }
+        };
+
+        template <> struct student_field_traits<student_field::kCity> {
+            using value_type = std::string;
+            static const value_type &get(const Student &student) { return student.city; }
+        };
+
+        template <> struct student_field_traits<student_field::kCoins> {
+            using value_type = int;
+            static const value_type &get(const Student &student) { return student.coins; }
+        };
+
+        inline bool is_wildcard(const std::string &value) { return value == "-"; }
+        inline bool is_wildcard(int value) { return value == -1; }
+
+        inline std::optional<int> parse_field_value(const std::string &text, int) {
+            try {
+                return std::stoi(text);
+            } catch (std::exception &) {
+                return std::nullopt;
+            }
+        }
+
+        inline std::optional<std::string> parse_field_value(const std::string &text, const std::string &) {
+            return text;
+        }
+
+        inline constexpr std::array<const char *, static_cast<std::size_t>(student_field::kCount)> kStudentFieldNames = {
+                "surname", "name", "year", "city", "coins"
+        };
+    }
+
+    inline std::optional<student_field> parse_student_field(const std::string &name) {
+        const auto &names = detail::kStudentFieldNames;
+        for (std::size_t i = 0; i != names.size(); ++i)
+            if (name == names[i])
+                return static_cast<student_field>(i);
+        return std::nullopt;
+    }
+
+    inline const char *student_field_name(student_field field) {
+        return detail::kStudentFieldNames[static_cast<std::size_t>(field)];
+    }
+
+    /*
+     * Secondary index over one Student field: field value -> keys holding it.
+     * The index remembers the value it filed every key under, so updates and
+     * erases need only the key.
+     */
+    template <typename Key>
+    class istudent_index {
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+        using postings_type = std::unordered_set<key_type>;
+
+        virtual ~istudent_index() = default;
+
+        virtual void assign(const key_type &key, const Student &student) = 0;
+        virtual void erase(const key_type &key) = 0;
+
+        // nullptr when the pattern leaves the indexed field as a wildcard
+        [[nodiscard]] virtual const postings_type *lookup(const Student &pattern) const = 0;
+
+        // false when the index can't answer range queries (hash index or bad bounds)
+        virtual bool range(const std::string &from, const std::string &to, std::vector<key_type> &keys) const = 0;
+
+        [[nodiscard]] virtual student_field field() const noexcept = 0;
+        [[nodiscard]] virtual student_index_type type() const noexcept = 0;
+        [[nodiscard]] virtual size_type values_count() const noexcept = 0;
+    };
+
+    template <typename Key, student_field Field, student_index_type Type>
+    class student_field_index final : public istudent_index<Key> {
+    public:
+        using typename istudent_index<Key>::key_type;
+        using typename istudent_index<Key>::size_type;
+        using typename istudent_index<Key>::postings_type;
+
+        using traits_type = detail::student_field_traits<Field>;
+        using value_type = typename traits_type::value_type;
+        using table_type = std::conditional_t<Type == student_index_type::kHash,
+                                              std::unordered_map<value_type, postings_type>,
+                                              std::map<value_type, postings_type>>;
+
+    public:
+        void assign(const key_type &key, const Student &student) override {
+            const value_type &value = traits_type::get(student);
+
+            auto [it, inserted] = values_.try_emplace(key, value);
+            if (!inserted) {
+                if (it->second == value)
+                    return;
+
+                unlink(key, it->second);
+                it->second = value;
+            }
+
+            table_[value].insert(key);
+        }
+
+        void erase(const key_type &key) override {
+            auto it = values_.find(key);
+            if (it == values_.end())
+                return;
+
+            unlink(key, it->second);
+            values_.erase(it);
+        }
+
+        [[nodiscard]] const postings_type *lookup(const Student &pattern) const override {
+            static const postings_type kEmpty;
+
+            const value_type &value = traits_type::get(pattern);
+            if (detail::is_wildcard(value))
+                return nullptr;
+
+            auto it = table_.find(value);
+            return it == table_.end() ? &kEmpty : &it->second;
+        }
+
+        bool range(const std::string &from, const std::string &to, std::vector<key_type> &keys) const override {
+            if constexpr (Type == student_index_type::kOrdered) {
+                auto low = detail::parse_field_value(from, value_type{});
+                auto high = detail::parse_field_value(to, value_type{});
+                if (!low or !high)
+                    return false;
+
+                for (auto it = table_.lower_bound(*low), last = table_.upper_bound(*high); it != last; ++it)
+                    keys.insert(keys.end(), it->second.begin(), it->second.end());
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        [[nodiscard]] student_field field() const noexcept override { return Field; }
+        [[nodiscard]] student_index_type type() const noexcept override { return Type; }
+        [[nodiscard]] size_type values_count() const noexcept override { return table_.size(); }
+
+    private:
+        table_type table_;
+        std::unordered_map<key_type, value_type> values_;
+
+        void unlink(const key_type &key, const value_type &value) {
+            auto it = table_.find(value);
+            if (it == table_.end())
+                return;
+
+            it->second.erase(key);
+            if (it->second.empty())
+                table_.erase(it);
+        }
+    };
+
+    /*
+     * At most one index per Student field. plan() returns the posting lists a
+     * FIND pattern can use, most selective first; the caller walks the first
+     * one and probes the others.
+     */
+    template <typename Key>
+    class student_indexes {
+    public:
+        using key_type = Key;
+        using index_type = istudent_index<key_type>;
+        using postings_type = typename index_type::postings_type;
+
+    public:
+        // nullptr when the field is already indexed
+        index_type *create(student_field field, student_index_type type) {
+            auto &slot = indexes_[static_cast<std::size_t>(field)];
+            if (slot)
+                return nullptr;
+
+            slot = type == student_index_type::kHash ? make<student_index_type::kHash>(field)
+                                                     : make<student_index_type::kOrdered>(field);
+            return slot.get();
+        }
+
+        bool drop(student_field field) {
+            auto &slot = indexes_[static_cast<std::size_t>(field)];
+            if (!slot)
+                return false;
+
+            slot.reset();
+            return true;
+        }
+
+        [[nodiscard]] const index_type *get(student_field field) const {
+            return indexes_[static_cast<std::size_t>(field)].get();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return std::none_of(indexes_.begin(), indexes_.end(), [](const auto &index) { return index != nullptr; });
+        }
+
+        void assign(const key_type &key, const Student &student) {
+            for (auto &index : indexes_)
+                if (index)
+                    index->assign(key, student);
+        }
+
+        void erase(const key_type &key) {
+            for (auto &index : indexes_)
+                if (index)
+                    index->erase(key);
+        }
+
+        [[nodiscard]] std::vector<const postings_type *> plan(const Student &pattern) const {
+            std::vector<const postings_type *> postings;
+            for (const auto &index : indexes_)
+                if (index)
+                    if (const postings_type *found = index->lookup(pattern))
+                        postings.push_back(found);
+
+            std::sort(postings.begin(), postings.end(), [](const postings_type *lhs, const postings_type *rhs) {
+                return lhs->size() < rhs->size();
+            });
+            return postings;
+        }
+
+    private:
+        std::array<std::unique_ptr<index_type>, static_cast<std::size_t>(student_field::kCount)> indexes_;
+
+        template <student_index_type Type>
+        static std::unique_ptr<index_type> make(student_field field) {
+            switch (field) {
+                case student_field::kSurname: return std::make_unique<student_field_index<Key, student_field::kSurname, Type>>();
+                case student_field::kName:    return std::make_unique<student_field_index<Key, student_field::kName, Type>>();
+                case student_field::kYear:    return std::make_unique<student_field_index<Key, student_field::kYear, Type>>();
+                case student_field::kCity:    return std::make_unique<student_field_index<Key, student_field::kCity, Type>>();
+                case student_field::kCoins:   return std::make_unique<student_field_index<Key, student_field::kCoins, Type>>();
+                default:                      return nullptr;
+            }
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_INDEX_H
@@ -0,0 +1,44 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_KERNELS_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ttl::detail {
+    /*
+     * Equality kernel for 32-bit columns: bit i of the result is set when
+     * data[i] == value. Compares 8 (AVX2) or 4 (SSE2) rows per instruction and
+     * falls back to a branch-free scalar loop elsewhere and for the tail.
+     */
+    inline std::uint64_t equal_mask(const std::uint32_t *data, std::size_t count, std::uint32_t value) noexcept {
+        std::uint64_t bits {};
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        const __m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+        for (; i + 8 <= count; i += 8) {
+            __m256i rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(rows, needle))));
+            bits |= static_cast<std::uint64_t>(mask) << i;
+        }
+#elif defined(__SSE2__)
+        const __m128i needle = _mm_set1_epi32(static_cast<int>(value));
+        for (; i + 4 <= count; i += 4) {
+            __m128i rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(rows, needle))));
+            bits |= static_cast<std::uint64_t>(mask) << i;
+        }
+#endif
+
+        for (; i != count; ++i)
+            bits |= static_cast<std::uint64_t>(data[i] == value) << i;
+
+        return bits;
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_KERNELS_H
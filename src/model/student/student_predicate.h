@@ -0,0 +1,55 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_PREDICATE_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_PREDICATE_H
+
+#include <string>
+
+#include "student.h"
+
+namespace ttl {
+    /*
+     * FIND pattern compiled once per query. Wildcards are resolved up front,
+     * so matching a record runs only the comparisons the pattern asks for,
+     * int fields first since they are the cheapest to reject on.
+     */
+    class student_predicate {
+    public:
+        explicit student_predicate(const Student &pattern) : pattern_(pattern) {
+            if (pattern.surname != "-") fields_ |= kSurname;
+            if (pattern.name != "-")    fields_ |= kName;
+            if (pattern.city != "-")    fields_ |= kCity;
+            if (pattern.year != -1)     fields_ |= kYear;
+            if (pattern.coins != -1)    fields_ |= kCoins;
+        }
+
+        [[nodiscard]] bool operator()(const Student &student) const {
+            if ((fields_ & kYear) and student.year != pattern_.year)
+                return false;
+            if ((fields_ & kCoins) and student.coins != pattern_.coins)
+                return false;
+            if ((fields_ & kCity) and student.city != pattern_.city)
+                return false;
+            if ((fields_ & kSurname) and student.surname != pattern_.surname)
+                return false;
+            if ((fields_ & kName) and student.name != pattern_.name)
+                return false;
+            return true;
+        }
+
+        [[nodiscard]] bool matches_all() const noexcept { return fields_ == 0; }
+        [[nodiscard]] const Student &pattern() const noexcept { return pattern_; }
+
+    private:
+        enum : unsigned {
+            kSurname = 1u << 0,
+            kName    = 1u << 1,
+            kCity    = 1u << 2,
+            kYear    = 1u << 3,
+            kCoins   = 1u << 4
+        };
+
+        Student pattern_;
+        unsigned fields_ = 0;
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_PREDICATE_H
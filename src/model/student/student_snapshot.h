@@ -0,0 +1,111 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_STUDENT_SNAPSHOT_H
+#define TRANSACTIONS_LIBRARY_CPP_STUDENT_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "student.h"
+
+namespace ttl {
+    /*
+     * Binary dump of (key, Student) records, for loading large generated
+     * datasets without parsing text. Layout, integers in host byte order:
+     *
+     *   "TTLSNAP1" | u64 count | count x record
+     *   record = str key | str surname | str name | str city | i32 year | i32 coins | i32 ttl
+     *   str    = u32 length | bytes
+     *
+     * ttl is the remaining life time in seconds, -1 for none; it restarts
+     * when the snapshot is loaded.
+     */
+    namespace snapshot {
+        inline constexpr char kMagic[8] = {'T', 'T', 'L', 'S', 'N', 'A', 'P', '1'};
+
+        namespace detail {
+            template <typename T>
+            void append(std::string &buffer, T value) {
+                buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+            }
+
+            inline void append(std::string &buffer, const std::string &value) {
+                append(buffer, static_cast<std::uint32_t>(value.size()));
+                buffer.append(value);
+            }
+
+            template <typename T>
+            bool read(std::istream &in, T &value) {
+                return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+            }
+
+            inline bool read(std::istream &in, std::string &value) {
+                std::uint32_t size;
+                if (!read(in, size))
+                    return false;
+                value.resize(size);
+                return static_cast<bool>(in.read(value.data(), size));
+            }
+        }
+
+        inline void write_header(std::ostream &out, std::uint64_t count) {
+            out.write(kMagic, sizeof(kMagic));
+            out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        }
+
+        inline void append_record(std::string &buffer, const std::string &key, const Student &student) {
+            detail::append(buffer, key);
+            detail::append(buffer, student.surname);
+            detail::append(buffer, student.name);
+            detail::append(buffer, student.city);
+            detail::append(buffer, static_cast<std::int32_t>(student.year));
+            detail::append(buffer, static_cast<std::int32_t>(student.coins));
+            detail::append(buffer, static_cast<std::int32_t>(student.time));
+        }
+
+        // true (and the magic consumed) if `in` starts with a snapshot; otherwise `in` is rewound
+        inline bool is_snapshot(std::istream &in) {
+            char magic[sizeof(kMagic)];
+            if (in.read(magic, sizeof(magic)) and std::memcmp(magic, kMagic, sizeof(kMagic)) == 0)
+                return true;
+
+            in.clear();
+            in.seekg(0);
+            return false;
+        }
+
+        /*
+         * Reads the records after the magic, calling consumer(key, student)
+         * for each until it returns false. Returns the number consumed, or
+         * stops early at a truncated record.
+         */
+        template <typename Consumer>
+        std::uint64_t read_records(std::istream &in, Consumer consumer) {
+            std::uint64_t count;
+            if (!detail::read(in, count))
+                return 0;
+
+            std::string key;
+            Student student;
+            std::uint64_t consumed = 0;
+            for (; consumed != count; ++consumed) {
+                std::int32_t year, coins, time;
+                if (!detail::read(in, key) or !detail::read(in, student.surname) or !detail::read(in, student.name) or
+                    !detail::read(in, student.city) or !detail::read(in, year) or !detail::read(in, coins) or
+                    !detail::read(in, time))
+                    break;
+
+                student.year = year;
+                student.coins = coins;
+                student.time = time;
+                if (!consumer(key, student))
+                    break;
+            }
+
+            return consumed;
+        }
+    }
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_STUDENT_SNAPSHOT_H
@@ -0,0 +1,185 @@
+#include "allocation_counter.h"
+#include "art_map.h"
+#include "map.h"
+#include "robin_hood_map.h"
+#include "unordered_map.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+/*
+ * Heap traffic per operation, counted by the replacement operator new
+ * linked into the test binary. Lookups and in-place updates must not
+ * allocate; an insert that doesn't grow the table costs exactly its node.
+ */
+
+namespace {
+    template <typename Storage>
+    Storage make_storage(int size) {
+        Storage storage;
+        for (int i = 0; i != size; ++i)
+            storage.insert({i, i});
+        return storage;
+    }
+
+    using ordered_threaded = ttl::map<int, int, std::less<int>,
+                                      ttl::map_options::kOrderStatistics | ttl::map_options::kThreaded>;
+}
+
+TEST(allocations, counter_is_linked) {
+    ASSERT_TRUE(ttl::allocation_counter::enabled());
+
+    ttl::allocation_scope scope;
+    // a new-expression may be elided, a direct call may not
+    void *value = ::operator new(sizeof(int));
+    ::operator delete(value);
+    ASSERT_EQ(scope.allocations(), 1u);
+    ASSERT_GE(scope.bytes(), sizeof(int));
+}
+
+template <typename Storage>
+class engine_allocations : public ::testing::Test {};
+
+using engines = ::testing::Types<ttl::unordered_map<int, int>, ttl::robin_hood_map<int, int>, ttl::map<int, int>,
+                                 ordered_threaded>;
+TYPED_TEST_SUITE(engine_allocations, engines);
+
+TYPED_TEST(engine_allocations, find_does_not_allocate) {
+    auto storage = make_storage<TypeParam>(1000);
+
+    ttl::allocation_scope scope;
+    std::size_t found = 0;
+    for (int i = 0; i != 2000; ++i)
+        found += storage.find(i) != storage.end();
+    ASSERT_EQ(found, 1000u);
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TYPED_TEST(engine_allocations, update_in_place_does_not_allocate) {
+    auto storage = make_storage<TypeParam>(1000);
+
+    ttl::allocation_scope scope;
+    for (int i = 0; i != 1000; ++i)
+        storage[i] = -i;
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TYPED_TEST(engine_allocations, iteration_does_not_allocate) {
+    auto storage = make_storage<TypeParam>(1000);
+
+    ttl::allocation_scope scope;
+    long sum = 0;
+    for (const auto &[key, value] : storage)
+        sum += value;
+    ASSERT_EQ(sum, 999 * 1000 / 2);
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TYPED_TEST(engine_allocations, erase_does_not_allocate) {
+    auto storage = make_storage<TypeParam>(1000);
+
+    ttl::allocation_scope scope;
+    for (int i = 0; i != 100; ++i)
+        storage.erase(i);
+    ASSERT_EQ(storage.size(), 900u);
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TYPED_TEST(engine_allocations, insert_allocates_one_node) {
+    auto storage = make_storage<TypeParam>(1000);
+    storage.erase(500);
+
+    ttl::allocation_scope scope;
+    storage.insert({500, 500});
+    ASSERT_EQ(scope.allocations(), 1u);
+}
+
+TEST(allocations, unordered_map_growth_is_the_only_extra_cost) {
+    ttl::unordered_map<int, int> storage;
+    storage.reserve(1000);
+    const auto buckets = storage.bucket_count();
+
+    int key = 0;
+    ttl::allocation_scope scope;
+    for (; storage.bucket_count() == buckets; ++key) {
+        ttl::allocation_scope insert;
+        storage.insert({key, key});
+        if (storage.bucket_count() == buckets) {
+            ASSERT_EQ(insert.allocations(), 1u) << "key " << key;
+        }
+    }
+
+    // the rehash splices the existing nodes: only the new bucket array and bitmaps are allocated
+    const auto extra = scope.allocations() - static_cast<std::uint64_t>(key);
+    ASSERT_GE(extra, 1u);
+    ASSERT_LE(extra, 4u);
+}
+
+TEST(allocations, unordered_map_shrink_does_not_copy_nodes) {
+    auto storage = make_storage<ttl::unordered_map<int, int>>(4000);
+    const auto buckets = storage.bucket_count();
+
+    ttl::allocation_scope scope;
+    for (int i = 0; i != 3990; ++i)
+        storage.erase(i);
+    ASSERT_LT(storage.bucket_count(), buckets);
+    // a few bucket arrays and bitmaps per shrink, nothing per surviving node
+    ASSERT_LT(scope.allocations(), 32u);
+}
+
+TEST(allocations, short_string_keys_look_up_without_allocating) {
+    ttl::unordered_map<std::string, int> hash;
+    ttl::map<std::string, int> tree;
+    for (int i = 0; i != 100; ++i) {
+        hash.insert({"key:" + std::to_string(i), i});
+        tree.insert({"key:" + std::to_string(i), i});
+    }
+
+    const std::string key = "key:42";
+    ttl::allocation_scope scope;
+    ASSERT_TRUE(hash.find(key) != hash.end());
+    ASSERT_TRUE(tree.find(key) != tree.end());
+    hash[key] = 0;
+    tree[key] = 0;
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TEST(allocations, radix_tree_lookups_do_not_allocate) {
+    ttl::art_map<std::string, int> radix;
+    for (int i = 0; i != 1000; ++i)
+        radix.insert({"key:" + std::to_string(i), i});
+
+    const std::string key = "key:42", missing = "key:42x";
+    ttl::allocation_scope scope;
+    ASSERT_TRUE(radix.find(key) != radix.end());
+    ASSERT_TRUE(radix.find(missing) == radix.end());
+    ASSERT_EQ(radix.lower_bound(missing)->first, "key:43");
+    ASSERT_EQ(radix.upper_bound(key)->first, "key:420");
+    ASSERT_FALSE(radix.erase(missing));
+    radix[key] = 0;
+    ASSERT_EQ(scope.allocations(), 0u);
+}
+
+TEST(allocations, long_string_keys_are_copied_only_on_insert) {
+    ttl::unordered_map<std::string, int> hash;
+    ttl::map<std::string, int> tree;
+    const std::string key = "a key that is far too long for the small string buffer";
+    hash[key] = 1;
+    tree[key] = 1;
+
+    ttl::allocation_scope scope;
+    hash[key] = 2;
+    tree[key] = 2;
+    ASSERT_FALSE(hash.try_emplace(key, 3).second);
+    ASSERT_FALSE(tree.try_emplace(key, 3).second);
+    ASSERT_EQ(scope.allocations(), 0u);
+    ASSERT_EQ(hash[key], 2);
+    ASSERT_EQ(tree[key], 2);
+
+    std::string other = key + "!";
+    ttl::allocation_scope insert;
+    ASSERT_TRUE(tree.try_emplace(std::move(other), 4).second);
+    // the node only, the key is moved into it
+    ASSERT_EQ(insert.allocations(), 1u);
+}
@@ -0,0 +1,280 @@
+#include "art_map.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+    using art_map = ttl::art_map<std::string, int>;
+
+    std::vector<std::string> keys_of(const art_map &map) {
+        std::vector<std::string> keys;
+        for (const auto &kv : map)
+            keys.push_back(kv.first);
+        return keys;
+    }
+
+    std::vector<std::string> keys_of(const std::map<std::string, int> &map) {
+        std::vector<std::string> keys;
+        for (const auto &kv : map)
+            keys.push_back(kv.first);
+        return keys;
+    }
+}
+
+TEST(art_map, default_constructor) {
+    art_map map;
+
+    ASSERT_TRUE(map.size() == 0);
+    ASSERT_TRUE(map.empty() == true);
+    ASSERT_TRUE(map.begin() == map.end());
+    ASSERT_TRUE(map.find("key") == map.end());
+    ASSERT_TRUE(map.lower_bound("") == map.end());
+    ASSERT_FALSE(map.erase("key"));
+    ASSERT_FALSE(map.erase(map.end()));
+}
+
+TEST(art_map, insert_find_erase) {
+    art_map map;
+    ASSERT_TRUE(map.insert({"one", 1}).second);
+    ASSERT_FALSE(map.insert({"one", 10}).second);
+    map["two"] = 2;
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.find("one")->second, 1);
+    ASSERT_EQ(map["two"], 2);
+    ASSERT_TRUE(map.find("three") == map.end());
+    ASSERT_TRUE(map.find("on") == map.end());
+    ASSERT_TRUE(map.find("onex") == map.end());
+
+    ASSERT_TRUE(map.erase("one"));
+    ASSERT_FALSE(map.erase("one"));
+    ASSERT_TRUE(map.erase(map.find("two")));
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(art_map, try_emplace) {
+    ttl::art_map<std::string, std::string> map;
+    ASSERT_TRUE(map.try_emplace("key", 3, 'x').second);
+    ASSERT_FALSE(map.try_emplace("key", "other").second);
+    ASSERT_EQ(map["key"], "xxx");
+}
+
+// keys that are prefixes of other keys end at inner nodes and sort before their extensions
+TEST(art_map, prefix_keys) {
+    art_map map;
+    for (const char *key : {"abc", "ab", "", "b", "a", "abd", "abcd"})
+        map.insert({key, 0});
+
+    const std::vector<std::string> expected {"", "a", "ab", "abc", "abcd", "abd", "b"};
+    ASSERT_EQ(keys_of(map), expected);
+    for (const auto &key : expected)
+        ASSERT_TRUE(map.find(key) != map.end());
+
+    ASSERT_EQ(map.lower_bound("abc")->first, "abc");
+    ASSERT_EQ(map.upper_bound("abc")->first, "abcd");
+    ASSERT_EQ(map.lower_bound("abca")->first, "abcd");
+    ASSERT_EQ(map.lower_bound("abce")->first, "abd");
+    ASSERT_TRUE(map.lower_bound("c") == map.end());
+
+    ASSERT_TRUE(map.erase("ab"));
+    ASSERT_TRUE(map.erase("a"));
+    ASSERT_TRUE(map.erase(""));
+    const std::vector<std::string> rest {"abc", "abcd", "abd", "b"};
+    ASSERT_EQ(keys_of(map), rest);
+    for (const auto &key : rest)
+        ASSERT_TRUE(map.find(key) != map.end());
+}
+
+// bytes compare as unsigned char, like std::string
+TEST(art_map, binary_keys) {
+    art_map map;
+    std::map<std::string, int> expected;
+    for (std::string key : {std::string("\0", 1), std::string("\xff"), std::string("a\0b", 3), std::string("a"),
+                            std::string("a\xff"), std::string("\x7f"), std::string("\x80")}) {
+        map.insert({key, 0});
+        expected.insert({key, 0});
+    }
+
+    ASSERT_EQ(keys_of(map), keys_of(expected));
+    ASSERT_EQ(map.lower_bound(std::string("a\x01"))->first, "a\xff");
+}
+
+// one node under a long shared prefix grows through every size and shrinks back
+TEST(art_map, node_growth_and_shrink) {
+    art_map map;
+    const std::string prefix = "user:profile:";
+    for (int byte = 0; byte != 256; ++byte)
+        map.insert({prefix + static_cast<char>(byte), byte});
+
+    ASSERT_EQ(map.size(), 256);
+    for (int byte = 0; byte != 256; ++byte)
+        ASSERT_EQ(map.find(prefix + static_cast<char>(byte))->second, byte);
+
+    int previous = -1;
+    for (const auto &[key, value] : map) {
+        ASSERT_EQ(value, previous + 1);
+        previous = value;
+    }
+
+    const auto grown = map.memory(false).table_bytes;
+    for (int byte = 255; byte != 1; --byte)
+        ASSERT_TRUE(map.erase(prefix + static_cast<char>(byte)));
+
+    ASSERT_LT(map.memory(false).table_bytes, grown);
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.begin()->second, 0);
+    ASSERT_EQ((++map.begin())->second, 1);
+
+    map.erase(prefix + '\0');
+    map.erase(prefix + '\1');
+    ASSERT_EQ(map.memory(false).table_bytes, sizeof(map));
+}
+
+// differential test against std::map over a small alphabet, so keys share long prefixes
+TEST(art_map, matches_std_under_churn) {
+    art_map map;
+    std::map<std::string, int> expected;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> lengths(0, 6), letters(0, 3), actions(0, 9);
+
+    auto random_key = [&] {
+        std::string key(lengths(generator), 'a');
+        for (auto &c : key)
+            c = static_cast<char>('a' + letters(generator));
+        return key;
+    };
+
+    for (int step = 0; step != 100000; ++step) {
+        const std::string key = random_key();
+        const int action = actions(generator);
+        if (action < 4) {
+            ASSERT_EQ(map.insert({key, step}).second, expected.insert({key, step}).second);
+        } else if (action < 7) {
+            ASSERT_EQ(map.erase(key), expected.erase(key) == 1);
+        } else if (action < 8) {
+            auto it = map.find(key);
+            auto std_it = expected.find(key);
+            ASSERT_EQ(it == map.end(), std_it == expected.end());
+            if (std_it != expected.end()) {
+                ASSERT_EQ(it->second, std_it->second);
+            }
+        } else {
+            auto lower = map.lower_bound(key);
+            auto std_lower = expected.lower_bound(key);
+            ASSERT_EQ(lower == map.end(), std_lower == expected.end());
+            if (std_lower != expected.end()) {
+                ASSERT_EQ(lower->first, std_lower->first);
+            }
+
+            auto upper = map.upper_bound(key);
+            auto std_upper = expected.upper_bound(key);
+            ASSERT_EQ(upper == map.end(), std_upper == expected.end());
+            if (std_upper != expected.end()) {
+                ASSERT_EQ(upper->first, std_upper->first);
+            }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+
+        if (step % 10000 == 0) {
+            ASSERT_EQ(keys_of(map), keys_of(expected));
+        }
+    }
+
+    ASSERT_EQ(keys_of(map), keys_of(expected));
+}
+
+TEST(art_map, backward_iteration) {
+    art_map map;
+    for (int i = 0; i != 100; ++i)
+        map.insert({std::to_string(i), i});
+
+    std::vector<std::string> backward;
+    auto it = map.find("99");
+    for (; it != map.end(); --it)
+        backward.push_back(it->first);
+
+    std::vector<std::string> forward = keys_of(map);
+    std::reverse(forward.begin(), forward.end());
+    ASSERT_EQ(backward, forward);
+}
+
+TEST(art_map, copy_and_move) {
+    art_map map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({"key:" + std::to_string(i), i});
+
+    art_map copy(map);
+    copy["key:0"] = -1;
+    ASSERT_EQ(map["key:0"], 0);
+    ASSERT_EQ(copy.size(), 1000);
+    ASSERT_EQ(keys_of(copy), keys_of(map));
+    ASSERT_EQ(copy.memory(false).total(), map.memory(false).total());
+
+    art_map moved(std::move(copy));
+    ASSERT_EQ(moved.size(), 1000);
+    ASSERT_EQ(moved["key:0"], -1);
+
+    map = moved;
+    ASSERT_EQ(map["key:0"], -1);
+    moved = art_map{};
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(map.size(), 1000);
+    ASSERT_EQ(map.find("key:999")->second, 999);
+}
+
+TEST(art_map, split) {
+    art_map map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({std::to_string(i), i});
+
+    auto ranges = map.split(8);
+    ASSERT_TRUE(ranges.size() > 1 and ranges.size() <= 8);
+
+    std::vector<std::string> seen;
+    for (auto [first, last] : ranges)
+        for (; first != last; ++first)
+            seen.push_back(first->first);
+
+    ASSERT_EQ(seen, keys_of(map));
+}
+
+TEST(art_map, scan_survives_writes) {
+    art_map map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({std::to_string(i), i});
+
+    std::vector<std::string> seen;
+    art_map::cursor_type cursor;
+    int next = 1000;
+    do {
+        cursor = map.scan(cursor, 7, [&](const auto &kv) { seen.push_back(kv.first); });
+        map.erase(std::to_string(next - 1000));
+        map.insert({std::to_string(next), next});
+        ++next;
+    } while (cursor != art_map::cursor_type{});
+
+    // every key is returned once and in order; keys present throughout are all there
+    ASSERT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    ASSERT_TRUE(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+    for (int i = 500; i != 1000; ++i)
+        ASSERT_TRUE(std::binary_search(seen.begin(), seen.end(), std::to_string(i)));
+}
+
+// a lookup walks a node per distinct byte, not a node per key comparison
+TEST(art_map, probes_follow_key_bytes) {
+    art_map map;
+    for (int i = 0; i != 100000; ++i)
+        map.insert({std::to_string(i), i});
+
+    map.reset_stats();
+    for (int i = 0; i != 100000; ++i)
+        ASSERT_TRUE(map.find(std::to_string(i)) != map.end());
+    ASSERT_LE(map.stats().probes_per_hit(), 6.0);
+}
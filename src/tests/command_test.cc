@@ -0,0 +1,126 @@
+#include "command_factory.h"
+#include "console_capture.h"
+#include "art_map.h"
+#include "map.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+    template <typename Storage>
+    std::string run(Storage &storage, const std::string &line) {
+        ttl::test::console_capture console;
+        auto command = ttl::CommandFactory::getCommand(line, storage);
+        if (command)
+            command->Run(storage);
+        return console.take();
+    }
+
+    template <typename Storage>
+    void fill(Storage &storage) {
+        for (const char *key : {"a", "b", "c", "d"})
+            storage[key] = ttl::Student{};
+    }
+}
+
+TEST(command, range_lists_keys_in_order) {
+    ttl::map<std::string, ttl::Student> storage;
+    fill(storage);
+
+    auto replies = run(storage, "RANGE b c");
+    ASSERT_NE(replies.find("1) b"), std::string::npos);
+    ASSERT_NE(replies.find("2) c"), std::string::npos);
+    ASSERT_EQ(replies.find("3)"), std::string::npos);
+}
+
+TEST(command, reversed_range_is_empty) {
+    ttl::map<std::string, ttl::Student> map;
+    ttl::art_map<std::string, ttl::Student> art;
+    fill(map);
+    fill(art);
+
+    for (const auto &replies : {run(map, "RANGE c a"), run(art, "RANGE c a"), run(map, "RANGE z a")}) {
+        ASSERT_NE(replies.find("(null)"), std::string::npos);
+        ASSERT_EQ(replies.find("1)"), std::string::npos);
+    }
+}
+
+TEST(command, volatile_ttl_evicts_the_rare_key_with_a_ttl) {
+    ttl::map<std::string, ttl::Student> storage;
+    ttl::CommandContext<ttl::map<std::string, ttl::Student>> context;
+    ttl::test::console_capture console;
+
+    auto run = [&](const std::string &line) {
+        auto command = ttl::CommandFactory::getCommand(line, storage, &context);
+        ASSERT_TRUE(command.has_value());
+        command->Run(storage);
+    };
+
+    for (int i = 0; i != 2000; ++i)
+        run("SET key:" + std::to_string(i) + " Ivanov Ivan 2000 Moscow 5");
+    run("SET expiring Petrov Petr 2000 Moscow 5 EX 100");
+
+    context.policy = ttl::eviction_policy::kVolatileTtl;
+    context.SetMaxMemory(storage, context.UsedMemory(storage) - 1);
+    console.take();
+
+    run("SET fresh Sidorov Sidor 2000 Moscow 5");
+    ASSERT_EQ(console.take().find("OOM"), std::string::npos);
+    ASSERT_TRUE(storage.find("fresh") != storage.end());
+    ASSERT_TRUE(storage.find("expiring") == storage.end());
+    ASSERT_EQ(context.evicted_keys, 1u);
+}
+
+TEST(command, upload_starts_the_lifetime_of_records_with_a_ttl) {
+    const std::string path = ::testing::TempDir() + "command_test_upload.txt";
+    {
+        std::ofstream file(path);
+        file << "forever Ivanov Ivan 2000 Moscow 5\n";
+        file << "expiring Petrov Petr 2000 Moscow 5 EX 100\n";
+    }
+
+    ttl::map<std::string, ttl::Student> storage;
+    ASSERT_NE(run(storage, "UPLOAD " + path).find("OK 2"), std::string::npos);
+    ASSERT_NE(run(storage, "TTL forever").find("(inf)"), std::string::npos);
+
+    // counted from the upload, not from the epoch
+    auto ttl = run(storage, "TTL expiring");
+    ASSERT_EQ(ttl.find("(null)"), std::string::npos);
+    ASSERT_EQ(ttl.find("(inf)"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(command, update_never_evicts_the_key_it_writes) {
+    ttl::map<std::string, ttl::Student> storage;
+    ttl::CommandContext<ttl::map<std::string, ttl::Student>> context;
+    ttl::test::console_capture console;
+
+    auto run = [&](const std::string &line) {
+        auto command = ttl::CommandFactory::getCommand(line, storage, &context);
+        ASSERT_TRUE(command.has_value());
+        command->Run(storage);
+    };
+
+    run("SET idle Ivanov Ivan 2000 Moscow 5");
+    for (int i = 0; i != 100; ++i)
+        run("SET key:" + std::to_string(i) + " Petrov Petr 2000 Moscow 5");
+    for (int i = 0; i != 100; ++i)
+        run("GET key:" + std::to_string(i));
+
+    // the least recently used key is the one being updated
+    context.samples = 1000;
+    context.SetMaxMemory(storage, context.UsedMemory(storage) - 1);
+    console.take();
+
+    run("UPDATE idle - - 2001 - -");
+    ASSERT_NE(console.take().find("OK"), std::string::npos);
+    ASSERT_EQ(context.evicted_keys, 1u);
+
+    auto it = storage.find("idle");
+    ASSERT_TRUE(it != storage.end());
+    ASSERT_EQ(it->second.surname, "Ivanov");
+    ASSERT_EQ(it->second.year, 2001);
+}
@@ -0,0 +1,31 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_CONSOLE_CAPTURE_H
+#define TRANSACTIONS_LIBRARY_CPP_CONSOLE_CAPTURE_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace ttl::test {
+    // points std::cout at a buffer for its lifetime, so command replies can be checked
+    class console_capture {
+    public:
+        console_capture() : console_(std::cout.rdbuf(buffer_.rdbuf())) {}
+        ~console_capture() { std::cout.rdbuf(console_); }
+
+        console_capture(const console_capture &) = delete;
+        console_capture &operator=(const console_capture &) = delete;
+
+        // what was written since the last call
+        std::string take() {
+            std::string written = buffer_.str();
+            buffer_.str({});
+            return written;
+        }
+
+    private:
+        std::ostringstream buffer_;
+        std::streambuf *console_;
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_CONSOLE_CAPTURE_H
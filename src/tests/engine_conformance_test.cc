@@ -0,0 +1,284 @@
+#include "engine_list.h"
+#include "student.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * The contract of engine_traits.h checked the same way on every engine of
+ * engine_list.h, plus the configuration the interactive view uses. Tests
+ * for a capability only run where the engine has it, so a new engine is
+ * covered as soon as it is listed.
+ */
+
+namespace {
+    template <typename List, typename... Extra>
+    struct gtest_types;
+
+    template <typename... Engines, typename... Extra>
+    struct gtest_types<ttl::engine_list<Engines...>, Extra...> {
+        using type = ::testing::Types<Engines..., Extra...>;
+    };
+
+    using ordered_threaded = ttl::map<std::string, int, std::less<std::string>,
+                                      ttl::map_options::kOrderStatistics | ttl::map_options::kThreaded>;
+
+    // short keys over a small alphabet, so they collide in prefixes and hash buckets alike
+    std::string random_key(std::mt19937 &generator) {
+        std::uniform_int_distribution<int> lengths(0, 5), letters(0, 5);
+        std::string key(lengths(generator), 'a');
+        for (auto &c : key)
+            c = static_cast<char>('a' + letters(generator));
+        return key;
+    }
+
+    template <typename Engine>
+    std::vector<std::string> sorted_keys(const Engine &engine) {
+        std::vector<std::string> keys;
+        for (const auto &kv : engine)
+            keys.push_back(kv.first);
+        if constexpr (!ttl::engine_traits<Engine>::kOrdered)
+            std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    std::vector<std::string> sorted_keys(const std::map<std::string, int> &expected) {
+        std::vector<std::string> keys;
+        for (const auto &kv : expected)
+            keys.push_back(kv.first);
+        return keys;
+    }
+}
+
+static_assert(ttl::is_storage_engine_v<std::map<std::string, int>>);
+static_assert(ttl::is_storage_engine_v<std::unordered_map<std::string, int>>);
+static_assert(!ttl::is_storage_engine_v<std::vector<int>>);
+static_assert(!ttl::is_storage_engine_v<std::set<int>>);
+
+static_assert(ttl::engine_traits<ttl::unordered_map<int, int>>::kReservable);
+static_assert(!ttl::engine_traits<ttl::unordered_map<int, int>>::kOrdered);
+static_assert(ttl::engine_traits<ttl::robin_hood_map<int, int>>::kShrinkable);
+static_assert(ttl::engine_traits<ttl::map<int, int>>::kOrdered);
+static_assert(!ttl::engine_traits<ttl::map<int, int>>::kOrderStatistics);
+static_assert(ttl::engine_traits<ordered_threaded>::kOrderStatistics);
+static_assert(ttl::engine_traits<ttl::art_map<std::string, int>>::kOrdered);
+static_assert(!ttl::engine_traits<ttl::art_map<std::string, int>>::kReservable);
+static_assert(ttl::engine_traits<std::unordered_map<int, int>>::kReservable);
+static_assert(!ttl::engine_traits<std::map<int, int>>::kScannable);
+static_assert(!ttl::engine_traits<std::map<int, int>>::kMemoryStats);
+static_assert(!ttl::engine_traits<std::unordered_map<int, int>>::kEngineStats);
+static_assert(ttl::engine_traits<ttl::art_map<std::string, int>>::kMemoryStats);
+static_assert(ttl::engine_traits<ttl::robin_hood_map<int, int>>::kEngineStats);
+static_assert(!ttl::engine_traits<ttl::map<int, int>>::kConcurrent);
+static_assert(ttl::engine_traits<ttl::map<std::string, ttl::Student>>::kSupportsTtl);
+static_assert(!ttl::engine_traits<ttl::map<std::string, int>>::kSupportsTtl);
+
+template <typename Engine>
+class engine_conformance : public ::testing::Test {};
+
+using engines = gtest_types<ttl::storage_engines<std::string, int>, ordered_threaded>::type;
+TYPED_TEST_SUITE(engine_conformance, engines);
+
+TYPED_TEST(engine_conformance, empty_engine) {
+    TypeParam engine;
+    ASSERT_TRUE(engine.empty());
+    ASSERT_EQ(engine.size(), 0u);
+    ASSERT_TRUE(engine.begin() == engine.end());
+    ASSERT_TRUE(engine.find("key") == engine.end());
+}
+
+TYPED_TEST(engine_conformance, insert_keeps_the_first_value) {
+    TypeParam engine;
+    ASSERT_TRUE(engine.insert({"key", 1}).second);
+    ASSERT_FALSE(engine.insert({"key", 2}).second);
+    ASSERT_EQ(engine.find("key")->second, 1);
+
+    engine["key"] = 3;
+    ASSERT_EQ(engine["key"], 3);
+    ASSERT_EQ(engine["other"], 0);
+    ASSERT_EQ(engine.size(), 2u);
+
+    engine.erase(engine.find("key"));
+    ASSERT_TRUE(engine.find("key") == engine.end());
+    ASSERT_EQ(engine.size(), 1u);
+}
+
+// differential test against std::map; ordered engines must also iterate in its order
+TYPED_TEST(engine_conformance, matches_std_map_under_churn) {
+    TypeParam engine;
+    std::map<std::string, int> expected;
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> actions(0, 9);
+
+    for (int step = 0; step != 50000; ++step) {
+        const std::string key = random_key(generator);
+        const int action = actions(generator);
+        if (action < 4) {
+            ASSERT_EQ(engine.insert({key, step}).second, expected.insert({key, step}).second);
+        } else if (action < 6) {
+            engine[key] = step;
+            expected[key] = step;
+        } else if (action < 8) {
+            auto it = engine.find(key);
+            ASSERT_EQ(it != engine.end(), expected.count(key) == 1);
+            if (it != engine.end())
+                engine.erase(it);
+            expected.erase(key);
+        } else {
+            auto it = engine.find(key);
+            auto std_it = expected.find(key);
+            ASSERT_EQ(it == engine.end(), std_it == expected.end());
+            if (std_it != expected.end()) {
+                ASSERT_EQ(it->second, std_it->second);
+            }
+        }
+        ASSERT_EQ(engine.size(), expected.size());
+    }
+
+    ASSERT_EQ(sorted_keys(engine), sorted_keys(expected));
+    for (const auto &[key, value] : engine)
+        ASSERT_EQ(expected.at(key), value);
+}
+
+TYPED_TEST(engine_conformance, ordered_bounds) {
+    if constexpr (ttl::engine_traits<TypeParam>::kOrdered) {
+        TypeParam engine;
+        std::map<std::string, int> expected;
+        std::mt19937 generator(13);
+        for (int i = 0; i != 2000; ++i) {
+            const std::string key = random_key(generator);
+            engine.insert({key, i});
+            expected.insert({key, i});
+        }
+
+        for (int i = 0; i != 2000; ++i) {
+            const std::string key = random_key(generator);
+            auto lower = engine.lower_bound(key);
+            auto std_lower = expected.lower_bound(key);
+            ASSERT_EQ(lower == engine.end(), std_lower == expected.end());
+            if (std_lower != expected.end()) {
+                ASSERT_EQ(lower->first, std_lower->first);
+            }
+
+            auto upper = engine.upper_bound(key);
+            auto std_upper = expected.upper_bound(key);
+            ASSERT_EQ(upper == engine.end(), std_upper == expected.end());
+            if (std_upper != expected.end()) {
+                ASSERT_EQ(upper->first, std_upper->first);
+            }
+        }
+    } else {
+        GTEST_SKIP() << "not ordered";
+    }
+}
+
+TYPED_TEST(engine_conformance, scan_returns_every_key) {
+    if constexpr (ttl::engine_traits<TypeParam>::kScannable) {
+        TypeParam engine;
+        for (int i = 0; i != 3000; ++i)
+            engine.insert({std::to_string(i), i});
+
+        std::set<std::string> seen;
+        typename TypeParam::cursor_type cursor;
+        do {
+            cursor = engine.scan(cursor, 10, [&](const auto &kv) { seen.insert(kv.first); });
+        } while (cursor != typename TypeParam::cursor_type{});
+
+        ASSERT_EQ(seen.size(), engine.size());
+    } else {
+        GTEST_SKIP() << "no scan";
+    }
+}
+
+TYPED_TEST(engine_conformance, split_covers_every_key_once) {
+    if constexpr (ttl::engine_traits<TypeParam>::kSplittable) {
+        TypeParam engine;
+        for (int i = 0; i != 3000; ++i)
+            engine.insert({std::to_string(i), i});
+
+        std::vector<std::string> seen;
+        for (auto [first, last] : engine.split(8))
+            for (; first != last; ++first)
+                seen.push_back(first->first);
+
+        std::sort(seen.begin(), seen.end());
+        ASSERT_EQ(seen, sorted_keys(engine));
+    } else {
+        GTEST_SKIP() << "no split";
+    }
+}
+
+TYPED_TEST(engine_conformance, reserve_and_shrink_keep_contents) {
+    TypeParam engine;
+    for (int i = 0; i != 1000; ++i)
+        engine.insert({std::to_string(i), i});
+
+    if constexpr (ttl::engine_traits<TypeParam>::kReservable)
+        engine.reserve(100000);
+    for (int i = 0; i != 900; ++i)
+        engine.erase(engine.find(std::to_string(i)));
+    if constexpr (ttl::engine_traits<TypeParam>::kShrinkable)
+        engine.shrink_to_fit();
+
+    ASSERT_EQ(engine.size(), 100u);
+    for (int i = 900; i != 1000; ++i)
+        ASSERT_EQ(engine.find(std::to_string(i))->second, i);
+}
+
+TYPED_TEST(engine_conformance, copies_are_independent) {
+    TypeParam engine;
+    for (int i = 0; i != 500; ++i)
+        engine.insert({std::to_string(i), i});
+
+    TypeParam copy(engine);
+    copy["0"] = -1;
+    copy.erase(copy.find("1"));
+    ASSERT_EQ(engine["0"], 0);
+    ASSERT_TRUE(engine.find("1") != engine.end());
+    ASSERT_EQ(copy.size(), 499u);
+
+    TypeParam moved(std::move(copy));
+    ASSERT_EQ(moved.size(), 499u);
+    ASSERT_EQ(moved["0"], -1);
+
+    engine = moved;
+    ASSERT_EQ(sorted_keys(engine), sorted_keys(moved));
+}
+
+TYPED_TEST(engine_conformance, memory_follows_the_entries) {
+    if constexpr (ttl::engine_traits<TypeParam>::kMemoryStats) {
+        TypeParam engine;
+        for (int i = 0; i != 1000; ++i)
+            engine.insert({std::to_string(i), i});
+        for (int i = 0; i != 100; ++i)
+            engine.erase(engine.find(std::to_string(i)));
+
+        const auto memory = engine.memory();
+        ASSERT_EQ(memory.entries, engine.size());
+        ASSERT_GE(memory.total(), memory.payload_bytes);
+    } else {
+        GTEST_SKIP() << "no memory()";
+    }
+}
+
+TYPED_TEST(engine_conformance, stats_count_the_writes) {
+    if constexpr (ttl::engine_traits<TypeParam>::kEngineStats) {
+        TypeParam engine;
+        for (int i = 0; i != 1000; ++i)
+            engine.insert({std::to_string(i), i});
+        for (int i = 0; i != 100; ++i)
+            engine.erase(engine.find(std::to_string(i)));
+
+        ASSERT_EQ(engine.stats().inserts, 1000u);
+        ASSERT_EQ(engine.stats().erases, 100u);
+    } else {
+        GTEST_SKIP() << "no stats()";
+    }
+}
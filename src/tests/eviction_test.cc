@@ -0,0 +1,129 @@
+#include "eviction.h"
+#include "memory_usage.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(eviction, lru_prefers_idle_keys) {
+    ttl::eviction_tracker<int> tracker(1000, 42);
+    for (int i = 0; i != 100; ++i)
+        tracker.assign(i, 0, std::nullopt);
+    for (int i = 50; i != 100; ++i)
+        tracker.touch(i);
+
+    for (int round = 0; round != 20; ++round) {
+        auto victim = tracker.victim(ttl::eviction_policy::kAllKeysLru);
+        ASSERT_TRUE(victim.has_value());
+        ASSERT_TRUE(*victim < 50);
+        tracker.erase(*victim);
+    }
+    ASSERT_EQ(tracker.size(), 80);
+}
+
+TEST(eviction, lfu_keeps_hot_keys) {
+    ttl::eviction_tracker<int> tracker(1000, 42);
+    for (int i = 0; i != 10; ++i)
+        tracker.assign(i, 0, std::nullopt);
+    for (int access = 0; access != 1000; ++access)
+        tracker.touch(7);
+
+    for (int round = 0; round != 9; ++round) {
+        auto victim = tracker.victim(ttl::eviction_policy::kAllKeysLfu);
+        ASSERT_TRUE(victim.has_value());
+        ASSERT_NE(*victim, 7);
+        tracker.erase(*victim);
+    }
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kAllKeysLfu), 7);
+}
+
+TEST(eviction, volatile_ttl) {
+    using namespace std::chrono;
+    ttl::eviction_tracker<std::string> tracker(1000, 42);
+    const auto now = system_clock::now();
+
+    tracker.assign("forever", 0, std::nullopt);
+    ASSERT_FALSE(tracker.victim(ttl::eviction_policy::kVolatileTtl).has_value());
+
+    tracker.assign("late", 0, now + hours(1));
+    tracker.assign("soon", 0, now + seconds(1));
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kVolatileTtl), "soon");
+
+    tracker.assign("soon", 0, std::nullopt);
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kVolatileTtl), "late");
+}
+
+TEST(eviction, volatile_ttl_finds_rare_ttl_keys) {
+    using namespace std::chrono;
+    ttl::eviction_tracker<int> tracker(5, 42);
+    const auto now = system_clock::now();
+
+    for (int i = 0; i != 10000; ++i)
+        tracker.assign(i, 0, i % 1000 == 0 ? std::optional(now + seconds(i)) : std::nullopt);
+    ASSERT_EQ(tracker.expiring(), 10);
+
+    // a thousand keys without a TTL to every one with it: a sample over all of them would find none
+    for (int i = 0; i != 9; ++i) {
+        auto victim = tracker.victim(ttl::eviction_policy::kVolatileTtl);
+        ASSERT_TRUE(victim.has_value());
+        ASSERT_EQ(*victim % 1000, 0);
+        tracker.erase(*victim);
+    }
+
+    // clearing the TTL, or erasing rows around it, keeps the set right
+    auto last = tracker.victim(ttl::eviction_policy::kVolatileTtl);
+    ASSERT_TRUE(last.has_value());
+    for (int i = 1; i != 500; ++i)
+        tracker.erase(i);
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kVolatileTtl), last);
+
+    tracker.assign(*last, 0, std::nullopt);
+    ASSERT_EQ(tracker.expiring(), 0);
+    ASSERT_FALSE(tracker.victim(ttl::eviction_policy::kVolatileTtl).has_value());
+    ASSERT_TRUE(tracker.victim(ttl::eviction_policy::kAllKeysLru).has_value());
+}
+
+TEST(eviction, heap_accounting) {
+    ttl::eviction_tracker<int> tracker;
+    tracker.assign(1, 100, std::nullopt);
+    tracker.assign(2, 50, std::nullopt);
+    tracker.assign(1, 10, std::nullopt);
+    ASSERT_EQ(tracker.heap_bytes(), 60);
+
+    tracker.erase(2);
+    tracker.erase(3);
+    ASSERT_EQ(tracker.heap_bytes(), 10);
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kAllKeysRandom), 1);
+
+    tracker.erase(1);
+    ASSERT_FALSE(tracker.victim(ttl::eviction_policy::kAllKeysRandom).has_value());
+}
+
+TEST(eviction, kept_key_is_never_the_victim) {
+    ttl::eviction_tracker<int> tracker(5, 42);
+    tracker.assign(1, 0, std::nullopt);
+    tracker.assign(2, 0, std::chrono::system_clock::now());
+
+    const int keep = 1;
+    for (int round = 0; round != 100; ++round) {
+        ASSERT_EQ(tracker.victim(ttl::eviction_policy::kAllKeysRandom, &keep), 2);
+        ASSERT_EQ(tracker.victim(ttl::eviction_policy::kAllKeysLru, &keep), 2);
+    }
+
+    tracker.erase(2);
+    ASSERT_FALSE(tracker.victim(ttl::eviction_policy::kAllKeysLru, &keep).has_value());
+    ASSERT_EQ(tracker.victim(ttl::eviction_policy::kAllKeysLru), 1);
+}
+
+TEST(eviction, policy_names) {
+    for (auto policy : {ttl::eviction_policy::kAllKeysLru, ttl::eviction_policy::kAllKeysLfu,
+                        ttl::eviction_policy::kVolatileTtl, ttl::eviction_policy::kAllKeysRandom})
+        ASSERT_EQ(ttl::parse_eviction_policy(ttl::eviction_policy_name(policy)), policy);
+    ASSERT_FALSE(ttl::parse_eviction_policy("noeviction").has_value());
+
+    ASSERT_EQ(ttl::parse_memory_size("1024"), 1024);
+    ASSERT_EQ(ttl::parse_memory_size("64KB"), 64 << 10);
+    ASSERT_EQ(ttl::parse_memory_size("100mb"), 100 << 20);
+    ASSERT_FALSE(ttl::parse_memory_size("mb").has_value());
+    ASSERT_FALSE(ttl::parse_memory_size("10tb").has_value());
+}
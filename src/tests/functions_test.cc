@@ -0,0 +1,107 @@
+#include "glob.h"
+#include "latency_histogram.h"
+#include "memory_usage.h"
+#include "student.h"
+#include "map.h"
+#include "unordered_map.h"
+
+#include <gtest/gtest.h>
+
+TEST(functions, glob_match) {
+    ASSERT_TRUE(ttl::GlobMatch("*", ""));
+    ASSERT_TRUE(ttl::GlobMatch("user:*", "user:42"));
+    ASSERT_TRUE(ttl::GlobMatch("u?er:*2", "user:42"));
+    ASSERT_TRUE(ttl::GlobMatch("*a*b*", "xxaxxbxx"));
+    ASSERT_FALSE(ttl::GlobMatch("user:*", "users"));
+    ASSERT_FALSE(ttl::GlobMatch("?", ""));
+    ASSERT_FALSE(ttl::GlobMatch("*a", "bbb"));
+}
+
+TEST(functions, heap_size) {
+    ASSERT_EQ(ttl::heap_size(42), 0);
+    ASSERT_EQ(ttl::heap_size(std::string("short")), 0);
+
+    std::string long_string(100, 'x');
+    ASSERT_TRUE(ttl::heap_size(long_string) > 100);
+
+    ttl::Student student;
+    student.surname = long_string;
+    student.name = "Ann";
+    ASSERT_EQ(ttl::heap_size(student), ttl::heap_size(long_string));
+    ASSERT_EQ(ttl::heap_size(std::make_pair(long_string, student)), 2 * ttl::heap_size(long_string));
+}
+
+TEST(functions, memory_stats) {
+    ttl::unordered_map<std::string, ttl::Student> hash_map;
+    ttl::map<std::string, ttl::Student> tree_map;
+
+    ttl::Student student;
+    student.city = std::string(64, 'c');
+    for (int i = 0; i != 1000; ++i) {
+        hash_map.insert({std::to_string(i), student});
+        tree_map.insert({std::to_string(i), student});
+    }
+
+    for (const auto &stats : {hash_map.memory(), tree_map.memory()}) {
+        ASSERT_EQ(stats.entries, 1000);
+        ASSERT_EQ(stats.heap_bytes, 1000 * ttl::heap_size(student.city));
+        ASSERT_TRUE(stats.node_bytes >= 1000 * sizeof(std::pair<const std::string, ttl::Student>));
+        ASSERT_TRUE(stats.overhead_ratio() > 1.0);
+    }
+
+    const auto hash_stats = hash_map.memory();
+    ASSERT_EQ(hash_stats.buckets, hash_map.bucket_count());
+    ASSERT_TRUE(hash_stats.load_factor() > 0.0 and hash_stats.load_factor() < 0.75);
+    ASSERT_EQ(tree_map.memory().buckets, 0);
+}
+
+TEST(functions, latency_histogram) {
+    ttl::latency_histogram histogram;
+    ASSERT_EQ(histogram.percentile(0.5), 0);
+
+    for (std::uint64_t value = 1; value <= 100000; ++value)
+        histogram.record(value);
+
+    ASSERT_EQ(histogram.count(), 100000);
+    ASSERT_EQ(histogram.min(), 1);
+    ASSERT_EQ(histogram.max(), 100000);
+    ASSERT_NEAR(histogram.mean(), 50000.5, 0.01);
+
+    for (double quantile : {0.5, 0.99, 0.999}) {
+        const double expected = quantile * 100000;
+        ASSERT_NEAR(static_cast<double>(histogram.percentile(quantile)), expected, expected / 32);
+    }
+    ASSERT_EQ(histogram.percentile(1.0), 100000);
+
+    ttl::latency_histogram other;
+    other.record(std::uint64_t{1} << 50);
+    histogram.merge(other);
+    ASSERT_EQ(histogram.percentile(1.0), std::uint64_t{1} << 50);
+    ASSERT_EQ(histogram.count(), 100001);
+}
+
+TEST(functions, engine_stats) {
+    ttl::unordered_map<int, int> hash_map;
+    ttl::map<int, int> tree_map;
+    for (int i = 0; i != 1000; ++i) {
+        hash_map.insert({i, i});
+        tree_map.insert({i, i});
+    }
+
+    ASSERT_EQ(hash_map.stats().inserts, 1000);
+    ASSERT_TRUE(hash_map.stats().rehashes > 1);
+    ASSERT_EQ(tree_map.stats().inserts, 1000);
+    ASSERT_TRUE(tree_map.stats().rotations > 0);
+
+    hash_map.reset_stats();
+    tree_map.reset_stats();
+    for (int i = 0; i != 1000; ++i) {
+        hash_map.find(i);
+        tree_map.find(i);
+    }
+
+    ASSERT_EQ(hash_map.stats().lookups, 1000);
+    ASSERT_TRUE(hash_map.stats().probes_per_lookup() >= 1.0 and hash_map.stats().probes_per_lookup() < 3.0);
+    ASSERT_EQ(tree_map.stats().lookups, 1000);
+    ASSERT_TRUE(tree_map.stats().probes_per_lookup() > 5.0 and tree_map.stats().probes_per_lookup() <= 20.0);
+}
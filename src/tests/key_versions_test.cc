@@ -0,0 +1,48 @@
+#include "key_versions.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(key_versions, writes_to_a_watched_key_change_it) {
+    ttl::key_versions<std::string> versions;
+    auto seen = versions.watch("a");
+    ASSERT_FALSE(versions.changed("a", seen));
+
+    versions.touch("b");
+    ASSERT_FALSE(versions.changed("a", seen));
+
+    versions.touch("a");
+    ASSERT_TRUE(versions.changed("a", seen));
+    ASSERT_FALSE(versions.changed("a", versions.watch("a")));
+}
+
+TEST(key_versions, unwatched_keys_are_not_tracked) {
+    ttl::key_versions<std::string> versions;
+    versions.touch("a");
+    ASSERT_TRUE(versions.empty());
+
+    versions.watch("a");
+    versions.watch("a");
+    versions.unwatch("a");
+    ASSERT_EQ(versions.size(), 1u);
+    versions.unwatch("a");
+    ASSERT_TRUE(versions.empty());
+
+    // a key nobody watches any more has no version to compare against
+    ASSERT_TRUE(versions.changed("a", 0));
+}
+
+TEST(key_versions, watchers_share_the_counter) {
+    ttl::key_versions<int> versions;
+    auto first = versions.watch(1);
+    versions.touch(1);
+    auto second = versions.watch(1);
+
+    ASSERT_TRUE(versions.changed(1, first));
+    ASSERT_FALSE(versions.changed(1, second));
+
+    versions.unwatch(1);
+    versions.touch(1);
+    ASSERT_TRUE(versions.changed(1, second));
+}
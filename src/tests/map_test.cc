@@ -2,6 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
 
 TEST(map, default_constructor) {
     ttl::map<int, int> map;
@@ -160,3 +165,132 @@ TEST(map, erase_over) {
 
     ASSERT_TRUE(map.size() == 0);
 }
+
+TEST(map, split) {
+    ttl::map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    auto ranges = map.split(8);
+    ASSERT_TRUE(ranges.size() > 1 and ranges.size() <= 8);
+
+    int expected = 0;
+    for (auto [first, last] : ranges)
+        for (; first != last; ++first)
+            ASSERT_EQ(first->first, expected++);
+    ASSERT_EQ(expected, 1000);
+
+    ttl::map<int, int> empty;
+    ASSERT_TRUE(empty.split(8).empty());
+    ASSERT_EQ(map.split(1).size(), 1);
+}
+
+TEST(map, scan) {
+    ttl::map<int, int> map;
+    for (int i = 0; i != 100; ++i)
+        map.insert({i, i});
+
+    std::vector<int> seen;
+    ttl::map<int, int>::cursor_type cursor;
+    do {
+        cursor = map.scan(cursor, 7, [&](const auto &kv) { seen.push_back(kv.first); });
+        if (cursor.after and *cursor.after == 48)
+            map.erase(49);
+    } while (cursor.after);
+
+    ASSERT_EQ(seen.size(), 99);
+    ASSERT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+
+    ttl::map_cursor<int> parsed;
+    ASSERT_TRUE(parse_cursor("@42", parsed));
+    ASSERT_EQ(*parsed.after, 42);
+    ASSERT_FALSE(parse_cursor("42", parsed));
+}
+
+TEST(map, bounds) {
+    ttl::map<int, int> map;
+    for (int i = 0; i != 100; i += 10)
+        map.insert({i, i});
+
+    ASSERT_EQ(map.lower_bound(20)->first, 20);
+    ASSERT_EQ(map.lower_bound(21)->first, 30);
+    ASSERT_EQ(map.upper_bound(20)->first, 30);
+    ASSERT_TRUE(map.lower_bound(91) == map.end());
+    ASSERT_TRUE(map.upper_bound(90) == map.end());
+    ASSERT_EQ(map.lower_bound(-5)->first, 0);
+
+    auto [first, last] = map.equal_range(40);
+    ASSERT_EQ(first->first, 40);
+    ASSERT_EQ(last->first, 50);
+
+    auto [none_first, none_last] = map.equal_range(45);
+    ASSERT_TRUE(none_first == none_last);
+
+    const auto &const_map = map;
+    ASSERT_EQ(const_map.lower_bound(55)->first, 60);
+}
+
+TEST(map, order_statistics) {
+    ttl::map<int, int, std::less<int>, ttl::map_options::kOrderStatistics> map;
+    std::set<int> expected;
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 500);
+    for (int i = 0; i != 3000; ++i) {
+        int key = distribution(generator);
+        if (i % 3 == 2) {
+            map.erase(key);
+            expected.erase(key);
+        } else {
+            map.insert({key, key});
+            expected.insert(key);
+        }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+
+    std::size_t index = 0;
+    for (int key : expected) {
+        ASSERT_EQ(map.rank(key), index);
+        ASSERT_EQ(map.select(index)->first, key);
+        ++index;
+    }
+
+    ASSERT_TRUE(map.select(expected.size()) == map.end());
+    ASSERT_EQ(map.rank(-1), 0);
+    ASSERT_EQ(map.rank(1000), expected.size());
+
+    auto first = expected.lower_bound(100), last = expected.upper_bound(200);
+    ASSERT_EQ(map.count_range(100, 200), static_cast<std::size_t>(std::distance(first, last)));
+    ASSERT_EQ(map.count_range(200, 100), 0);
+}
+
+TEST(map, threaded_iteration) {
+    ttl::map<int, int, std::less<int>, ttl::map_options::kThreaded | ttl::map_options::kOrderStatistics> map;
+    std::set<int> expected;
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> distribution(0, 300);
+    for (int i = 0; i != 2000; ++i) {
+        int key = distribution(generator);
+        if (i % 3 == 2) {
+            map.erase(key);
+            expected.erase(key);
+        } else {
+            map.insert({key, key});
+            expected.insert(key);
+        }
+    }
+
+    std::vector<int> forward;
+    for (const auto &[key, value] : map)
+        forward.push_back(key);
+    ASSERT_EQ(forward, std::vector<int>(expected.begin(), expected.end()));
+
+    std::vector<int> backward;
+    auto it = map.select(map.size() - 1);
+    for (std::size_t i = 0; i != map.size(); ++i, --it)
+        backward.push_back(it->first);
+    ASSERT_EQ(backward, std::vector<int>(expected.rbegin(), expected.rend()));
+    ASSERT_TRUE(it == map.end());
+}
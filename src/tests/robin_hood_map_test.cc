@@ -0,0 +1,259 @@
+#include "robin_hood_map.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+TEST(robin_hood_map, default_constructor) {
+    ttl::robin_hood_map<int, int> map;
+
+    ASSERT_TRUE(map.size() == 0);
+    ASSERT_TRUE(map.empty() == true);
+    ASSERT_TRUE(map.begin() == map.end());
+    ASSERT_TRUE(map.find(1) == map.end());
+    ASSERT_FALSE(map.erase(1));
+}
+
+TEST(robin_hood_map, insert_find_erase) {
+    ttl::robin_hood_map<std::string, int> map;
+    ASSERT_TRUE(map.insert({"one", 1}).second);
+    ASSERT_FALSE(map.insert({"one", 10}).second);
+    map["two"] = 2;
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.find("one")->second, 1);
+    ASSERT_EQ(map["two"], 2);
+    ASSERT_TRUE(map.find("three") == map.end());
+
+    ASSERT_TRUE(map.erase("one"));
+    ASSERT_FALSE(map.erase("one"));
+    ASSERT_TRUE(map.erase(map.find("two")));
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(robin_hood_map, try_emplace) {
+    ttl::robin_hood_map<std::string, std::string> map;
+    ASSERT_TRUE(map.try_emplace("key", 3, 'x').second);
+    ASSERT_FALSE(map.try_emplace("key", "other").second);
+    ASSERT_EQ(map["key"], "xxx");
+}
+
+// differential test against std::unordered_map under insert/erase churn
+TEST(robin_hood_map, matches_std_under_churn) {
+    ttl::robin_hood_map<int, int> map;
+    std::unordered_map<int, int> expected;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> keys(0, 3000), actions(0, 9);
+
+    for (int step = 0; step != 200000; ++step) {
+        const int key = keys(generator);
+        const int action = actions(generator);
+        if (action < 5) {
+            ASSERT_EQ(map.insert({key, step}).second, expected.insert({key, step}).second);
+        } else if (action < 9) {
+            ASSERT_EQ(map.erase(key), expected.erase(key) == 1);
+        } else {
+            auto it = map.find(key);
+            auto std_it = expected.find(key);
+            ASSERT_EQ(it == map.end(), std_it == expected.end());
+            if (std_it != expected.end()) {
+                ASSERT_EQ(it->second, std_it->second);
+            }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+    }
+
+    std::size_t seen = 0;
+    for (const auto &[key, value] : map) {
+        ASSERT_EQ(expected.at(key), value);
+        ++seen;
+    }
+    ASSERT_EQ(seen, expected.size());
+}
+
+struct constant_hash {
+    std::size_t operator()(int) const noexcept { return 7; }
+};
+
+TEST(robin_hood_map, colliding_keys) {
+    ttl::robin_hood_map<int, int, constant_hash> map;
+    for (int i = 0; i != 100; ++i)
+        map.insert({i, i});
+
+    for (int i = 0; i != 100; i += 2)
+        ASSERT_TRUE(map.erase(i));
+
+    ASSERT_EQ(map.size(), 50);
+    for (int i = 0; i != 100; ++i)
+        ASSERT_EQ(map.find(i) != map.end(), i % 2 == 1);
+}
+
+TEST(robin_hood_map, references_survive_rehash) {
+    ttl::robin_hood_map<int, std::string> map;
+    map[0] = "zero";
+    const std::string *value = &map.find(0)->second;
+
+    for (int i = 1; i != 10000; ++i)
+        map.insert({i, std::to_string(i)});
+    for (int i = 1; i != 10000; ++i)
+        map.erase(i);
+
+    ASSERT_EQ(&map.find(0)->second, value);
+    ASSERT_EQ(*value, "zero");
+}
+
+TEST(robin_hood_map, copy_and_move) {
+    ttl::robin_hood_map<std::string, int> map;
+    for (int i = 0; i != 100; ++i)
+        map.insert({std::to_string(i), i});
+
+    ttl::robin_hood_map<std::string, int> copy(map);
+    copy["0"] = -1;
+    ASSERT_EQ(map["0"], 0);
+    ASSERT_EQ(copy.size(), 100);
+    for (int i = 1; i != 100; ++i)
+        ASSERT_EQ(copy.find(std::to_string(i))->second, i);
+
+    ttl::robin_hood_map<std::string, int> moved(std::move(copy));
+    ASSERT_EQ(moved.size(), 100);
+    ASSERT_EQ(moved["0"], -1);
+
+    map = moved;
+    ASSERT_EQ(map["0"], -1);
+    moved = ttl::robin_hood_map<std::string, int>{};
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(map.size(), 100);
+}
+
+TEST(robin_hood_map, split) {
+    ttl::robin_hood_map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    auto ranges = map.split(8);
+    ASSERT_TRUE(ranges.size() > 1 and ranges.size() <= 8);
+
+    std::vector<int> seen;
+    for (auto [first, last] : ranges)
+        for (; first != last; ++first)
+            seen.push_back(first->first);
+
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), 1000);
+    for (int i = 0; i != 1000; ++i)
+        ASSERT_EQ(seen[i], i);
+}
+
+TEST(robin_hood_map, misses_stop_early) {
+    ttl::robin_hood_map<int, int> map;
+    map.reserve(1 << 14);
+    for (int i = 0; i != 10000; ++i)
+        map.insert({i, i});
+
+    map.reset_stats();
+    for (int i = 10000; i != 20000; ++i)
+        map.find(i);
+
+    // a miss stops at the first entry closer to home, not at the end of the cluster
+    ASSERT_EQ(map.stats().hits, 0);
+    ASSERT_LT(map.stats().probes_per_miss(), 2.0);
+}
+
+TEST(robin_hood_map, probe_distances_stay_short) {
+    ttl::robin_hood_map<int, int> map;
+    for (int i = 0; i != 100000; ++i)
+        map.insert({i, i});
+
+    auto stats = map.probe_stats();
+    ASSERT_EQ(stats.slots, map.bucket_count());
+    ASSERT_EQ(stats.entries, 100000);
+    ASSERT_LT(stats.mean_distance(), 3.0);
+    ASSERT_LT(stats.distance_variance(), 10.0);
+    using map_type = ttl::robin_hood_map<int, int>;
+    ASSERT_LE(stats.max_distance, map_type::kMaxDistance);
+
+    auto sampled = map.probe_stats(1000);
+    ASSERT_TRUE(sampled.sampled >= 1000 and sampled.sampled <= 1001);
+}
+
+// backward-shift erase leaves no tombstones: churn at a steady size doesn't lengthen probes
+TEST(robin_hood_map, erase_churn_keeps_distances) {
+    ttl::robin_hood_map<int, int> map;
+    for (int i = 0; i != 50000; ++i)
+        map.insert({i, i});
+
+    const auto buckets = map.bucket_count();
+    const double before = map.probe_stats().mean_distance();
+    for (int i = 50000; i != 550000; ++i) {
+        map.erase(i - 50000);
+        map.insert({i, i});
+    }
+
+    ASSERT_EQ(map.bucket_count(), buckets);
+    ASSERT_EQ(map.size(), 50000);
+    ASSERT_LT(map.probe_stats().mean_distance(), before * 1.5 + 0.1);
+
+    map.reset_stats();
+    for (int i = 500000; i != 550000; ++i)
+        ASSERT_TRUE(map.find(i) != map.end());
+    ASSERT_LT(map.stats().probes_per_hit(), 4.0);
+}
+
+TEST(robin_hood_map, shrinks_after_mass_erase) {
+    ttl::robin_hood_map<int, int> map;
+    for (int i = 0; i != 100000; ++i)
+        map.insert({i, i});
+
+    const auto peak = map.bucket_count();
+    for (int i = 100; i != 100000; ++i)
+        map.erase(i);
+
+    ASSERT_TRUE(map.bucket_count() < peak / 100);
+    for (int i = 0; i != 100; ++i)
+        ASSERT_TRUE(map.find(i) != map.end());
+
+    map.reserve(10000);
+    using map_type = ttl::robin_hood_map<int, int>;
+    ASSERT_TRUE(static_cast<double>(map.bucket_count()) * map_type::kMaxLoad >= 10000);
+    map.shrink_to_fit();
+    ASSERT_TRUE(map.bucket_count() < 256);
+}
+
+TEST(robin_hood_map, scan_survives_resize) {
+    ttl::robin_hood_map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    std::vector<int> seen;
+    ttl::robin_hood_map<int, int>::cursor_type cursor;
+    int inserted = 1000, erased = 100;
+    do {
+        cursor = map.scan(cursor, 7, [&](const auto &kv) { seen.push_back(kv.first); });
+        // grow past two doublings, then erase enough of the new keys to shrink again
+        for (int i = 0; i != 40 and inserted != 5000; ++i, ++inserted)
+            map.insert({inserted, inserted});
+        if (inserted == 5000)
+            for (int i = 0; i != 200 and erased != 5000; ++i, ++erased)
+                map.erase(erased < 1000 ? erased + 4000 : erased);
+    } while (cursor != ttl::robin_hood_map<int, int>::cursor_type{});
+
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i != 100; ++i)
+        ASSERT_TRUE(std::binary_search(seen.begin(), seen.end(), i));
+}
+
+TEST(robin_hood_map, scan_cursor_text) {
+    ttl::robin_hood_map_cursor cursor {12345}, parsed;
+    ASSERT_TRUE(parse_cursor(to_string(cursor), parsed));
+    ASSERT_TRUE(parsed == cursor);
+
+    ASSERT_TRUE(parse_cursor("0", parsed));
+    ASSERT_TRUE(parsed == ttl::robin_hood_map_cursor{});
+    ASSERT_FALSE(parse_cursor("3.1", parsed));
+    ASSERT_FALSE(parse_cursor("99999999999999999999999", parsed));
+}
@@ -0,0 +1,63 @@
+#include "scan_executor.h"
+#include "map.h"
+#include "unordered_map.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+namespace {
+    template <typename Iterator>
+    std::vector<int> keys(Iterator first, Iterator last) {
+        std::vector<int> result;
+        for (; first != last; ++first)
+            result.push_back(first->first);
+        return result;
+    }
+}
+
+TEST(scan_executor, map_keeps_order) {
+    ttl::map<int, int> map;
+    for (int i = 0; i != 50000; ++i)
+        map.insert({i, i});
+
+    ttl::ScanExecutor executor(4);
+    auto parts = executor.Map(map, [](auto first, auto last) { return keys(first, last); });
+    ASSERT_TRUE(parts.size() > 1);
+
+    std::vector<int> merged;
+    for (const auto &part : parts)
+        merged.insert(merged.end(), part.begin(), part.end());
+
+    std::vector<int> expected(50000);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(merged, expected);
+}
+
+TEST(scan_executor, unordered_map_covers_all) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 50000; ++i)
+        map.insert({i, 1});
+
+    ttl::ScanExecutor executor(4);
+    for (int run = 0; run != 10; ++run) {
+        auto parts = executor.Map(map, [](auto first, auto last) {
+            long sum = 0;
+            for (; first != last; ++first)
+                sum += first->second;
+            return sum;
+        });
+        ASSERT_EQ(std::accumulate(parts.begin(), parts.end(), 0L), 50000);
+    }
+}
+
+TEST(scan_executor, small_storage_single_part) {
+    ttl::map<int, int> map;
+    map.insert({1, 1});
+
+    ttl::ScanExecutor executor(4);
+    auto parts = executor.Map(map, [](auto first, auto last) { return keys(first, last); });
+    ASSERT_EQ(parts.size(), 1);
+    ASSERT_EQ(parts.front(), std::vector<int>{1});
+}
@@ -0,0 +1,86 @@
+#include "student_columns.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+    ttl::Student make_student(std::string surname, std::string name, int year, std::string city, int coins) {
+        ttl::Student student;
+        student.surname = std::move(surname);
+        student.name = std::move(name);
+        student.year = year;
+        student.city = std::move(city);
+        student.coins = coins;
+        return student;
+    }
+
+    ttl::Student make_pattern() { return make_student("-", "-", -1, "-", -1); }
+
+    std::vector<std::string> selected_keys(const ttl::student_columns<std::string> &columns,
+                                           const ttl::student_columns<std::string>::selection_type &selection) {
+        std::vector<std::string> keys;
+        columns.for_each(selection, [&](std::size_t row) { keys.push_back(columns.key(row)); });
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+}
+
+TEST(student_columns, default_constructor) {
+    ttl::student_columns<std::string> columns;
+
+    ASSERT_TRUE(columns.size() == 0);
+    ASSERT_TRUE(columns.empty());
+    ASSERT_TRUE(columns.find(make_pattern()).empty());
+}
+
+TEST(student_columns, assign_overwrites) {
+    ttl::student_columns<std::string> columns;
+    columns.assign("1", make_student("Ivanov", "Ivan", 2000, "Moscow", 10));
+    columns.assign("1", make_student("Petrov", "Petr", 2001, "Kazan", 20));
+
+    ASSERT_EQ(columns.size(), 1);
+    ttl::Student record = columns.record(0);
+    ASSERT_EQ(record.surname, "Petrov");
+    ASSERT_EQ(record.city, "Kazan");
+    ASSERT_EQ(record.coins, 20);
+}
+
+TEST(student_columns, find_wildcards) {
+    ttl::student_columns<std::string> columns;
+    for (int i = 0; i != 200; ++i)
+        columns.assign(std::to_string(i), make_student("S" + std::to_string(i % 3), "N", 2000 + i % 5,
+                                                       i % 2 ? "Kazan" : "Moscow", i));
+
+    ASSERT_EQ(columns.count(columns.find(make_pattern())), 200);
+
+    ttl::Student pattern = make_pattern();
+    pattern.city = "Kazan";
+    pattern.year = 2002;
+    std::size_t expected = 0;
+    for (int i = 0; i != 200; ++i)
+        expected += (i % 2 == 1 and i % 5 == 2);
+    ASSERT_EQ(columns.count(columns.find(pattern)), expected);
+
+    pattern.surname = "Unknown";
+    ASSERT_EQ(columns.count(columns.find(pattern)), 0);
+}
+
+TEST(student_columns, erase_keeps_rows_dense) {
+    ttl::student_columns<std::string> columns;
+    for (int i = 0; i != 100; ++i)
+        columns.assign(std::to_string(i), make_student("S", "N", 2000, "Kazan", i));
+
+    for (int i = 0; i != 100; i += 2)
+        ASSERT_TRUE(columns.erase(std::to_string(i)));
+    ASSERT_FALSE(columns.erase("0"));
+
+    ASSERT_EQ(columns.size(), 50);
+    ttl::Student pattern = make_pattern();
+    pattern.coins = 51;
+    ASSERT_EQ(selected_keys(columns, columns.find(pattern)), std::vector<std::string>{"51"});
+
+    pattern.coins = 50;
+    ASSERT_EQ(columns.count(columns.find(pattern)), 0);
+}
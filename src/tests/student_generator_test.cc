@@ -0,0 +1,129 @@
+#include "student_generator.h"
+#include "student_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string generate_text(const ttl::student_generator_options &options, std::size_t threads) {
+        ttl::ScanExecutor executor(threads);
+        std::ostringstream out;
+        ttl::student_generator(options).write_text(out, executor);
+        return out.str();
+    }
+
+    std::vector<std::string> lines_of(const std::string &text) {
+        std::vector<std::string> lines;
+        std::istringstream in(text);
+        for (std::string line; std::getline(in, line);)
+            lines.push_back(line);
+        return lines;
+    }
+}
+
+TEST(student_generator, same_output_for_any_thread_count) {
+    ttl::student_generator_options options;
+    options.count = ttl::student_generator::kChunkRecords * 3 + 17;
+    options.ttl_fraction = 0.25;
+
+    const std::string single = generate_text(options, 1);
+    ASSERT_EQ(single, generate_text(options, 4));
+    ASSERT_EQ(lines_of(single).size(), options.count);
+
+    options.seed = 7;
+    ASSERT_NE(single, generate_text(options, 1));
+}
+
+TEST(student_generator, keys_are_padded_and_unique) {
+    ttl::student_generator_options options;
+    options.count = 1000;
+    options.key_length = 6;
+
+    const ttl::student_generator generator(options);
+    ASSERT_EQ(generator.key(0), "000001");
+    ASSERT_EQ(generator.key(999), "001000");
+    ASSERT_EQ(generator.key(9'999'999), "10000000");
+
+    const auto lines = lines_of(generate_text(options, 2));
+    for (std::size_t i = 0; i != lines.size(); ++i)
+        ASSERT_EQ(lines[i].substr(0, lines[i].find(' ')), generator.key(i));
+}
+
+TEST(student_generator, records_parse_back) {
+    ttl::student_generator_options options;
+    options.count = 2000;
+    options.ttl_fraction = 0.5;
+
+    std::size_t expiring = 0;
+    for (const std::string &line : lines_of(generate_text(options, 2))) {
+        std::istringstream in(line);
+        std::string key;
+        ttl::Student student;
+        in >> key >> student;
+
+        ASSERT_FALSE(student.surname.empty());
+        ASSERT_GE(student.year, 1950);
+        ASSERT_LE(student.year, 2010);
+        ASSERT_GE(student.coins, 0);
+        if (student.time != -1) {
+            ASSERT_GE(student.time, 1);
+            ASSERT_LE(student.time, options.max_ttl);
+            ++expiring;
+        }
+    }
+
+    ASSERT_GT(expiring, options.count / 3);
+    ASSERT_LT(expiring, options.count * 2 / 3);
+}
+
+TEST(student_generator, snapshot_round_trip) {
+    ttl::student_generator_options options;
+    options.count = ttl::student_generator::kChunkRecords + 5;
+    options.ttl_fraction = 0.1;
+
+    ttl::ScanExecutor executor(2);
+    const ttl::student_generator generator(options);
+    std::stringstream snapshot;
+    generator.write_snapshot(snapshot, executor);
+
+    const auto lines = lines_of(generate_text(options, 2));
+    ASSERT_TRUE(ttl::snapshot::is_snapshot(snapshot));
+
+    std::size_t index = 0;
+    const auto consumed = ttl::snapshot::read_records(snapshot, [&](const std::string &key, const ttl::Student &student) {
+        std::string line = key + ' ';
+        ttl::student_generator::append_fields(line, student);
+        EXPECT_EQ(line, lines[index++]);
+        return true;
+    });
+    ASSERT_EQ(consumed, options.count);
+}
+
+TEST(student_generator, text_is_not_a_snapshot) {
+    std::stringstream text("00000001 Ivanov Ivan 2000 Kazan 10\n");
+    ASSERT_FALSE(ttl::snapshot::is_snapshot(text));
+
+    std::string line;
+    std::getline(text, line);
+    ASSERT_EQ(line, "00000001 Ivanov Ivan 2000 Kazan 10");
+}
+
+TEST(student_generator, truncated_snapshot_stops) {
+    std::stringstream snapshot;
+    ttl::snapshot::write_header(snapshot, 2);
+
+    std::string records;
+    ttl::Student student;
+    student.surname = "Ivanov";
+    student.name = "Ivan";
+    student.city = "Kazan";
+    ttl::snapshot::append_record(records, "1", student);
+    ttl::snapshot::append_record(records, "2", student);
+    snapshot.write(records.data(), static_cast<std::streamsize>(records.size() - 3));
+
+    ASSERT_TRUE(ttl::snapshot::is_snapshot(snapshot));
+    ASSERT_EQ(ttl::snapshot::read_records(snapshot, [](const std::string &, const ttl::Student &) { return true; }), 1u);
+}
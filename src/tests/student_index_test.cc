@@ -0,0 +1,76 @@
+#include "student_index.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+    ttl::Student make_student(std::string city, int year) {
+        ttl::Student student;
+        student.surname = "-";
+        student.name = "-";
+        student.city = std::move(city);
+        student.year = year;
+        return student;
+    }
+}
+
+TEST(student_index, hash_lookup) {
+    ttl::student_field_index<std::string, ttl::student_field::kCity, ttl::student_index_type::kHash> index;
+    index.assign("1", make_student("Kazan", 2000));
+    index.assign("2", make_student("Kazan", 2001));
+    index.assign("3", make_student("Moscow", 2001));
+
+    ASSERT_EQ(index.lookup(make_student("Kazan", -1))->size(), 2);
+    ASSERT_EQ(index.lookup(make_student("Omsk", -1))->size(), 0);
+    ASSERT_EQ(index.lookup(make_student("-", 2000)), nullptr);
+    ASSERT_EQ(index.values_count(), 2);
+}
+
+TEST(student_index, reassign_and_erase) {
+    ttl::student_field_index<std::string, ttl::student_field::kCity, ttl::student_index_type::kHash> index;
+    index.assign("1", make_student("Kazan", 2000));
+    index.assign("1", make_student("Moscow", 2000));
+
+    ASSERT_EQ(index.lookup(make_student("Kazan", -1))->size(), 0);
+    ASSERT_EQ(index.lookup(make_student("Moscow", -1))->count("1"), 1);
+
+    index.erase("1");
+    ASSERT_EQ(index.values_count(), 0);
+}
+
+TEST(student_index, ordered_range) {
+    ttl::student_field_index<std::string, ttl::student_field::kYear, ttl::student_index_type::kOrdered> index;
+    for (int i = 0; i != 20; ++i)
+        index.assign(std::to_string(i), make_student("Kazan", 1990 + i));
+
+    std::vector<std::string> keys;
+    ASSERT_TRUE(index.range("1995", "1999", keys));
+    ASSERT_EQ(keys.size(), 5);
+    ASSERT_FALSE(index.range("x", "1999", keys));
+
+    ttl::student_field_index<std::string, ttl::student_field::kYear, ttl::student_index_type::kHash> hash;
+    ASSERT_FALSE(hash.range("1995", "1999", keys));
+}
+
+TEST(student_index, plan_most_selective_first) {
+    ttl::student_indexes<std::string> indexes;
+    ASSERT_NE(indexes.create(ttl::student_field::kCity, ttl::student_index_type::kHash), nullptr);
+    ASSERT_NE(indexes.create(ttl::student_field::kYear, ttl::student_index_type::kOrdered), nullptr);
+    ASSERT_EQ(indexes.create(ttl::student_field::kYear, ttl::student_index_type::kHash), nullptr);
+
+    for (int i = 0; i != 100; ++i)
+        indexes.assign(std::to_string(i), make_student(i % 2 ? "Kazan" : "Moscow", 2000 + i % 10));
+
+    auto plan = indexes.plan(make_student("Kazan", 2003));
+    ASSERT_EQ(plan.size(), 2);
+    ASSERT_EQ(plan.front()->size(), 10);
+    ASSERT_EQ(plan.back()->size(), 50);
+
+    ASSERT_TRUE(indexes.plan(make_student("-", -1)).empty());
+
+    ASSERT_TRUE(indexes.drop(ttl::student_field::kCity));
+    ASSERT_FALSE(indexes.drop(ttl::student_field::kCity));
+    ASSERT_EQ(indexes.plan(make_student("Kazan", 2003)).size(), 1);
+}
@@ -0,0 +1,58 @@
+#include "student_predicate.h"
+#include "student_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+    ttl::Student make_student(std::string surname, std::string name, int year, std::string city, int coins) {
+        ttl::Student student;
+        student.surname = std::move(surname);
+        student.name = std::move(name);
+        student.year = year;
+        student.city = std::move(city);
+        student.coins = coins;
+        return student;
+    }
+}
+
+TEST(student_predicate, matches_like_operator_equals) {
+    std::vector<ttl::Student> records = {
+            make_student("Ivanov", "Ivan", 2002, "Kazan", 100),
+            make_student("Ivanov", "Petr", 2001, "Kazan", 100),
+            make_student("Petrov", "Ivan", 2002, "Moscow", 50),
+    };
+
+    std::vector<ttl::Student> patterns = {
+            make_student("-", "-", -1, "-", -1),
+            make_student("Ivanov", "-", -1, "-", -1),
+            make_student("-", "-", 2002, "Kazan", -1),
+            make_student("-", "Ivan", -1, "-", 50),
+            make_student("Sidorov", "-", -1, "-", -1),
+    };
+
+    for (const auto &pattern : patterns) {
+        ttl::student_predicate predicate(pattern);
+        for (const auto &record : records)
+            ASSERT_EQ(predicate(record), record == pattern);
+    }
+
+    ASSERT_TRUE(ttl::student_predicate(patterns.front()).matches_all());
+    ASSERT_FALSE(ttl::student_predicate(patterns.back()).matches_all());
+}
+
+TEST(student_predicate, equal_mask_kernel) {
+    std::vector<std::uint32_t> column(64);
+    for (std::size_t i = 0; i != column.size(); ++i)
+        column[i] = i % 3 == 0 ? 7 : static_cast<std::uint32_t>(i);
+
+    for (std::size_t count : {0, 1, 5, 17, 63, 64}) {
+        std::uint64_t expected {};
+        for (std::size_t i = 0; i != count; ++i)
+            expected |= static_cast<std::uint64_t>(column[i] == 7) << i;
+
+        ASSERT_EQ(ttl::detail::equal_mask(column.data(), count, 7), expected);
+    }
+}
@@ -0,0 +1,180 @@
+#include "transaction.h"
+#include "console_capture.h"
+#include "map.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+    using storage_type = ttl::map<std::string, ttl::Student>;
+
+    // one REPL session: transaction lines go to the Transaction, the rest run at once
+    struct session {
+        storage_type storage;
+        ttl::CommandContext<storage_type> context;
+        ttl::Transaction<storage_type> transaction{context};
+        ttl::test::console_capture console;
+
+        std::string operator()(const std::string &line) {
+            if (!transaction.Accept(line, storage))
+                if (auto command = ttl::CommandFactory::getCommand(line, storage, &context))
+                    command->Run(storage);
+            return console.take();
+        }
+    };
+
+    bool contains(const std::string &replies, const std::string &text) {
+        return replies.find(text) != std::string::npos;
+    }
+
+    const std::string kRecord = " Ivanov Ivan 2000 Moscow 5";
+}
+
+TEST(transaction, exec_runs_the_queue_in_order) {
+    session run;
+    ASSERT_TRUE(contains(run("MULTI"), "OK"));
+    ASSERT_TRUE(contains(run("SET a" + kRecord), "QUEUED"));
+    ASSERT_TRUE(contains(run("GET a"), "QUEUED"));
+    ASSERT_TRUE(contains(run("DEL a"), "QUEUED"));
+    ASSERT_TRUE(contains(run("EXISTS a"), "QUEUED"));
+    ASSERT_EQ(run.transaction.Queued(), 4u);
+    ASSERT_TRUE(run.storage.empty());
+
+    const std::string replies = run("EXEC");
+    const auto set = replies.find("OK"), get = replies.find("Ivanov"), del = replies.find("true"),
+               exists = replies.find("false");
+    ASSERT_NE(exists, std::string::npos);
+    ASSERT_TRUE(set < get and get < del and del < exists);
+    ASSERT_FALSE(run.transaction.Active());
+    ASSERT_TRUE(run.storage.empty());
+}
+
+TEST(transaction, discard_drops_the_queue) {
+    session run;
+    run("MULTI");
+    run("SET a" + kRecord);
+    ASSERT_TRUE(contains(run("DISCARD"), "OK"));
+    ASSERT_TRUE(run.storage.find("a") == run.storage.end());
+
+    ASSERT_TRUE(contains(run("EXEC"), "EXEC without MULTI"));
+    ASSERT_TRUE(contains(run("DISCARD"), "DISCARD without MULTI"));
+}
+
+TEST(transaction, unchanged_watched_keys_let_exec_run) {
+    session run;
+    run("SET a" + kRecord);
+    run("WATCH a b");
+    run("MULTI");
+    run("UPDATE a - Petr - - -");
+    ASSERT_TRUE(contains(run("EXEC"), "OK"));
+    ASSERT_TRUE(contains(run("GET a"), "Petr"));
+    ASSERT_TRUE(run.context.versions.empty());
+}
+
+TEST(transaction, write_to_a_watched_key_aborts_exec) {
+    for (const std::string &write : std::vector<std::string>{"SET b" + kRecord, "DEL a", "RENAME a c", "UPDATE a - Petr - - -"}) {
+        session run;
+        run("SET a" + kRecord);
+        run("WATCH a b");
+        run(write);
+        run("MULTI");
+        run("SET d" + kRecord);
+
+        ASSERT_TRUE(contains(run("EXEC"), "was modified")) << write;
+        ASSERT_TRUE(run.storage.find("d") == run.storage.end()) << write;
+        ASSERT_TRUE(run.context.versions.empty()) << write;
+    }
+}
+
+TEST(transaction, eviction_of_a_watched_key_aborts_exec) {
+    session run;
+    run("SET a" + kRecord);
+    run("WATCH a");
+
+    // only `a` can make room for `b`
+    run.context.policy = ttl::eviction_policy::kAllKeysRandom;
+    run.context.SetMaxMemory(run.storage, run.context.UsedMemory(run.storage) - 1);
+    run("SET b" + kRecord);
+    ASSERT_EQ(run.context.evicted_keys, 1u);
+
+    run("MULTI");
+    run("SET c" + kRecord);
+    ASSERT_TRUE(contains(run("EXEC"), "'a' was modified"));
+    ASSERT_TRUE(run.storage.find("c") == run.storage.end());
+}
+
+TEST(transaction, expiry_of_a_watched_key_aborts_exec) {
+    session run;
+    run("SET a Ivanov Ivan 2000 Moscow 5 EX 10");
+    run("SET b Ivanov Ivan 2000 Moscow 5 EX 10");
+    run.storage.find("b")->second.life_begin -= std::chrono::seconds(60);
+    run("WATCH a b");
+
+    // nobody reads `a` after its TTL runs out
+    run.storage.find("a")->second.life_begin -= std::chrono::seconds(60);
+    run("MULTI");
+    run("SET c" + kRecord);
+    ASSERT_TRUE(contains(run("EXEC"), "'a' was modified"));
+    ASSERT_TRUE(run.storage.find("c") == run.storage.end());
+
+    // `b` was expired when watched already
+    run("WATCH b");
+    run("MULTI");
+    run("SET c" + kRecord);
+    ASSERT_TRUE(contains(run("EXEC"), "OK"));
+    ASSERT_TRUE(run.storage.find("c") != run.storage.end());
+}
+
+TEST(transaction, unwatch_forgets_the_keys) {
+    session run;
+    run("WATCH a");
+    run("UNWATCH");
+    run("SET a" + kRecord);
+    run("MULTI");
+    run("DEL a");
+    ASSERT_TRUE(contains(run("EXEC"), "true"));
+}
+
+TEST(transaction, queuing_error_aborts_exec) {
+    session run;
+    run("MULTI");
+    run("SET a" + kRecord);
+    ASSERT_TRUE(contains(run("NOSUCHCOMMAND a"), "unknown command"));
+    ASSERT_TRUE(contains(run("EXEC"), "EXECABORT"));
+    ASSERT_TRUE(run.storage.empty());
+
+    // the next transaction starts clean
+    run("MULTI");
+    run("SET a" + kRecord);
+    ASSERT_TRUE(contains(run("EXEC"), "OK"));
+    ASSERT_EQ(run.storage.size(), 1u);
+}
+
+TEST(transaction, blank_lines_are_skipped_while_queuing) {
+    session run;
+    run("MULTI");
+    ASSERT_TRUE(run("").empty());
+    ASSERT_TRUE(run("   ").empty());
+    run("SET a" + kRecord);
+    ASSERT_EQ(run.transaction.Queued(), 1u);
+    ASSERT_TRUE(contains(run("EXEC"), "OK"));
+}
+
+TEST(transaction, watch_unwatch_and_multi_inside_multi_are_refused) {
+    session run;
+    run("WATCH a");
+    run("MULTI");
+    ASSERT_TRUE(contains(run("WATCH b"), "WATCH inside MULTI is not allowed"));
+    ASSERT_TRUE(contains(run("UNWATCH"), "UNWATCH inside MULTI is not allowed"));
+    ASSERT_TRUE(contains(run("MULTI"), "can not be nested"));
+    ASSERT_EQ(run.context.versions.size(), 1u);
+    ASSERT_EQ(run.transaction.Queued(), 0u);
+
+    run("SET a" + kRecord);
+    ASSERT_TRUE(contains(run("EXEC"), "OK"));
+    ASSERT_EQ(run.storage.size(), 1u);
+    ASSERT_TRUE(run.context.versions.empty());
+}
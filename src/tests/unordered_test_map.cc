@@ -2,6 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
 
 TEST(unordered_map, default_constructor) {
     ttl::unordered_map<int, int> map;
@@ -128,3 +133,334 @@ TEST(unordered_map, iter_over) {
 
     ASSERT_TRUE(map.size() == 100);
 }
+
+TEST(unordered_map, split) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    auto ranges = map.split(8);
+    ASSERT_TRUE(ranges.size() > 1 and ranges.size() <= 8);
+
+    std::vector<int> seen;
+    for (auto [first, last] : ranges)
+        for (; first != last; ++first)
+            seen.push_back(first->first);
+
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), 1000);
+    for (int i = 0; i != 1000; ++i)
+        ASSERT_EQ(seen[i], i);
+
+    ttl::unordered_map<int, int> empty;
+    ASSERT_TRUE(empty.split(8).empty());
+}
+
+TEST(unordered_map, scan_survives_resize) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 100; ++i)
+        map.insert({i, i});
+
+    std::vector<int> seen;
+    ttl::unordered_map<int, int>::cursor_type cursor;
+    int inserted = 1000;
+    do {
+        cursor = map.scan(cursor, 7, [&](const auto &kv) { seen.push_back(kv.first); });
+        for (int i = 0; i != 20 and inserted != 1400; ++i, ++inserted)
+            map.insert({inserted, inserted});
+    } while (cursor != ttl::unordered_map<int, int>::cursor_type{});
+
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i != 100; ++i)
+        ASSERT_TRUE(std::binary_search(seen.begin(), seen.end(), i));
+}
+
+TEST(unordered_map, scan_cursor_text) {
+    ttl::unordered_map_cursor cursor {3, 17, 2, 5}, parsed;
+    ASSERT_TRUE(parse_cursor(to_string(cursor), parsed));
+    ASSERT_TRUE(parsed == cursor);
+
+    ASSERT_TRUE(parse_cursor("0", parsed));
+    ASSERT_TRUE(parsed == ttl::unordered_map_cursor{});
+    ASSERT_FALSE(parse_cursor("3.x", parsed));
+    ASSERT_FALSE(parse_cursor("3.1.2", parsed));
+}
+
+TEST(unordered_map, iter_after_mass_erase) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 10000; ++i)
+        map.insert({i, i});
+
+    for (int i = 0; i != 10000; ++i)
+        if (i % 1000 != 0)
+            map.erase(i);
+
+    std::vector<int> seen;
+    for (const auto &[key, value] : map)
+        seen.push_back(key);
+
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), 10);
+    for (int i = 0; i != 10; ++i)
+        ASSERT_EQ(seen[i], i * 1000);
+}
+
+TEST(unordered_map, begin_after_erase_first) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 50; ++i)
+        map.insert({i, i});
+
+    while (!map.empty()) {
+        int first = map.begin()->first;
+        ASSERT_TRUE(map.erase(first));
+        ASSERT_TRUE(map.find(first) == map.end());
+    }
+
+    ASSERT_TRUE(map.begin() == map.end());
+    map.insert({7, 7});
+    ASSERT_EQ(map.begin()->first, 7);
+}
+
+TEST(unordered_map, iterator_equality_in_bucket) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    for (auto it = map.begin(); it != map.end(); ++it)
+        ASSERT_TRUE(map.find(it->first) == it);
+}
+
+TEST(unordered_map, shrinks_after_mass_erase) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 100000; ++i)
+        map.insert({i, i});
+
+    const auto peak = map.bucket_count();
+    for (int i = 100; i != 100000; ++i)
+        map.erase(i);
+
+    ASSERT_TRUE(map.bucket_count() < peak / 100);
+    ASSERT_EQ(map.size(), 100);
+    for (int i = 0; i != 100; ++i)
+        ASSERT_TRUE(map.find(i) != map.end());
+}
+
+TEST(unordered_map, shrink_hysteresis) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 1000; ++i)
+        map.insert({i, i});
+
+    const auto buckets = map.bucket_count();
+    for (int round = 0; round != 10; ++round) {
+        map.erase(999);
+        map.insert({999, 999});
+        ASSERT_EQ(map.bucket_count(), buckets);
+    }
+}
+
+TEST(unordered_map, reserve_non_empty) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 10; ++i)
+        map.insert({i, i});
+
+    map.reserve(10000);
+    const auto buckets = map.bucket_count();
+    ASSERT_TRUE(buckets * 0.75 > 10000);
+    for (int i = 0; i != 10; ++i)
+        ASSERT_EQ(map.find(i)->second, i);
+
+    for (int i = 10; i != 10000; ++i)
+        map.insert({i, i});
+    ASSERT_EQ(map.bucket_count(), buckets);
+
+    map.reserve(10);
+    ASSERT_EQ(map.bucket_count(), buckets);
+}
+
+TEST(unordered_map, shrink_to_fit) {
+    ttl::unordered_map<int, int> map;
+    map.reserve(100000);
+    for (int i = 0; i != 10; ++i)
+        map.insert({i, i});
+
+    map.shrink_to_fit();
+    ASSERT_TRUE(map.bucket_count() < 100);
+    for (int i = 0; i != 10; ++i)
+        ASSERT_EQ(map.find(i)->second, i);
+
+    for (int i = 0; i != 10; ++i)
+        map.erase(i);
+    map.shrink_to_fit();
+    ASSERT_EQ(map.bucket_count(), 0);
+    ASSERT_TRUE(map.begin() == map.end());
+
+    map.insert({1, 1});
+    ASSERT_EQ(map.find(1)->second, 1);
+}
+
+struct constant_hash {
+    std::size_t operator()(int) const noexcept { return 7; }
+};
+
+TEST(unordered_map, chain_stats) {
+    ttl::unordered_map<int, int> map;
+    for (int i = 0; i != 10000; ++i)
+        map.insert({i, i});
+
+    auto stats = map.chain_stats();
+    ASSERT_EQ(stats.buckets, map.bucket_count());
+    ASSERT_EQ(stats.sampled, map.bucket_count());
+    ASSERT_EQ(stats.entries, 10000);
+    ASSERT_FALSE(stats.degraded());
+
+    std::size_t buckets = 0;
+    for (auto count : stats.lengths)
+        buckets += count;
+    ASSERT_EQ(buckets, stats.sampled);
+
+    auto sampled = map.chain_stats(100);
+    ASSERT_TRUE(sampled.sampled >= 100 and sampled.sampled <= 101);
+
+    ttl::unordered_map<int, int, constant_hash> bad;
+    for (int i = 0; i != 100; ++i)
+        bad.insert({i, i});
+
+    auto bad_stats = bad.chain_stats();
+    ASSERT_EQ(bad_stats.max_chain, 100);
+    ASSERT_EQ(bad_stats.lengths[ttl::unordered_map_chain_stats::kTrackedLength], 1);
+    ASSERT_TRUE(bad_stats.degraded());
+}
+
+TEST(unordered_map, probe_counters) {
+    ttl::unordered_map<int, int, constant_hash> map;
+    for (int i = 0; i != 8; ++i)
+        map.insert({i, i});
+
+    map.reset_stats();
+    for (int i = 0; i != 8; ++i)
+        map.find(i);
+    map.find(100);
+
+    const auto &stats = map.stats();
+    ASSERT_EQ(stats.lookups, 9);
+    ASSERT_EQ(stats.hits, 8);
+    ASSERT_EQ(stats.probes_per_hit(), 4.5);
+    ASSERT_EQ(stats.probes_per_miss(), 8.0);
+}
+
+TEST(unordered_map, seeded_hash) {
+    const char *text = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e";
+    const std::uint64_t k0 = 0x0706050403020100ull, k1 = 0x0f0e0d0c0b0a0908ull;
+    ASSERT_EQ(ttl::detail::siphash13(k0, k1, "", 0), 0xabac0158050fc4dcull);
+    ASSERT_EQ(ttl::detail::siphash13(k0, k1, text, 15), 0xd320d86d2a519956ull);
+
+    ttl::seeded_hash<std::string> fixed(k0, k1), same(k0, k1), random, other;
+    ASSERT_EQ(fixed("key"), same("key"));
+    ASSERT_NE(random("key"), other("key"));
+    ASSERT_NE(ttl::seeded_hash<int>(k0, k1)(1), ttl::seeded_hash<int>(k0, k1)(2));
+}
+
+TEST(unordered_map, treeified_bucket) {
+    ttl::unordered_map<int, int, constant_hash> map;
+    for (int i = 0; i != 1000; ++i)
+        ASSERT_TRUE(map.insert({i, i}).second);
+
+    ASSERT_EQ(map.treeified_count(), 1);
+    ASSERT_FALSE(map.insert({500, 0}).second);
+
+    map.reset_stats();
+    for (int i = 0; i != 1000; ++i)
+        ASSERT_EQ(map.find(i)->second, i);
+    ASSERT_TRUE(map.find(1000) == map.end());
+    ASSERT_TRUE(map.stats().probes_per_lookup() <= 1.0);
+
+    for (int i = 0; i != 1000; i += 2)
+        ASSERT_TRUE(map.erase(i));
+    for (int i = 0; i != 1000; ++i)
+        ASSERT_EQ(map.find(i) != map.end(), i % 2 == 1);
+
+    std::size_t count = 0;
+    for (const auto &kv : map)
+        count += kv.first % 2;
+    ASSERT_EQ(count, 500);
+
+    for (int i = 1; i < 995; i += 2)
+        ASSERT_TRUE(map.erase(i));
+    ASSERT_EQ(map.size(), 3);
+    ASSERT_EQ(map.treeified_count(), 0);
+    ASSERT_EQ(map.find(997)->second, 997);
+}
+
+TEST(unordered_map, copy_of_treeified_bucket) {
+    using map_type = ttl::unordered_map<int, int, constant_hash>;
+    auto source = std::make_unique<map_type>();
+    for (int i = 0; i != 20; ++i)
+        source->insert({i, i});
+    ASSERT_EQ(source->treeified_count(), 1);
+
+    map_type copy(*source);
+    map_type assigned;
+    assigned[100] = 100;
+    assigned = *source;
+    source.reset();
+
+    // the copies index their own nodes: the source is gone
+    for (map_type *map : {&copy, &assigned}) {
+        ASSERT_EQ(map->size(), 20);
+        ASSERT_EQ(map->treeified_count(), 1);
+        for (int i = 0; i != 20; ++i)
+            ASSERT_EQ(map->find(i)->second, i);
+        ASSERT_TRUE(map->find(100) == map->end());
+
+        for (int i = 0; i != 20; i += 2)
+            ASSERT_TRUE(map->erase(i));
+        map->insert({20, 20});
+        ASSERT_EQ(map->find(20)->second, 20);
+        ASSERT_EQ(map->find(19)->second, 19);
+    }
+}
+
+TEST(unordered_map, move_of_treeified_bucket) {
+    using map_type = ttl::unordered_map<int, int, constant_hash>;
+    map_type source;
+    for (int i = 0; i != 20; ++i)
+        source.insert({i, i});
+
+    map_type moved(std::move(source));
+    ASSERT_EQ(moved.treeified_count(), 1);
+    for (int i = 0; i != 20; ++i)
+        ASSERT_EQ(moved.find(i)->second, i);
+
+    // a moved-from map is empty and usable
+    ASSERT_TRUE(source.empty());
+    ASSERT_TRUE(source.find(1) == source.end());
+    ASSERT_TRUE(source.begin() == source.end());
+    source[1] = 1;
+    ASSERT_EQ(source.find(1)->second, 1);
+
+    source = std::move(moved);
+    ASSERT_EQ(source.size(), 20);
+    ASSERT_EQ(source.find(19)->second, 19);
+}
+
+struct unordered_key {
+    int value;
+    bool operator==(const unordered_key &other) const { return value == other.value; }
+};
+
+struct unordered_key_hash {
+    std::size_t operator()(const unordered_key &key) const noexcept { return key.value % 3; }
+};
+
+TEST(unordered_map, treeified_bucket_unordered_keys) {
+    ttl::unordered_map<unordered_key, int, unordered_key_hash> map;
+    for (int i = 0; i != 300; ++i)
+        map.insert({unordered_key{i}, i});
+
+    ASSERT_TRUE(map.treeified_count() > 0);
+    for (int i = 0; i != 300; ++i)
+        ASSERT_EQ(map.find(unordered_key{i})->second, i);
+    for (int i = 0; i != 300; ++i)
+        ASSERT_TRUE(map.erase(unordered_key{i}));
+    ASSERT_TRUE(map.empty());
+}
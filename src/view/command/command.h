@@ -1,46 +1,128 @@
 #ifndef TRANSACTIONS_LIBRARY_CPP_COMMAND_H
 #define TRANSACTIONS_LIBRARY_CPP_COMMAND_H
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include "student.h"
+#include "student_predicate.h"
+#include "student_snapshot.h"
 #include "termcolor.h"
+#include "allocation_counter.h"
+#include "command_context.h"
+#include "engine_stats.h"
+#include "engine_traits.h"
+#include "glob.h"
+#include "memory_usage.h"
 
 using namespace termcolor;
 
 namespace ttl {
+    /*
+     * What every command shares: the context it reports to and the helpers
+     * over it. Not an interface: commands aren't used through a pointer to
+     * it but held by value in a Command (see the end of this file), which
+     * calls their Execute directly.
+     */
     template <typename AssociativeContainer>
-    class ICommand {
+    class CommandBase {
     public:
         using key_type = typename AssociativeContainer::key_type;
         using mapped_type = typename AssociativeContainer::mapped_type;
 
-        virtual ~ICommand() = default;
-        virtual void Execute(AssociativeContainer &storage) = 0;
+        void Bind(CommandContext<AssociativeContainer> *context, std::string name = {}) {
+            context_ = context;
+            name_ = std::move(name);
+        }
+
+        // Calls execute() and, when a context is bound, records its latency and allocations for INFO STATS.
+        template <typename Functor>
+        void Measure(Functor execute) {
+            if (!context_) {
+                execute();
+                return;
+            }
+
+            using namespace std::chrono;
+            const allocation_scope allocations;
+            auto begin = steady_clock::now();
+            execute();
+            auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+            context_->stats.Record(name_, static_cast<std::uint64_t>(elapsed), allocations.allocations());
+        }
+
+    protected:
+        CommandContext<AssociativeContainer> *context_ = nullptr;
+        std::string name_;
+
+        void NotifyAssign(const key_type &key, const mapped_type &mapped) {
+            if (context_) context_->OnAssign(key, mapped);
+        }
+
+        void NotifyErase(const key_type &key) {
+            if (context_) context_->OnErase(key);
+        }
+
+        void NotifyAccess(const key_type &key) {
+            if (context_) context_->OnAccess(key);
+        }
+
+        // Makes room under maxmemory before a write of `keep`; prints the refusal when it can't.
+        bool Reclaim(AssociativeContainer &storage, const key_type *keep = nullptr) {
+            if (!context_ or context_->Reclaim(storage, keep))
+                return true;
+
+            std::cout << red << "> OOM maxmemory reached and no key can be evicted under '"
+                      << eviction_policy_name(context_->policy) << "'" << reset << std::endl;
+            return false;
+        }
+
+        // Maps functor(first, last) over parts of the storage, in parallel when a context is bound.
+        template <typename Functor>
+        auto Scan(AssociativeContainer &storage, Functor functor) {
+            if (context_)
+                return context_->executor.Map(storage, functor);
+
+            using result_type = decltype(functor(storage.begin(), storage.end()));
+            return std::vector<result_type>{functor(storage.begin(), storage.end())};
+        }
     };
 
     template <typename AssociativeContainer>
-    class SetCommand : public ICommand<AssociativeContainer> {
+    class SetCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         SetCommand(key_type &&key, mapped_type &&mapped)
             : key_(std::move(key)), mapped_(std::move(mapped)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key_) != storage.end()) {
                 std::cout << red << "> key '" << key_ << "' already exists" << reset << std::endl;
                 return;
             }
 
-            if constexpr(std::is_same_v<mapped_type, Student>)
+            if (!this->Reclaim(storage))
+                return;
+
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl)
                 if (mapped_.time != -1)
                     mapped_.life_begin = std::chrono::system_clock::now();
 
-            storage[std::move(key_)] = std::move(mapped_);
+            mapped_type &stored = storage[key_];
+            stored = std::move(mapped_);
+            this->NotifyAssign(key_, stored);
             std::cout << green << "> OK" << reset << std::endl;
         }
 
@@ -50,15 +132,15 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class GetCommand : public ICommand<AssociativeContainer> {
+    class GetCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit GetCommand(key_type &&key)
             : key_(std::move(key)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (key_ == key_type{} or storage.find(key_) == storage.end()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
@@ -67,14 +149,16 @@ namespace ttl {
             using namespace std::chrono;
             mapped_type &mapped = storage[key_];
 
-            if constexpr(std::is_same_v<mapped_type, Student>) {
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl) {
                 auto time_delta = duration_cast<seconds>(system_clock::now() - mapped.life_begin).count();
                 if (mapped.time != -1 and time_delta > mapped.time * 1000) {
                     storage.erase(storage.find(key_));
+                    this->NotifyErase(key_);
                     std::cout << red << "> (null)" << reset << std::endl;
                     return;
                 }
             }
+            this->NotifyAccess(key_);
             std::cout << green << "> " << storage[key_] << reset << std::endl;
         }
 
@@ -83,15 +167,15 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class ExistsCommand : public ICommand<AssociativeContainer> {
+    class ExistsCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit ExistsCommand(key_type &&key)
             : key_(std::move(key)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key_) == storage.end()) {
                 std::cout << red << "> false" << reset << std::endl;
                 return;
@@ -105,21 +189,22 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class DeleteCommand : public ICommand<AssociativeContainer> {
+    class DeleteCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit DeleteCommand(key_type &&key)
             : key_(std::move(key)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key_) == storage.end()) {
                 std::cout << red << "> false" << reset << std::endl;
                 return;
             }
 
             storage.erase(storage.find(key_));
+            this->NotifyErase(key_);
             std::cout << green << "> true" << reset << std::endl;
         }
 
@@ -128,27 +213,32 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class UpdateCommand : public ICommand<AssociativeContainer> {
+    class UpdateCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
 
         UpdateCommand(key_type &&key, mapped_type &&mapped)
             : key_(std::move(key)), mapped_(std::move(mapped)) {
         }
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key_) == storage.end()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
             }
 
+            if (!this->Reclaim(storage, &key_))
+                return;
+
             using namespace std::chrono;
-            if constexpr (std::is_same_v<mapped_type, Student>)
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl)
                 if (mapped_.time != -1)
                     mapped_.life_begin = system_clock::now();
 
-            storage[key_] = mapped_;
+            mapped_type &stored = storage[key_];
+            stored = mapped_;
+            this->NotifyAssign(key_, stored);
             std::cout << green << "> OK" << reset << std::endl;
         }
 
@@ -158,34 +248,42 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class KeysCommand : public ICommand<AssociativeContainer> {
+    class KeysCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.empty()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
             }
 
+            auto parts = this->Scan(storage, [](auto first, auto last) {
+                std::vector<const key_type *> keys;
+                for (; first != last; ++first)
+                    keys.push_back(&first->first);
+                return keys;
+            });
+
             int count = 0;
-            for (const auto &[key, mapped] : storage)
-                std::cout << green << ++count << ") " << key << std::endl;
+            for (const auto &keys : parts)
+                for (const key_type *key : keys)
+                    std::cout << green << ++count << ") " << *key << std::endl;
             std::cout << reset;
         }
     };
 
     template <typename AssociativeContainer>
-    class RenameCommand : public ICommand<AssociativeContainer> {
+    class RenameCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         RenameCommand(key_type &&key1, key_type &&key2)
             : key1_(std::move(key1)), key2_(std::move(key2)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key1_) == storage.end()) {
                 std::cout << red << "> key '" << key1_ << "' doesn't exists in storage" << reset << std::endl;
                 return;
@@ -199,7 +297,9 @@ namespace ttl {
 
             mapped_type saved = storage[key1_];
             storage.erase(storage.find(key1_));
+            this->NotifyErase(key1_);
             storage.insert({key2_, saved});
+            this->NotifyAssign(key2_, saved);
             std::cout << green << "> OK" << reset << std::endl;
         }
 
@@ -209,21 +309,21 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class TTLCommand : public ICommand<AssociativeContainer> {
+    class TTLCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit TTLCommand(key_type &&key)
             : key_(std::move(key)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.find(key_) == storage.end()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
             }
 
-            if constexpr (std::is_same_v<mapped_type, Student>) {
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl) {
                 mapped_type &mapped = storage[key_];
                 if (mapped.time == -1) {
                     std::cout << green << "> (inf)" << reset << std::endl;
@@ -235,6 +335,7 @@ namespace ttl {
 
                 if (delta > mapped.time) {
                     storage.erase(storage.find(key_));
+                    this->NotifyErase(key_);
                     std::cout << red << "> (null)" << reset << std::endl;
                     return;
                 }
@@ -248,29 +349,96 @@ namespace ttl {
     };
 
     template <typename AssociativeContainer>
-    class FindCommand : public ICommand<AssociativeContainer> {
+    class FindCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit FindCommand(mapped_type &&mapped)
             : mapped_(std::move(mapped)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.empty()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
             }
 
+            if constexpr (std::is_same_v<mapped_type, Student>) {
+                if (this->context_) {
+                    auto plan = this->context_->indexes.plan(mapped_);
+                    if (!plan.empty()) {
+                        ExecuteIndexed(storage, plan);
+                        return;
+                    }
+                }
+
+                if (this->context_ and this->context_->columns) {
+                    ExecuteColumnar(*this->context_->columns);
+                    return;
+                }
+
+                ExecuteScan(storage, student_predicate(mapped_));
+            } else {
+                ExecuteScan(storage, [this](const mapped_type &mapped) { return mapped == mapped_; });
+            }
+        }
+
+    private:
+        mapped_type mapped_;
+
+        template <typename Predicate>
+        void ExecuteScan(AssociativeContainer &storage, const Predicate &matches) {
+            auto parts = this->Scan(storage, [&matches](auto first, auto last) {
+                using namespace std::chrono;
+
+                std::vector<const key_type *> keys;
+                for (; first != last; ++first) {
+                    const auto &[key, mapped] = *first;
+                    if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl)
+                        if (mapped.time != -1 and duration_cast<seconds>(system_clock::now() - mapped.life_begin).count() > mapped.time * 1000)
+                            continue;
+
+                    if (matches(mapped))
+                        keys.push_back(&key);
+                }
+                return keys;
+            });
+
             int count = 0;
+            for (const auto &keys : parts) {
+                for (const key_type *key : keys) {
+                    std::cout << green << "> " << *key << reset << std::endl;
+                    ++count;
+                }
+            }
+
+            if (count == 0)
+                std::cout << red << "> (null)" << reset << std::endl;
+        }
 
+        template <typename Postings>
+        void ExecuteIndexed(AssociativeContainer &storage, const std::vector<const Postings *> &plan) {
             using namespace std::chrono;
-            for (const auto &[key, mapped] : storage) {
-                if constexpr (std::is_same_v<mapped_type, Student>)
-                    if (mapped.time != -1 and duration_cast<seconds>(system_clock::now() - mapped.life_begin).count() > mapped.time * 1000)
-                        continue;
+            const auto now = system_clock::now();
+            const student_predicate matches(mapped_);
+
+            int count = 0;
+            for (const key_type &key : *plan.front()) {
+                bool in_all = std::all_of(plan.begin() + 1, plan.end(), [&](const Postings *postings) {
+                    return postings->count(key) != 0;
+                });
+                if (!in_all)
+                    continue;
 
-                if (mapped == mapped_) {
+                auto it = storage.find(key);
+                if (it == storage.end())
+                    continue;
+
+                const mapped_type &mapped = it->second;
+                if (mapped.time != -1 and duration_cast<seconds>(now - mapped.life_begin).count() > mapped.time * 1000)
+                    continue;
+
+                if (matches(mapped)) {
                     std::cout << green << "> " << key << reset << std::endl;
                     ++count;
                 }
@@ -280,17 +448,32 @@ namespace ttl {
                 std::cout << red << "> (null)" << reset << std::endl;
         }
 
-    private:
-        mapped_type mapped_;
+        void ExecuteColumnar(const student_columns<key_type> &columns) {
+            using namespace std::chrono;
+            const auto now = system_clock::now();
+
+            int count = 0;
+            columns.for_each(columns.find(mapped_), [&](std::size_t row) {
+                int time = columns.time(row);
+                if (time != -1 and duration_cast<seconds>(now - columns.life_begin(row)).count() > time * 1000)
+                    return;
+
+                std::cout << green << "> " << columns.key(row) << reset << std::endl;
+                ++count;
+            });
+
+            if (count == 0)
+                std::cout << red << "> (null)" << reset << std::endl;
+        }
     };
 
     template <typename AssociativeContainer>
-    class ShowAllCommand : public ICommand<AssociativeContainer> {
+    class ShowAllCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             if (storage.empty()) {
                 std::cout << red << "> (null)" << reset << std::endl;
                 return;
@@ -299,39 +482,57 @@ namespace ttl {
             if constexpr (std::is_same_v<mapped_type, Student>)
                 std::cout << "> Key Surname Name Year City Coins Life Time" << '\n';
 
-            for (const auto &[key, mapped] : storage)
-                std::cout << green << "> " << key << ' ' << mapped << std::endl;
-            std::cout << reset;
+            auto parts = this->Scan(storage, [](auto first, auto last) {
+                std::ostringstream lines;
+                for (; first != last; ++first)
+                    lines << "> " << first->first << ' ' << first->second << '\n';
+                return lines.str();
+            });
+
+            for (const auto &lines : parts)
+                std::cout << green << lines;
+            std::cout << reset << std::flush;
         }
     };
 
     template <typename AssociativeContainer>
-    class UploadCommand : public ICommand<AssociativeContainer> {
+    class UploadCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit UploadCommand(std::string &&path)
             : path_(std::move(path)) {}
 
-        void Execute(AssociativeContainer &storage) override {
-            std::ifstream file(path_);
+        void Execute(AssociativeContainer &storage) {
+            std::ifstream file(path_, std::ios::binary);
             if (!file.is_open()) {
                 std::cout << red << "> Can't create or open the file by path '"
                           << path_ << "'" << reset << std::endl;
                 return;
             }
 
+            std::size_t read_count = 0;
+            if constexpr (std::is_same_v<key_type, std::string> and std::is_same_v<mapped_type, Student>) {
+                if (snapshot::is_snapshot(file)) {
+                    read_count = snapshot::read_records(file, [&](const key_type &key, mapped_type &mapped) {
+                        return Store(storage, key, mapped);
+                    });
+                    std::cout << green << "> OK " << read_count << reset << std::endl;
+                    return;
+                }
+            }
+
             key_type key;
-            mapped_type mapped;
             std::string line;
             std::stringstream ss;
 
-            std::size_t read_count = 0;
             while (std::getline(file, line)) {
                 if (line.empty())
                     continue;
 
+                // fresh per line: a record without EX must not inherit the previous one's life time
+                mapped_type mapped;
                 ss.clear();
                 ss.str(line);
                 ss >> key;
@@ -342,12 +543,8 @@ namespace ttl {
                     continue;
                 }
 
-                using namespace std::chrono;
-                if constexpr (std::is_same_v<mapped_type, Student>)
-                    if (mapped.time != -1)
-                        mapped.life_begin = system_clock::now();
-
-                storage[key] = std::move(mapped);
+                if (!Store(storage, key, mapped))
+                    break;
                 ++read_count;
             }
 
@@ -357,18 +554,34 @@ namespace ttl {
 
     private:
         std::string path_;
+
+        // false once eviction can't make room, which ends the upload
+        bool Store(AssociativeContainer &storage, const key_type &key, mapped_type &mapped) {
+            if (!this->Reclaim(storage, &key))
+                return false;
+
+            using namespace std::chrono;
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl)
+                if (mapped.time != -1)
+                    mapped.life_begin = system_clock::now();
+
+            mapped_type &stored = storage[key];
+            stored = std::move(mapped);
+            this->NotifyAssign(key, stored);
+            return true;
+        }
     };
 
     template <typename AssociativeContainer>
-    class ExportCommand : public ICommand<AssociativeContainer> {
+    class ExportCommand : public CommandBase<AssociativeContainer> {
     public:
-        using typename ICommand<AssociativeContainer>::key_type;
-        using typename ICommand<AssociativeContainer>::mapped_type;
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
         
         explicit ExportCommand(std::string &&path)
                 : path_(std::move(path)) {}
 
-        void Execute(AssociativeContainer &storage) override {
+        void Execute(AssociativeContainer &storage) {
             std::ofstream file(path_);
             if (!file.is_open()) {
                 std::cout << red << "> Can't create or open the file by path '" << path_ << "'" << reset << std::endl;
@@ -388,6 +601,666 @@ namespace ttl {
     private:
         std::string path_;
     };
+
+    template <typename AssociativeContainer>
+    class ColumnarCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        explicit ColumnarCommand(bool enable)
+            : enable_(enable) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if (!this->context_ or !std::is_same_v<mapped_type, Student>) {
+                std::cout << red << "> columnar store is not available for this storage" << reset << std::endl;
+                return;
+            }
+
+            auto &columns = this->context_->columns;
+            if (!enable_) {
+                columns.reset();
+                std::cout << green << "> OK" << reset << std::endl;
+                return;
+            }
+
+            if constexpr (std::is_same_v<mapped_type, Student>) {
+                columns.emplace();
+                columns->reserve(storage.size());
+                for (const auto &[key, mapped] : storage)
+                    columns->assign(key, mapped);
+            }
+
+            std::cout << green << "> OK " << columns->size() << reset << std::endl;
+        }
+
+    private:
+        bool enable_;
+    };
+
+    template <typename AssociativeContainer>
+    class IndexCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        enum class Action {
+            kCreate,
+            kDrop,
+            kList,
+            kRange
+        };
+
+        IndexCommand(Action action, std::string &&field, std::string &&argument1, std::string &&argument2)
+            : action_(action), field_(std::move(field)), argument1_(std::move(argument1)), argument2_(std::move(argument2)) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!std::is_same_v<mapped_type, Student>) {
+                std::cout << red << "> indexes are not available for this storage" << reset << std::endl;
+            } else {
+                if (!this->context_) {
+                    std::cout << red << "> indexes are not available for this storage" << reset << std::endl;
+                    return;
+                }
+
+                auto &indexes = this->context_->indexes;
+                if (action_ == Action::kList) {
+                    List(indexes);
+                    return;
+                }
+
+                auto field = parse_student_field(field_);
+                if (!field) {
+                    std::cout << red << "> unknown field '" << field_ << "'" << reset << std::endl;
+                    return;
+                }
+
+                if (action_ == Action::kCreate)
+                    Create(storage, indexes, *field);
+                else if (action_ == Action::kDrop)
+                    Drop(indexes, *field);
+                else
+                    Range(indexes, *field);
+            }
+        }
+
+    private:
+        Action action_;
+        std::string field_;
+        std::string argument1_;
+        std::string argument2_;
+
+        void Create(AssociativeContainer &storage, student_indexes<key_type> &indexes, student_field field) {
+            if (!argument1_.empty() and argument1_ != "HASH" and argument1_ != "ORDERED") {
+                std::cout << red << "> unknown index type '" << argument1_ << "'" << reset << std::endl;
+                return;
+            }
+
+            auto type = argument1_ == "ORDERED" ? student_index_type::kOrdered : student_index_type::kHash;
+            auto *index = indexes.create(field, type);
+            if (!index) {
+                std::cout << red << "> field '" << field_ << "' is already indexed" << reset << std::endl;
+                return;
+            }
+
+            for (const auto &[key, mapped] : storage)
+                index->assign(key, mapped);
+
+            std::cout << green << "> OK " << index->values_count() << reset << std::endl;
+        }
+
+        void Drop(student_indexes<key_type> &indexes, student_field field) {
+            if (!indexes.drop(field)) {
+                std::cout << red << "> false" << reset << std::endl;
+                return;
+            }
+
+            std::cout << green << "> true" << reset << std::endl;
+        }
+
+        void Range(const student_indexes<key_type> &indexes, student_field field) {
+            const auto *index = indexes.get(field);
+
+            std::vector<key_type> keys;
+            if (!index or !index->range(argument1_, argument2_, keys)) {
+                std::cout << red << "> field '" << field_ << "' has no ordered index" << reset << std::endl;
+                return;
+            }
+
+            if (keys.empty()) {
+                std::cout << red << "> (null)" << reset << std::endl;
+                return;
+            }
+
+            int count = 0;
+            for (const auto &key : keys)
+                std::cout << green << ++count << ") " << key << std::endl;
+            std::cout << reset;
+        }
+
+        void List(const student_indexes<key_type> &indexes) {
+            if (indexes.empty()) {
+                std::cout << red << "> (null)" << reset << std::endl;
+                return;
+            }
+
+            for (std::size_t i = 0; i != static_cast<std::size_t>(student_field::kCount); ++i) {
+                const auto *index = indexes.get(static_cast<student_field>(i));
+                if (!index)
+                    continue;
+
+                std::cout << green << "> " << student_field_name(index->field()) << ' '
+                          << (index->type() == student_index_type::kHash ? "HASH" : "ORDERED") << ' '
+                          << index->values_count() << reset << std::endl;
+            }
+        }
+    };
+
+    template <typename AssociativeContainer>
+    class ScanCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        static constexpr std::size_t kDefaultCount = 10;
+
+        ScanCommand(std::string &&cursor, std::string &&match, std::size_t count)
+            : cursor_(std::move(cursor)), match_(std::move(match)), count_(count) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kScannable) {
+                std::cout << red << "> SCAN is not supported by this storage" << reset << std::endl;
+            } else {
+                typename AssociativeContainer::cursor_type cursor;
+                if (!parse_cursor(cursor_, cursor)) {
+                    std::cout << red << "> invalid cursor '" << cursor_ << "'" << reset << std::endl;
+                    return;
+                }
+
+                std::vector<key_type> keys;
+                auto next = storage.scan(cursor, count_, [&](const auto &kv) {
+                    if (Matches(kv.first))
+                        keys.push_back(kv.first);
+                });
+
+                std::cout << green << "> " << to_string(next) << '\n';
+                int count = 0;
+                for (const auto &key : keys)
+                    std::cout << ++count << ") " << key << '\n';
+                std::cout << reset << std::flush;
+            }
+        }
+
+    private:
+        std::string cursor_;
+        std::string match_;
+        std::size_t count_;
+
+        bool Matches(const key_type &key) const {
+            if (match_.empty())
+                return true;
+
+            if constexpr (std::is_same_v<key_type, std::string>) {
+                return GlobMatch(match_, key);
+            } else {
+                std::ostringstream ss;
+                ss << key;
+                return GlobMatch(match_, ss.str());
+            }
+        }
+    };
+
+    template <typename AssociativeContainer>
+    class RangeCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        RangeCommand(key_type &&from, key_type &&to, std::size_t limit)
+            : from_(std::move(from)), to_(std::move(to)), limit_(limit) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kOrdered) {
+                std::cout << red << "> RANGE is not supported by this storage" << reset << std::endl;
+            } else {
+                // a reversed range is empty; walking from lower_bound(from) would never meet upper_bound(to)
+                int count = 0;
+                if (!(to_ < from_))
+                    for (auto it = storage.lower_bound(from_), last = storage.upper_bound(to_);
+                         it != last and static_cast<std::size_t>(count) != limit_; ++it)
+                        std::cout << green << ++count << ") " << it->first << '\n';
+
+                if (count == 0)
+                    std::cout << red << "> (null)" << '\n';
+                std::cout << reset << std::flush;
+            }
+        }
+
+    private:
+        key_type from_;
+        key_type to_;
+        std::size_t limit_;
+    };
+
+    template <typename AssociativeContainer>
+    class PrefixCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        explicit PrefixCommand(key_type &&prefix)
+            : prefix_(std::move(prefix)) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kOrdered or !std::is_same_v<key_type, std::string>) {
+                std::cout << red << "> PREFIX is not supported by this storage" << reset << std::endl;
+            } else {
+                int count = 0;
+                for (auto it = storage.lower_bound(prefix_), last = storage.end();
+                     it != last and it->first.compare(0, prefix_.size(), prefix_) == 0; ++it)
+                    std::cout << green << ++count << ") " << it->first << '\n';
+
+                if (count == 0)
+                    std::cout << red << "> (null)" << '\n';
+                std::cout << reset << std::flush;
+            }
+        }
+
+    private:
+        key_type prefix_;
+    };
+
+    template <typename AssociativeContainer>
+    class RankCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        explicit RankCommand(key_type &&key)
+            : key_(std::move(key)) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kOrderStatistics) {
+                std::cout << red << "> RANK is not supported by this storage" << reset << std::endl;
+            } else {
+                if (storage.find(key_) == storage.end()) {
+                    std::cout << red << "> (null)" << reset << std::endl;
+                    return;
+                }
+
+                std::cout << green << "> " << storage.rank(key_) << reset << std::endl;
+            }
+        }
+
+    private:
+        key_type key_;
+    };
+
+    template <typename AssociativeContainer>
+    class SelectCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        explicit SelectCommand(std::size_t index)
+            : index_(index) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kOrderStatistics) {
+                std::cout << red << "> SELECT is not supported by this storage" << reset << std::endl;
+            } else {
+                auto it = storage.select(index_);
+                if (it == storage.end()) {
+                    std::cout << red << "> (null)" << reset << std::endl;
+                    return;
+                }
+
+                std::cout << green << "> " << it->first << reset << std::endl;
+            }
+        }
+
+    private:
+        std::size_t index_;
+    };
+
+    template <typename AssociativeContainer>
+    class CountCommand : public CommandBase<AssociativeContainer> {
+    public:
+        using typename CommandBase<AssociativeContainer>::key_type;
+        using typename CommandBase<AssociativeContainer>::mapped_type;
+
+        CountCommand(key_type &&from, key_type &&to)
+            : from_(std::move(from)), to_(std::move(to)) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kOrderStatistics) {
+                std::cout << red << "> COUNT is not supported by this storage" << reset << std::endl;
+            } else {
+                std::cout << green << "> " << storage.count_range(from_, to_) << reset << std::endl;
+            }
+        }
+
+    private:
+        key_type from_;
+        key_type to_;
+    };
+
+    template <typename AssociativeContainer>
+    class CompactCommand : public CommandBase<AssociativeContainer> {
+    public:
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (!engine_traits<AssociativeContainer>::kShrinkable) {
+                std::cout << red << "> COMPACT is not supported by this storage" << reset << std::endl;
+            } else {
+                auto before = storage.bucket_count();
+                storage.shrink_to_fit();
+                std::cout << green << "> OK " << before << " -> " << storage.bucket_count() << " buckets"
+                          << reset << std::endl;
+            }
+        }
+    };
+
+    template <typename AssociativeContainer>
+    class InfoCommand : public CommandBase<AssociativeContainer> {
+    public:
+        enum class Section {
+            kMemory,
+            kStats
+        };
+
+        explicit InfoCommand(Section section, bool json = false)
+            : section_(section), json_(json) {}
+
+        void Execute(AssociativeContainer &storage) {
+            switch (section_) {
+                case Section::kMemory: ExecuteMemory(storage); break;
+                case Section::kStats:  json_ ? ExecuteStatsJson(storage) : ExecuteStats(storage); break;
+            }
+        }
+
+    private:
+        Section section_;
+        bool json_;
+
+        static constexpr std::array<std::pair<const char *, double>, 3> kPercentiles = {{
+                {"p50", 0.5}, {"p99", 0.99}, {"p999", 0.999}
+        }};
+
+        void ExecuteMemory(const AssociativeContainer &storage) const {
+            const memory_stats stats = storage.memory();
+
+            std::cout << green << "> # Memory" << '\n' << std::fixed << std::setprecision(2);
+            std::cout << "entries:" << stats.entries << '\n';
+            std::cout << "used_memory:" << stats.total() << '\n';
+            std::cout << "table_bytes:" << stats.table_bytes << '\n';
+            std::cout << "node_bytes:" << stats.node_bytes << '\n';
+            std::cout << "heap_bytes:" << stats.heap_bytes << '\n';
+            std::cout << "payload_bytes:" << stats.payload_bytes << '\n';
+            std::cout << "bytes_per_entry:" << stats.bytes_per_entry() << '\n';
+            std::cout << "overhead_ratio:" << stats.overhead_ratio() << '\n';
+            if (stats.buckets != 0) {
+                std::cout << "buckets:" << stats.buckets << '\n';
+                std::cout << "load_factor:" << stats.load_factor() << '\n';
+            }
+            if (this->context_) {
+                std::cout << "maxmemory:" << this->context_->maxmemory << '\n';
+                std::cout << "maxmemory_policy:" << eviction_policy_name(this->context_->policy) << '\n';
+                std::cout << "evicted_keys:" << this->context_->evicted_keys << '\n';
+            }
+            std::cout << std::defaultfloat << reset << std::flush;
+        }
+
+        void ExecuteStats(const AssociativeContainer &storage) const {
+            const engine_stats &engine = storage.stats();
+
+            std::cout << green << "> # Stats" << '\n' << std::fixed << std::setprecision(2);
+            if (this->context_) {
+                const CommandStats &stats = this->context_->stats;
+                std::cout << "uptime_seconds:" << stats.Uptime() << '\n';
+                std::cout << "total_commands:" << stats.Total() << '\n';
+                std::cout << "ops_per_sec:" << stats.Throughput() << '\n';
+
+                for (const auto &[command, latency] : stats.Commands()) {
+                    std::cout << "cmdstat_" << command << ":calls=" << latency.count()
+                              << ",mean_us=" << latency.mean() / 1000.0;
+                    for (const auto &[name, quantile] : kPercentiles)
+                        std::cout << ',' << name << "_us=" << static_cast<double>(latency.percentile(quantile)) / 1000.0;
+                    std::cout << ",max_us=" << static_cast<double>(latency.max()) / 1000.0;
+                    if (allocation_counter::enabled())
+                        std::cout << ",allocs_per_call=" << stats.AllocationsPerCall(command);
+                    std::cout << '\n';
+                }
+            }
+
+            std::cout << "engine_lookups:" << engine.lookups << '\n';
+            std::cout << "engine_probes_per_lookup:" << engine.probes_per_lookup() << '\n';
+            std::cout << "engine_probes_per_hit:" << engine.probes_per_hit() << '\n';
+            std::cout << "engine_probes_per_miss:" << engine.probes_per_miss() << '\n';
+            std::cout << "engine_inserts:" << engine.inserts << '\n';
+            std::cout << "engine_erases:" << engine.erases << '\n';
+            std::cout << "engine_rotations_per_write:" << engine.rotations_per_write() << '\n';
+            std::cout << "engine_rehashes:" << engine.rehashes << '\n';
+            std::cout << std::defaultfloat << reset << std::flush;
+        }
+
+        // one JSON object on one line, latencies in nanoseconds
+        void ExecuteStatsJson(const AssociativeContainer &storage) const {
+            const engine_stats &engine = storage.stats();
+
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(3) << '{';
+            if (this->context_) {
+                const CommandStats &stats = this->context_->stats;
+                out << "\"uptime_seconds\":" << stats.Uptime() << ",\"total_commands\":" << stats.Total()
+                    << ",\"ops_per_sec\":" << stats.Throughput() << ",\"commands\":{";
+
+                bool first = true;
+                for (const auto &[command, latency] : stats.Commands()) {
+                    out << (first ? "" : ",") << '"' << command << "\":{\"calls\":" << latency.count()
+                        << ",\"mean_ns\":" << latency.mean();
+                    for (const auto &[name, quantile] : kPercentiles)
+                        out << ",\"" << name << "_ns\":" << latency.percentile(quantile);
+                    out << ",\"max_ns\":" << latency.max();
+                    if (allocation_counter::enabled())
+                        out << ",\"allocs_per_call\":" << stats.AllocationsPerCall(command);
+                    out << '}';
+                    first = false;
+                }
+                out << "},";
+            }
+
+            out << "\"engine\":{\"lookups\":" << engine.lookups << ",\"probes\":" << engine.probes
+                << ",\"hits\":" << engine.hits << ",\"hit_probes\":" << engine.hit_probes
+                << ",\"inserts\":" << engine.inserts << ",\"erases\":" << engine.erases
+                << ",\"rotations\":" << engine.rotations << ",\"rehashes\":" << engine.rehashes << "}}";
+
+            std::cout << green << "> " << out.str() << reset << std::endl;
+        }
+    };
+
+    template <typename AssociativeContainer>
+    class ConfigCommand : public CommandBase<AssociativeContainer> {
+    public:
+        ConfigCommand(std::string &&name, std::optional<std::string> &&value)
+            : name_(std::move(name)), value_(std::move(value)) {}
+
+        void Execute(AssociativeContainer &storage) {
+            auto *context = this->context_;
+            if (!context) {
+                std::cout << red << "> CONFIG is not available for this storage" << reset << std::endl;
+                return;
+            }
+
+            if (!value_) {
+                if (name_ == "maxmemory")
+                    std::cout << green << "> " << context->maxmemory << reset << std::endl;
+                else if (name_ == "maxmemory-policy")
+                    std::cout << green << "> " << eviction_policy_name(context->policy) << reset << std::endl;
+                else if (name_ == "maxmemory-samples")
+                    std::cout << green << "> " << context->samples << reset << std::endl;
+                else
+                    std::cout << red << "> unknown parameter '" << name_ << "'" << reset << std::endl;
+                return;
+            }
+
+            if (name_ == "maxmemory") {
+                auto bytes = parse_memory_size(*value_);
+                if (!bytes) {
+                    std::cout << red << "> invalid memory size '" << *value_ << "'" << reset << std::endl;
+                    return;
+                }
+
+                context->SetMaxMemory(storage, *bytes);
+                if (!this->Reclaim(storage))
+                    return;
+            } else if (name_ == "maxmemory-policy") {
+                auto policy = parse_eviction_policy(*value_);
+                if (!policy) {
+                    std::cout << red << "> unknown policy '" << *value_ << "'" << reset << std::endl;
+                    return;
+                }
+
+                context->policy = *policy;
+            } else if (name_ == "maxmemory-samples") {
+                std::size_t samples = 0;
+                std::stringstream(*value_) >> samples;
+                if (samples == 0) {
+                    std::cout << red << "> invalid sample count '" << *value_ << "'" << reset << std::endl;
+                    return;
+                }
+
+                context->samples = samples;
+                if (context->eviction)
+                    context->eviction->set_samples(samples);
+            } else {
+                std::cout << red << "> unknown parameter '" << name_ << "'" << reset << std::endl;
+                return;
+            }
+
+            std::cout << green << "> OK" << reset << std::endl;
+        }
+
+    private:
+        std::string name_;
+        std::optional<std::string> value_;
+    };
+
+    template <typename AssociativeContainer>
+    class DebugHashStatsCommand : public CommandBase<AssociativeContainer> {
+    public:
+        // 0 walks every bucket
+        explicit DebugHashStatsCommand(std::size_t sample)
+            : sample_(sample) {}
+
+        void Execute(AssociativeContainer &storage) {
+            if constexpr (detail::has_probe_stats<AssociativeContainer>::value) {
+                ShowProbeStats(storage.probe_stats(sample_));
+            } else if constexpr (!detail::has_chain_stats<AssociativeContainer>::value) {
+                std::cout << red << "> DEBUG HTSTATS is not supported by this storage" << reset << std::endl;
+            } else {
+                const auto stats = storage.chain_stats(sample_);
+
+                std::cout << green << "> # Hash table" << '\n' << std::fixed << std::setprecision(2);
+                std::cout << "buckets:" << stats.buckets << '\n';
+                std::cout << "sampled_buckets:" << stats.sampled << '\n';
+                std::cout << "treeified_buckets:" << storage.treeified_count() << '\n';
+                std::cout << "load_factor:" << stats.load_factor() << '\n';
+                std::cout << "max_chain:" << stats.max_chain << '\n';
+                std::cout << "probes_per_hit:" << stats.probes_per_hit()
+                          << " (uniform hash: " << stats.expected_probes_per_hit() << ")\n";
+                std::cout << "probes_per_miss:" << stats.probes_per_miss() << '\n';
+
+                std::cout << "chain_lengths:";
+                for (std::size_t length = 0; length != stats.lengths.size(); ++length)
+                    if (stats.lengths[length] != 0)
+                        std::cout << ' ' << length << (length == stats.kTrackedLength ? "+" : "")
+                                  << '=' << stats.lengths[length];
+                std::cout << '\n' << std::defaultfloat;
+
+                if (stats.degraded())
+                    std::cout << red << "health:degraded, chains are much longer than a uniform hash gives" << '\n';
+                else
+                    std::cout << "health:ok" << '\n';
+                std::cout << reset << std::flush;
+            }
+        }
+
+    private:
+        std::size_t sample_;
+
+        // open addressing has no chains: report how far entries sit from their home slot
+        template <typename ProbeStats>
+        static void ShowProbeStats(const ProbeStats &stats) {
+            std::cout << green << "> # Hash table (open addressing)" << '\n' << std::fixed << std::setprecision(2);
+            std::cout << "slots:" << stats.slots << '\n';
+            std::cout << "sampled_slots:" << stats.sampled << '\n';
+            std::cout << "load_factor:" << stats.load_factor() << '\n';
+            std::cout << "max_distance:" << stats.max_distance << '\n';
+            std::cout << "mean_distance:" << stats.mean_distance() << '\n';
+            std::cout << "distance_variance:" << stats.distance_variance() << '\n';
+            std::cout << "probes_per_hit:" << stats.probes_per_hit() << '\n';
+
+            std::cout << "distances:";
+            for (std::size_t distance = 0; distance != stats.distances.size(); ++distance)
+                if (stats.distances[distance] != 0)
+                    std::cout << ' ' << distance << (distance == stats.kTrackedDistance ? "+" : "")
+                              << '=' << stats.distances[distance];
+            std::cout << '\n' << std::defaultfloat << reset << std::flush;
+        }
+    };
+    /*
+     * One parsed command over an engine chosen at compile time: the closed
+     * set of commands as a std::variant, built by CommandFactory by value.
+     * Run visits it, so Execute is resolved statically and the engine calls
+     * inside it can be inlined, with no heap allocation or indirect call
+     * per command line.
+     */
+    template <typename AssociativeContainer>
+    class Command {
+        static_assert(is_storage_engine_v<AssociativeContainer>, "commands need a storage engine, see engine_traits.h");
+
+    public:
+        using variant_type = std::variant<SetCommand<AssociativeContainer>,
+                                          GetCommand<AssociativeContainer>,
+                                          ExistsCommand<AssociativeContainer>,
+                                          DeleteCommand<AssociativeContainer>,
+                                          UpdateCommand<AssociativeContainer>,
+                                          KeysCommand<AssociativeContainer>,
+                                          RenameCommand<AssociativeContainer>,
+                                          TTLCommand<AssociativeContainer>,
+                                          FindCommand<AssociativeContainer>,
+                                          ShowAllCommand<AssociativeContainer>,
+                                          UploadCommand<AssociativeContainer>,
+                                          ExportCommand<AssociativeContainer>,
+                                          ColumnarCommand<AssociativeContainer>,
+                                          IndexCommand<AssociativeContainer>,
+                                          ScanCommand<AssociativeContainer>,
+                                          RangeCommand<AssociativeContainer>,
+                                          PrefixCommand<AssociativeContainer>,
+                                          RankCommand<AssociativeContainer>,
+                                          SelectCommand<AssociativeContainer>,
+                                          CountCommand<AssociativeContainer>,
+                                          CompactCommand<AssociativeContainer>,
+                                          InfoCommand<AssociativeContainer>,
+                                          ConfigCommand<AssociativeContainer>,
+                                          DebugHashStatsCommand<AssociativeContainer>>;
+
+        template <typename Alternative,
+                  typename = std::enable_if_t<std::is_constructible_v<variant_type, Alternative &&> and
+                                              !std::is_same_v<std::decay_t<Alternative>, Command>>>
+        Command(Alternative &&command) : command_(std::forward<Alternative>(command)) {}
+
+        void Bind(CommandContext<AssociativeContainer> *context, const std::string &name = {}) {
+            std::visit([&](auto &command) { command.Bind(context, name); }, command_);
+        }
+
+        void Run(AssociativeContainer &storage) {
+            std::visit([&storage](auto &command) { command.Measure([&] { command.Execute(storage); }); }, command_);
+        }
+
+    private:
+        variant_type command_;
+    };
 }
 
 #endif //TRANSACTIONS_LIBRARY_CPP_COMMAND_H
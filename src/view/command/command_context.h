@@ -0,0 +1,141 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_COMMAND_CONTEXT_H
+#define TRANSACTIONS_LIBRARY_CPP_COMMAND_CONTEXT_H
+
+#include <chrono>
+#include <optional>
+#include <type_traits>
+
+#include "command_stats.h"
+#include "engine_traits.h"
+#include "eviction.h"
+#include "key_versions.h"
+#include "memory_usage.h"
+#include "scan_executor.h"
+#include "student.h"
+#include "student_columns.h"
+#include "student_index.h"
+
+namespace ttl {
+    /*
+     * State that lives next to a storage for the whole interactive session.
+     * Commands report every write and erase here, so auxiliary structures
+     * stay in sync with the storage they describe.
+     */
+    template <typename AssociativeContainer>
+    class CommandContext {
+    public:
+        using key_type = typename AssociativeContainer::key_type;
+        using mapped_type = typename AssociativeContainer::mapped_type;
+
+        static constexpr bool kStudentStorage = std::is_same_v<mapped_type, Student>;
+
+        std::optional<student_columns<key_type>> columns;
+        student_indexes<key_type> indexes;
+        ScanExecutor executor;
+        CommandStats stats;
+
+        // write counters of the keys a Transaction watches
+        key_versions<key_type> versions;
+
+        // engaged while a maxmemory limit is set, so an unlimited storage pays nothing
+        std::optional<eviction_tracker<key_type>> eviction;
+        std::size_t maxmemory = 0;
+        eviction_policy policy = eviction_policy::kAllKeysLru;
+        std::size_t samples = eviction_tracker<key_type>::kDefaultSamples;
+        std::size_t evicted_keys = 0;
+
+    public:
+        void OnAssign(const key_type &key, const mapped_type &mapped) {
+            versions.touch(key);
+
+            if constexpr (kStudentStorage) {
+                if (columns)
+                    columns->assign(key, mapped);
+                indexes.assign(key, mapped);
+            }
+
+            if (eviction)
+                eviction->assign(key, heap_size(key) + heap_size(mapped), Deadline(mapped));
+        }
+
+        void OnErase(const key_type &key) {
+            versions.touch(key);
+
+            if constexpr (kStudentStorage) {
+                if (columns)
+                    columns->erase(key);
+                indexes.erase(key);
+            }
+
+            if (eviction)
+                eviction->erase(key);
+        }
+
+        void OnAccess(const key_type &key) {
+            if (eviction)
+                eviction->touch(key);
+        }
+
+    public:
+        // 0 turns the limit off; otherwise starts tracking every key already in the storage
+        void SetMaxMemory(AssociativeContainer &storage, std::size_t bytes) {
+            maxmemory = bytes;
+            if (maxmemory == 0) {
+                eviction.reset();
+                return;
+            }
+
+            if (!eviction) {
+                eviction.emplace(samples);
+                for (const auto &[key, mapped] : storage)
+                    eviction->assign(key, heap_size(key) + heap_size(mapped), Deadline(mapped));
+            }
+        }
+
+        [[nodiscard]] std::size_t UsedMemory(const AssociativeContainer &storage) const {
+            if (eviction)
+                return storage.memory(false).total() + eviction->heap_bytes();
+            return storage.memory().total();
+        }
+
+        /*
+         * Evicts keys until the storage fits under maxmemory. Called before a
+         * write, which passes the key it stores as `keep` so that key isn't
+         * evicted from under it; false means nothing could be evicted and the
+         * write should be refused.
+         */
+        bool Reclaim(AssociativeContainer &storage, const key_type *keep = nullptr) {
+            if (!eviction)
+                return true;
+
+            while (UsedMemory(storage) > maxmemory) {
+                std::optional<key_type> victim = eviction->victim(policy, keep);
+                if (!victim)
+                    return false;
+
+                // the tracker follows every write and erase; a key it still has but the storage doesn't is dropped
+                auto it = storage.find(*victim);
+                if (it == storage.end()) {
+                    eviction->erase(*victim);
+                    continue;
+                }
+
+                storage.erase(it);
+                OnErase(*victim);
+                ++evicted_keys;
+            }
+
+            return true;
+        }
+
+    private:
+        static std::optional<std::chrono::system_clock::time_point> Deadline(const mapped_type &mapped) {
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl)
+                if (mapped.time != -1)
+                    return mapped.life_begin + std::chrono::seconds(mapped.time);
+            return std::nullopt;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_COMMAND_CONTEXT_H
@@ -2,8 +2,9 @@
 #define TRANSACTIONS_LIBRARY_CPP_COMMAND_FACTORY_H
 
 #include <iostream>
+#include <limits>
 #include <sstream>
-#include <memory>
+#include <optional>
 #include <variant>
 
 #include "command.h"
@@ -11,15 +12,17 @@
 namespace ttl {
     class CommandFactory {
     public:
+        // the command on `line` by value, nullopt when the line isn't one
         template<typename AssociativeContainer>
-        static std::unique_ptr<ICommand<AssociativeContainer>> getCommand(const std::string &line, const AssociativeContainer &) {
+        static std::optional<Command<AssociativeContainer>> getCommand(const std::string &line, const AssociativeContainer &,
+                                                                      CommandContext<AssociativeContainer> *context = nullptr) {
             std::string command;
             std::stringstream ss(line);
 
             using key_type = typename AssociativeContainer::key_type;
             using mapped_type = typename AssociativeContainer::mapped_type;
 
-            std::unique_ptr<ICommand<AssociativeContainer>> find_command(nullptr);
+            std::optional<Command<AssociativeContainer>> find_command;
 
             ss >> command;
             if (command == "SET") {
@@ -27,56 +30,151 @@ namespace ttl {
                 mapped_type mapped;
                 try {
                     ss >> mapped;
-                    find_command = std::make_unique<SetCommand<AssociativeContainer>>(std::move(key), std::move(mapped));
+                    find_command = SetCommand<AssociativeContainer>(std::move(key), std::move(mapped));
                 } catch (std::exception &) {
-                    find_command = nullptr;
+                    find_command = std::nullopt;
                 }
             } else if (command == "GET") {
                 key_type key; ss >> key;
-                find_command = std::make_unique<GetCommand<AssociativeContainer>>(std::move(key));
+                find_command = GetCommand<AssociativeContainer>(std::move(key));
             } else if (command == "EXISTS") {
                 key_type key; ss >> key;
-                find_command = std::make_unique<ExistsCommand<AssociativeContainer>>(std::move(key));
+                find_command = ExistsCommand<AssociativeContainer>(std::move(key));
             } else if (command == "DEL") {
                 key_type key; ss >> key;
-                find_command = std::make_unique<DeleteCommand<AssociativeContainer>>(std::move(key));
+                find_command = DeleteCommand<AssociativeContainer>(std::move(key));
             } else if (command == "UPDATE") {
                 key_type key; ss >> key;
                 mapped_type mapped;
                 try {
                     ss >> mapped;
-                    find_command = std::make_unique<UpdateCommand<AssociativeContainer>>(std::move(key),
+                    find_command = UpdateCommand<AssociativeContainer>(std::move(key),
                                                                                          std::move(mapped));
                 } catch (std::exception &) {
-                    find_command = nullptr;
+                    find_command = std::nullopt;
                 }
             } else if (command == "KEYS") {
-                find_command = std::make_unique<KeysCommand<AssociativeContainer>>();
+                find_command = KeysCommand<AssociativeContainer>();
             } else if (command == "RENAME") {
                 key_type key1; ss >> key1;
                 key_type key2; ss >> key2;
-                find_command = std::make_unique<RenameCommand<AssociativeContainer>>(std::move(key1), std::move(key2));
+                find_command = RenameCommand<AssociativeContainer>(std::move(key1), std::move(key2));
             } else if (command == "TTL") {
                 key_type key; ss >> key;
-                find_command = std::make_unique<TTLCommand<AssociativeContainer>>(std::move(key));
+                find_command = TTLCommand<AssociativeContainer>(std::move(key));
             } else if (command == "FIND") {
                 mapped_type mapped;
                 try {
                     ss >> mapped;
-                    find_command = std::make_unique<FindCommand<AssociativeContainer>>(std::move(mapped));
+                    find_command = FindCommand<AssociativeContainer>(std::move(mapped));
                 } catch (std::exception &) {
-                    find_command = nullptr;
+                    find_command = std::nullopt;
                 }
             } else if (command == "SHOWALL") {
-                find_command = std::make_unique<ShowAllCommand<AssociativeContainer>>();
+                find_command = ShowAllCommand<AssociativeContainer>();
             } else if (command == "UPLOAD") {
                 std::string path; ss >> path;
-                find_command = std::make_unique<UploadCommand<AssociativeContainer>>(std::move(path));
+                find_command = UploadCommand<AssociativeContainer>(std::move(path));
             } else if (command == "EXPORT") {
                 std::string path; ss >> path;
-                find_command = std::make_unique<ExportCommand<AssociativeContainer>>(std::move(path));
+                find_command = ExportCommand<AssociativeContainer>(std::move(path));
+            } else if (command == "INFO") {
+                using Section = typename InfoCommand<AssociativeContainer>::Section;
+
+                std::string section, format; ss >> section >> format;
+                if (section == "MEMORY")
+                    find_command = InfoCommand<AssociativeContainer>(Section::kMemory);
+                else if (section == "STATS" and (format.empty() or format == "JSON"))
+                    find_command = InfoCommand<AssociativeContainer>(Section::kStats, !format.empty());
+            } else if (command == "CONFIG") {
+                std::string action, name, value;
+                ss >> action >> name;
+
+                if (action == "GET" and !name.empty())
+                    find_command = ConfigCommand<AssociativeContainer>(std::move(name), std::nullopt);
+                else if (action == "SET" and ss >> value)
+                    find_command = ConfigCommand<AssociativeContainer>(std::move(name), std::move(value));
+            } else if (command == "DEBUG") {
+                std::string subcommand, option;
+                std::size_t sample = 0;
+                ss >> subcommand;
+
+                bool valid = subcommand == "HTSTATS";
+                if (valid and ss >> option)
+                    valid = option == "SAMPLE" and ss >> sample and sample != 0;
+
+                if (valid)
+                    find_command = DebugHashStatsCommand<AssociativeContainer>(sample);
+            } else if (command == "COMPACT") {
+                find_command = CompactCommand<AssociativeContainer>();
+            } else if (command == "COLUMNAR") {
+                std::string mode; ss >> mode;
+                if (mode == "ON" or mode == "OFF")
+                    find_command = ColumnarCommand<AssociativeContainer>(mode == "ON");
+            } else if (command == "SCAN") {
+                std::string cursor, option, match;
+                std::size_t count = ScanCommand<AssociativeContainer>::kDefaultCount;
+
+                bool valid = static_cast<bool>(ss >> cursor);
+                while (valid and ss >> option) {
+                    if (option == "MATCH")
+                        valid = static_cast<bool>(ss >> match);
+                    else if (option == "COUNT")
+                        valid = ss >> count and count != 0;
+                    else
+                        valid = false;
+                }
+
+                if (valid)
+                    find_command = ScanCommand<AssociativeContainer>(std::move(cursor), std::move(match), count);
+            } else if (command == "RANGE") {
+                key_type from, to;
+                std::string option;
+                std::size_t limit = std::numeric_limits<std::size_t>::max();
+
+                bool valid = static_cast<bool>(ss >> from >> to);
+                if (valid and ss >> option)
+                    valid = option == "LIMIT" and ss >> limit;
+
+                if (valid)
+                    find_command = RangeCommand<AssociativeContainer>(std::move(from), std::move(to), limit);
+            } else if (command == "PREFIX") {
+                key_type prefix;
+                if (ss >> prefix)
+                    find_command = PrefixCommand<AssociativeContainer>(std::move(prefix));
+            } else if (command == "RANK") {
+                key_type key;
+                if (ss >> key)
+                    find_command = RankCommand<AssociativeContainer>(std::move(key));
+            } else if (command == "SELECT") {
+                std::size_t index;
+                if (ss >> index)
+                    find_command = SelectCommand<AssociativeContainer>(index);
+            } else if (command == "COUNT") {
+                key_type from, to;
+                if (ss >> from >> to)
+                    find_command = CountCommand<AssociativeContainer>(std::move(from), std::move(to));
+            } else if (command == "INDEX") {
+                using Action = typename IndexCommand<AssociativeContainer>::Action;
+
+                std::string action, field, argument1, argument2;
+                ss >> action >> field >> argument1 >> argument2;
+
+                std::optional<Action> parsed;
+                if (action == "CREATE") parsed = Action::kCreate;
+                else if (action == "DROP") parsed = Action::kDrop;
+                else if (action == "LIST") parsed = Action::kList;
+                else if (action == "RANGE") parsed = Action::kRange;
+
+                if (parsed)
+                    find_command = IndexCommand<AssociativeContainer>(*parsed, std::move(field),
+                                                                                        std::move(argument1),
+                                                                                        std::move(argument2));
             }
 
+            if (find_command)
+                find_command->Bind(context, command);
+
             return find_command;
         }
     };
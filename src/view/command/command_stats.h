@@ -0,0 +1,68 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_COMMAND_STATS_H
+#define TRANSACTIONS_LIBRARY_CPP_COMMAND_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "latency_histogram.h"
+
+namespace ttl {
+    /*
+     * Calls, latency and heap allocations per command name since the
+     * session started (or the last Reset). Kept in a std::map so INFO STATS
+     * lists commands sorted.
+     */
+    class CommandStats {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using histograms_type = std::map<std::string, latency_histogram>;
+
+    public:
+        void Record(const std::string &command, std::uint64_t nanoseconds, std::uint64_t allocations = 0) {
+            auto it = commands_.find(command);
+            if (it == commands_.end())
+                it = commands_.emplace(command, latency_histogram{}).first;
+
+            it->second.record(nanoseconds);
+            allocations_[command] += allocations;
+            ++total_;
+        }
+
+        void Reset() {
+            commands_.clear();
+            allocations_.clear();
+            total_ = 0;
+            started_ = clock_type::now();
+        }
+
+        [[nodiscard]] const histograms_type &Commands() const noexcept { return commands_; }
+        [[nodiscard]] std::uint64_t Total() const noexcept { return total_; }
+
+        // operator new calls per call of `command`; 0 unless allocation_counter is linked in
+        [[nodiscard]] double AllocationsPerCall(const std::string &command) const {
+            auto it = commands_.find(command);
+            if (it == commands_.end() or it->second.count() == 0)
+                return 0.0;
+            return static_cast<double>(allocations_.at(command)) / static_cast<double>(it->second.count());
+        }
+
+        [[nodiscard]] double Uptime() const {
+            return std::chrono::duration<double>(clock_type::now() - started_).count();
+        }
+
+        [[nodiscard]] double Throughput() const {
+            const double uptime = Uptime();
+            return uptime > 0.0 ? static_cast<double>(total_) / uptime : 0.0;
+        }
+
+    private:
+        histograms_type commands_;
+        std::map<std::string, std::uint64_t> allocations_;
+        std::uint64_t total_ = 0;
+        clock_type::time_point started_ = clock_type::now();
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_COMMAND_STATS_H
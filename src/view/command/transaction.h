@@ -0,0 +1,235 @@
+#ifndef TRANSACTIONS_LIBRARY_CPP_TRANSACTION_H
+#define TRANSACTIONS_LIBRARY_CPP_TRANSACTION_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command_factory.h"
+#include "termcolor.h"
+
+using namespace termcolor;
+
+namespace ttl {
+    /*
+     * MULTI/EXEC/DISCARD with optimistic WATCH for one session. Between
+     * MULTI and EXEC command lines are parsed and queued instead of run;
+     * EXEC runs the queue back to back, so no other command of the session
+     * lands between them, unless a key WATCHed before MULTI was written
+     * since (checked against the counters in CommandContext::versions), in
+     * which case nothing runs. Expiry counts as a write too: it is only
+     * noticed when someone reads the key, so EXEC also checks whether a
+     * watched key that was alive at WATCH has run out since. A line that
+     * doesn't parse while queuing makes EXEC refuse the whole queue.
+     *
+     * The replies of the queued commands are collected and written to the
+     * console at once after the last one, instead of one flush per reply.
+     * The MULTI and QUEUED acknowledgements aren't flushed either: reading
+     * the next line does that, std::cin being tied to std::cout.
+     */
+    template <typename AssociativeContainer>
+    class Transaction {
+    public:
+        using key_type = typename AssociativeContainer::key_type;
+        using version_type = typename key_versions<key_type>::version_type;
+
+        explicit Transaction(CommandContext<AssociativeContainer> &context)
+            : context_(context) {}
+
+        Transaction(const Transaction &) = delete;
+        Transaction &operator=(const Transaction &) = delete;
+
+        ~Transaction() { ReleaseWatched(); }
+
+        /*
+         * Takes `line` if it is MULTI, EXEC, DISCARD, WATCH or UNWATCH, or
+         * any line while MULTI is open; a blank one is skipped there, as it
+         * is outside. False means the line isn't the transaction's and the
+         * caller runs it as usual.
+         */
+        bool Accept(const std::string &line, AssociativeContainer &storage) {
+            // first word without a stringstream: most lines are only checked and passed on
+            const auto begin = std::min(line.find_first_not_of(' '), line.size());
+            const std::string word = line.substr(begin, line.find(' ', begin) - begin);
+
+            if (word == "MULTI") {
+                Multi();
+            } else if (word == "EXEC") {
+                Exec(storage);
+            } else if (word == "DISCARD") {
+                Discard();
+            } else if (word == "WATCH") {
+                std::stringstream keys(line.substr(begin + word.size()));
+                Watch(keys, storage);
+            } else if (word == "UNWATCH") {
+                Unwatch();
+            } else if (active_) {
+                if (!word.empty())
+                    Queue(line, storage);
+            } else {
+                return false;
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] bool Active() const noexcept { return active_; }
+        [[nodiscard]] std::size_t Queued() const noexcept { return queue_.size(); }
+
+    private:
+        struct watched_key {
+            key_type key;
+            version_type seen;
+            bool expired;       // already expired at WATCH, so running out can't change it
+        };
+
+        CommandContext<AssociativeContainer> &context_;
+        std::vector<Command<AssociativeContainer>> queue_;
+        std::vector<watched_key> watched_;
+        bool active_ = false;
+        bool failed_ = false;
+
+        void Multi() {
+            if (active_) {
+                std::cout << red << "> MULTI calls can not be nested" << reset << std::endl;
+                return;
+            }
+
+            active_ = true;
+            std::cout << green << "> OK" << reset << '\n';
+        }
+
+        void Queue(const std::string &line, AssociativeContainer &storage) {
+            auto command = CommandFactory::getCommand(line, storage, &context_);
+            if (!command) {
+                failed_ = true;
+                std::cout << red << "> unknown command, EXEC will discard the transaction" << reset << std::endl;
+                return;
+            }
+
+            queue_.push_back(std::move(*command));
+            std::cout << green << "> QUEUED" << reset << '\n';
+        }
+
+        void Exec(AssociativeContainer &storage) {
+            if (!active_) {
+                std::cout << red << "> EXEC without MULTI" << reset << std::endl;
+                return;
+            }
+
+            if (failed_) {
+                std::cout << red << "> EXECABORT transaction discarded because of previous errors" << reset << std::endl;
+            } else if (auto changed = ChangedKey(storage)) {
+                std::cout << red << "> (null) watched key '" << *changed << "' was modified" << reset << std::endl;
+            } else {
+                Run(storage);
+            }
+
+            Reset();
+            ReleaseWatched();
+        }
+
+        void Discard() {
+            if (!active_) {
+                std::cout << red << "> DISCARD without MULTI" << reset << std::endl;
+                return;
+            }
+
+            Reset();
+            ReleaseWatched();
+            std::cout << green << "> OK" << reset << std::endl;
+        }
+
+        void Watch(std::stringstream &ss, AssociativeContainer &storage) {
+            if (active_) {
+                std::cout << red << "> WATCH inside MULTI is not allowed" << reset << std::endl;
+                return;
+            }
+
+            key_type key;
+            bool any = false;
+            while (ss >> key) {
+                any = true;
+                bool watching = std::any_of(watched_.begin(), watched_.end(), [&](const auto &watched) {
+                    return watched.key == key;
+                });
+                if (!watching)
+                    watched_.push_back(watched_key{key, context_.versions.watch(key), Expired(storage, key)});
+            }
+
+            if (!any) {
+                std::cout << red << "> WATCH needs at least one key" << reset << std::endl;
+                return;
+            }
+            std::cout << green << "> OK" << reset << std::endl;
+        }
+
+        void Unwatch() {
+            if (active_) {
+                std::cout << red << "> UNWATCH inside MULTI is not allowed" << reset << std::endl;
+                return;
+            }
+
+            ReleaseWatched();
+            std::cout << green << "> OK" << reset << std::endl;
+        }
+
+        // EXEC and DISCARD let go of the watched keys too
+        void ReleaseWatched() {
+            for (const auto &watched : watched_)
+                context_.versions.unwatch(watched.key);
+            watched_.clear();
+        }
+
+        [[nodiscard]] const key_type *ChangedKey(AssociativeContainer &storage) const {
+            for (const auto &watched : watched_)
+                if (context_.versions.changed(watched.key, watched.seen) or
+                    (!watched.expired and Expired(storage, watched.key)))
+                    return &watched.key;
+            return nullptr;
+        }
+
+        // stored but past its TTL, by the rule of the TTL command
+        static bool Expired(AssociativeContainer &storage, const key_type &key) {
+            if constexpr (engine_traits<AssociativeContainer>::kSupportsTtl) {
+                auto it = storage.find(key);
+                if (it == storage.end() or it->second.time == -1)
+                    return false;
+
+                using namespace std::chrono;
+                return duration_cast<seconds>(system_clock::now() - it->second.life_begin).count() > it->second.time;
+            } else {
+                return false;
+            }
+        }
+
+        // the replies go to a buffer and reach the console in one write
+        void Run(AssociativeContainer &storage) {
+            std::ostringstream replies;
+            std::streambuf *console = std::cout.rdbuf(replies.rdbuf());
+
+            try {
+                for (auto &command : queue_)
+                    command.Run(storage);
+            } catch (...) {
+                std::cout.rdbuf(console);
+                throw;
+            }
+
+            std::cout.rdbuf(console);
+            std::cout << replies.str() << std::flush;
+        }
+
+        void Reset() {
+            queue_.clear();
+            active_ = false;
+            failed_ = false;
+        }
+    };
+}
+
+#endif //TRANSACTIONS_LIBRARY_CPP_TRANSACTION_H
@@ -1,11 +1,15 @@
 #include "view.h"
 
 #include "command_factory.h"
+#include "transaction.h"
 #include "student.h"
 
+#include "art_map.h"
 #include "map.h"
+#include "robin_hood_map.h"
 #include "unordered_map.h"
 #include "functions.h"
+#include "student_generator.h"
 
 #include <map>
 #include <unordered_map>
@@ -28,6 +32,14 @@ namespace ttl {
         std::cout << "> " << green << "UPDATE " << reset << "<key> - <name> - - <coins>\n\n";
 
         std::cout << "> " << green << "KEYS" << reset << '\n';
+        std::cout << "> " << green << "SCAN " << reset << "<cursor> [MATCH <pattern>] [COUNT <n>]" << '\n';
+        std::cout << "Start with cursor 0 and repeat with the returned cursor until it is 0 again" << '\n';
+        std::cout << "> " << green << "RANGE " << reset << "<from> <to> [LIMIT <n>]" << '\n';
+        std::cout << "> " << green << "PREFIX " << reset << "<prefix>" << '\n';
+        std::cout << "> " << green << "RANK " << reset << "<key>" << '\n';
+        std::cout << "> " << green << "SELECT " << reset << "<index>" << '\n';
+        std::cout << "> " << green << "COUNT " << reset << "<from> <to>" << '\n';
+        std::cout << "RANGE and PREFIX need an ordered storage (map or art_map), RANK, SELECT and COUNT the map" << "\n\n";
         std::cout << "> " << green << "RENAME " << reset << "<old_key> <new_key>" << '\n';
         std::cout << "> " << green << "TTL " << reset << "<key>\n\n";
 
@@ -39,35 +51,52 @@ namespace ttl {
         std::cout << "> " << green << "UPLOAD " << reset << "path/to/file.txt" << '\n';
         std::cout << "> " << green << "EXPORT " << reset << "path/to/file.txt\n\n";
 
-        std::cout << "> " << green << "EXIT" << reset << '\n';
-        std::cout << red   << "---------------------------------" << reset << "\n\n";
-    }
+        std::cout << "> " << green << "INFO " << reset << "MEMORY" << '\n';
+        std::cout << "Bytes held by the storage: table, nodes and heap owned by keys and values" << '\n';
+        std::cout << "> " << green << "INFO " << reset << "STATS [JSON]" << '\n';
+        std::cout << "Calls and p50/p99/p999 latency per command, storage probe and rehash counters\n\n";
 
-    void HashTableView::Show() {
-        DisplayCommands();
+        std::cout << "> " << green << "CONFIG SET " << reset << "maxmemory <bytes[kb|mb|gb]>" << '\n';
+        std::cout << "> " << green << "CONFIG SET " << reset << "maxmemory-policy allkeys-lru|allkeys-lfu|volatile-ttl|allkeys-random" << '\n';
+        std::cout << "> " << green << "CONFIG SET " << reset << "maxmemory-samples <n>" << '\n';
+        std::cout << "> " << green << "CONFIG GET " << reset << "<parameter>" << '\n';
+        std::cout << "Writes evict keys by the policy while the storage is over maxmemory; 0 means no limit\n\n";
 
-        std::string line;
-        ttl::unordered_map<std::string, Student> map;
+        std::cout << "> " << green << "DEBUG HTSTATS " << reset << "[SAMPLE <buckets>]" << '\n';
+        std::cout << "Chain length histogram, max chain and probes per hit/miss of the hash table;" << '\n';
+        std::cout << "probe distance histogram and variance of the robin_hood_map\n\n";
 
-        while (true) {
-            std::getline(std::cin, line, '\n');
+        std::cout << "> " << green << "COMPACT" << reset << '\n';
+        std::cout << "Rehashes the hash table into the smallest bucket (or slot) array that fits its keys\n\n";
 
-            if (line == "EXIT")
-                break;
+        std::cout << "> " << green << "COLUMNAR " << reset << "ON|OFF" << '\n';
+        std::cout << "Keeps a column-per-field copy of the records that FIND scans instead of the storage\n\n";
 
-            auto command = CommandFactory::getCommand(line, map);
-            if (command == nullptr)
-                continue;
+        std::cout << "> " << green << "INDEX CREATE " << reset << "<field> [HASH|ORDERED]" << '\n';
+        std::cout << "> " << green << "INDEX DROP " << reset << "<field>" << '\n';
+        std::cout << "> " << green << "INDEX RANGE " << reset << "<field> <from> <to>" << '\n';
+        std::cout << "> " << green << "INDEX LIST" << reset << '\n';
+        std::cout << "Fields: surname name year city coins. FIND uses the most selective index it can\n\n";
 
-            command->Execute(map);
-        }
+        std::cout << "> " << green << "MULTI" << reset << '\n';
+        std::cout << "Queues the following commands until " << green << "EXEC" << reset << " runs them all at once or "
+                  << green << "DISCARD" << reset << " drops them" << '\n';
+        std::cout << "> " << green << "WATCH " << reset << "<key> [<key> ...]" << '\n';
+        std::cout << "> " << green << "UNWATCH" << reset << '\n';
+        std::cout << "EXEC runs nothing if a key watched before MULTI was written since\n\n";
+
+        std::cout << "> " << green << "EXIT" << reset << '\n';
+        std::cout << red   << "---------------------------------" << reset << "\n\n";
     }
 
-    void RedBlackTreeView::Show() {
+    template <typename Storage>
+    void StorageView<Storage>::Show() {
         DisplayCommands();
 
         std::string line;
-        ttl::map<std::string, Student> map;
+        Storage map;
+        CommandContext<Storage> context;
+        Transaction<Storage> transaction(context);
 
         while (true) {
             std::getline(std::cin, line, '\n');
@@ -75,11 +104,14 @@ namespace ttl {
             if (line == "EXIT")
                 break;
 
-            auto command = CommandFactory::getCommand(line, map);
-            if (command == nullptr)
+            if (transaction.Accept(line, map))
+                continue;
+
+            auto command = CommandFactory::getCommand(line, map, &context);
+            if (!command)
                 continue;
 
-            command->Execute(map);
+            command->Run(map);
         }
     }
 
@@ -101,16 +133,24 @@ namespace ttl {
                 continue;
             }
 
-            double time_ttl_unordered = Functions::Execute(choice, tests_count, ttl::unordered_map<int, int>{});
-            double time_std_unordered = Functions::Execute(choice, tests_count, std::unordered_map<int, int>{});
-            double time_ttl_map = Functions::Execute(choice, tests_count, ttl::map<int, int>{});
-            double time_std_map = Functions::Execute(choice, tests_count, std::map<int, int>{});
+            ttl::unordered_map<int, int> ttl_unordered;
+            ttl::robin_hood_map<int, int> ttl_robin_hood;
+            std::unordered_map<int, int> std_unordered;
+            ttl::map<int, int> ttl_map;
+            std::map<int, int> std_map;
+
+            double time_ttl_unordered = Functions::Execute(choice, tests_count, ttl_unordered);
+            double time_ttl_robin_hood = Functions::Execute(choice, tests_count, ttl_robin_hood);
+            double time_std_unordered = Functions::Execute(choice, tests_count, std_unordered);
+            double time_ttl_map = Functions::Execute(choice, tests_count, ttl_map);
+            double time_std_map = Functions::Execute(choice, tests_count, std_map);
 
             std::cout << std::endl;
-            std::cout << red << "ttl::unordered_map (ms): " << reset << time_ttl_unordered << std::endl;
-            std::cout << red << "std::unordered_map (ms): " << reset << time_std_unordered << std::endl;
-            std::cout << red << "ttl::map (ms):           " << reset << time_ttl_map << std::endl;
-            std::cout << red << "std::map (ms):           " << reset << time_std_map << std::endl;
+            std::cout << red << "ttl::unordered_map (ms):  " << reset << time_ttl_unordered << std::endl;
+            std::cout << red << "ttl::robin_hood_map (ms): " << reset << time_ttl_robin_hood << std::endl;
+            std::cout << red << "std::unordered_map (ms):  " << reset << time_std_unordered << std::endl;
+            std::cout << red << "ttl::map (ms):            " << reset << time_ttl_map << std::endl;
+            std::cout << red << "std::map (ms):            " << reset << time_std_map << std::endl;
             std::cout << std::endl;
 
             std::cout << green << "Enter number from list\n> " << reset;
@@ -130,17 +170,18 @@ namespace ttl {
         std::cout << "6. " << green << "RENAME" << reset << " <compare_times_count>" << std::endl;
         std::cout << "7. " << green << "FIND" << reset << "   <compare_times_count>" << std::endl;
         std::cout << "0. " << green << "EXIT" << reset << std::endl;
+        std::cout << "Single runs only; " << green << "make benchmarks" << reset << " gives repeatable numbers" << std::endl;
         std::cout << red   << "---------------------------------" << reset << "\n\n";
     }
 
     void GeneratorKeyValueView::Show() {
         DisplayCommands();
 
-        std::string command, path;
+        std::string command, path, format;
         std::cout << "> ";
         std::cin >> command;
 
-        std::size_t count;
+        ScanExecutor executor;
         while (command != "EXIT") {
             if (command != "GENERATE") {
                 std::cout << "> ";
@@ -148,23 +189,38 @@ namespace ttl {
                 continue;
             }
 
+            student_generator_options options;
             std::cout << green << "Enter save file path\n" << reset << "> ";
             std::cin >> path;
-            std::cout << green << "Enter generation size\n" << reset << "> ";
-            std::cin >> count;
-
-            std::ofstream file(path);
-            if (file.is_open()) {
-                if (count > 100000) {
-                    std::cout << red << "Sorry, but your generation size is too big, we cut it to 100000\n" << reset;
-                }
-
-                for (std::size_t i = 0; i != count; ++i) {
-                    file << i + 1 << " Gubaydullin Nurislam 2002 Kazan 100" << '\n';
+            std::cout << green << "Enter generation size [1 - " << kMaxGenerationSize << "]\n" << reset << "> ";
+            std::cin >> options.count;
+            std::cout << green << "Enter key length\n" << reset << "> ";
+            std::cin >> options.key_length;
+            std::cout << green << "Enter share of keys with a life time [0 - 1]\n" << reset << "> ";
+            std::cin >> options.ttl_fraction;
+            std::cout << green << "Enter format [TEXT or SNAPSHOT]\n" << reset << "> ";
+            std::cin >> format;
+
+            if (!std::cin or options.count == 0 or options.count > kMaxGenerationSize) {
+                std::cout << red << "Generation size must be from 1 to " << kMaxGenerationSize << '\n' << reset;
+            } else if (options.ttl_fraction < 0.0 or options.ttl_fraction > 1.0) {
+                std::cout << red << "Share of keys with a life time must be from 0 to 1\n" << reset;
+            } else if (format != "TEXT" and format != "SNAPSHOT") {
+                std::cout << red << "Unknown format '" << format << "'\n" << reset;
+            } else {
+                std::ofstream file(path, std::ios::binary);
+                if (file.is_open()) {
+                    student_generator generator(options);
+                    if (format == "TEXT")
+                        generator.write_text(file, executor);
+                    else
+                        generator.write_snapshot(file, executor);
+
+                    file.close();
+                    std::cout << green << "File saved successfully!\n" << reset;
+                } else {
+                    std::cout << red << "Can't create or open the file by path '" << path << "'\n" << reset;
                 }
-
-                std::cout << green << "Filed saved successfully!\n" << reset;
-                file.close();
             }
 
             std::cout << "> ";
@@ -178,16 +234,28 @@ namespace ttl {
         std::cout << red   << "---------------------------------" << reset << '\n';
         std::cout << green << "Expected commands:" << reset << '\n';
         std::cout << "> " << green << "GENERATE" << reset << std::endl;
+        std::cout << "Asks for path, size, key length, share of keys with EX and format;" << '\n';
+        std::cout << "TEXT files load with UPLOAD line by line, SNAPSHOT files with UPLOAD in binary" << std::endl;
         std::cout << "> " << green << "EXIT" << reset << std::endl;
         std::cout << red   << "---------------------------------" << reset << "\n\n";
     }
 
+    namespace {
+        using HashTableView = StorageView<ttl::unordered_map<std::string, Student>>;
+        using RobinHoodTableView = StorageView<ttl::robin_hood_map<std::string, Student>>;
+        using RedBlackTreeView = StorageView<ttl::map<std::string, Student, std::less<std::string>,
+                                                      map_options::kOrderStatistics | map_options::kThreaded>>;
+        using RadixTreeView = StorageView<ttl::art_map<std::string, Student>>;
+    }
+
     std::unique_ptr<IView> IView::getView() {
         std::cout << green << "> " << reset << "Choose interactive version:" << '\n';
         std::cout << green << "> 1. " << reset << "unordered_map [key-value storage]" << '\n';
         std::cout << green << "> 2. " << reset << "map           [key-value storage]" << '\n';
         std::cout << green << "> 3. " << reset << "compare unordered_map & map" << '\n';
         std::cout << green << "> 4. " << reset << "generate key-value file" << '\n';
+        std::cout << green << "> 5. " << reset << "robin_hood_map [key-value storage, open addressing]" << '\n';
+        std::cout << green << "> 6. " << reset << "art_map        [key-value storage, radix tree]" << '\n';
         std::cout << red << "> " << reset;
 
         int choice;
@@ -205,6 +273,12 @@ namespace ttl {
         if (choice == 4)
             return std::make_unique<GeneratorKeyValueView>();
 
+        if (choice == 5)
+            return std::make_unique<RobinHoodTableView>();
+
+        if (choice == 6)
+            return std::make_unique<RadixTreeView>();
+
         return nullptr;
     }
 }
\ No newline at end of file
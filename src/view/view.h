@@ -1,6 +1,7 @@
 #ifndef TRANSACTIONS_LIBRARY_CPP_VIEW_H
 #define TRANSACTIONS_LIBRARY_CPP_VIEW_H
 
+#include <cstddef>
 #include <memory>
 #include <functional>
 
@@ -18,17 +19,15 @@ namespace ttl {
         virtual void DisplayCommands();
     };
 
-    class HashTableView final : public IView {
+    /*
+     * The command loop over one engine. The engine is a compile-time
+     * parameter, so commands are dispatched to it statically; getView
+     * picks the instantiation.
+     */
+    template <typename Storage>
+    class StorageView final : public IView {
     public:
-        ~HashTableView() override = default;
-
-    public:
-        void Show() override;
-    };
-
-    class RedBlackTreeView final : public IView {
-    public:
-        ~RedBlackTreeView() override = default;
+        ~StorageView() override = default;
 
     public:
         void Show() override;
@@ -47,6 +46,8 @@ namespace ttl {
 
     class GeneratorKeyValueView final : public IView {
     public:
+        static constexpr std::size_t kMaxGenerationSize = 100'000'000;
+
         ~GeneratorKeyValueView() override = default;
 
     public: